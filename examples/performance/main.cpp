@@ -22,6 +22,9 @@
 #include <sstream>
 
 #include "libhutznohmd/types.hpp"
+#include "request/memory_allocating_request.hpp"
+#include "request/mime_handler.hpp"
+#include "request/parsed_head_cache.hpp"
 #include "request/timestamp.hpp"
 #include "request/uri.hpp"
 
@@ -42,31 +45,24 @@ void test_date_parser(const std::string& date_string)
               << " ns for date string: " << date_string << std::endl;
 }
 
-void test_uri_parser(std::string uri)
+void test_uri_parser(const std::string& uri)
 {
+    // the uri is parsed in place and overwrites the whitespaces around it
+    const std::string request_line = " " + uri + " ";
+    std::string buffer = request_line;
+
     {
         // this initializes all static variables, that else would sophisticate
         // the results
         hutzn::uri u;
-        std::string tmp = uri;
-        size_t src_len = tmp.size();
-        std::string tmp2(src_len + 4, ' ');
-        size_t dest_len = tmp2.size();
-        hutzn::char_t* src = &(tmp[0]);
-        hutzn::char_t* dest = &(tmp2[0]);
-        u.parse(src, src_len, dest, dest_len, false);
+        u.parse(&(buffer[1]), uri.size(), false);
     }
 
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
     for (size_t i = 0; i < 1000000; i++) {
         hutzn::uri u;
-        std::string tmp = uri;
-        std::string tmp2(tmp.size() + 1, ' ');
-        size_t src_len = tmp.size();
-        size_t dest_len = tmp2.size();
-        hutzn::char_t* src = &(tmp[0]);
-        hutzn::char_t* dest = &(tmp2[0]);
-        u.parse(src, src_len, dest, dest_len, false);
+        buffer.replace(0, buffer.size(), request_line);
+        u.parse(&(buffer[1]), uri.size(), false);
     }
     std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
     auto diff =
@@ -75,6 +71,78 @@ void test_uri_parser(std::string uri)
               << " ns for uri: " << uri << std::endl;
 }
 
+//! Connection, which receives the same head again and again.
+class repeating_connection : public hutzn::connection
+{
+public:
+    explicit repeating_connection(const std::string& head)
+        : head_(head)
+    {
+    }
+
+    bool receive(hutzn::buffer& data, const size_t&) override
+    {
+        data.insert(data.end(), head_.begin(), head_.end());
+        return true;
+    }
+
+    bool send(const hutzn::buffer&) override
+    {
+        return true;
+    }
+
+    bool send(const std::string&) override
+    {
+        return true;
+    }
+
+    bool send(const std::vector<hutzn::buffer>&) override
+    {
+        return true;
+    }
+
+    void close(void) override
+    {
+    }
+
+    bool set_lingering_timeout(const int32_t&) override
+    {
+        return true;
+    }
+
+private:
+    const std::string head_;
+};
+
+void test_request_parser(const std::string& head, const bool use_cache)
+{
+    hutzn::mime_handler handler;
+    handler.register_mime_type("text");
+    handler.register_mime_subtype("plain");
+    hutzn::parsed_head_cache cache;
+
+    // the request is reused like on a keep-alive connection
+    hutzn::memory_allocating_request r{
+        std::make_shared<repeating_connection>(head), hutzn::header_limits(),
+        std::pmr::get_default_resource(), use_cache ? &cache : NULL};
+
+    // this initializes all static variables and the cache, that else would
+    // sophisticate the results
+    r.parse(handler);
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < 1000000; i++) {
+        r.reset();
+        r.parse(handler);
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    auto diff =
+        std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    std::cout << std::fixed << std::setprecision(3) << (diff.count() * 1000.0)
+              << " ns for request head " << (use_cache ? "with" : "without")
+              << " head cache" << std::endl;
+}
+
 int main(void)
 {
     std::cout << "example_performance" << std::endl;
@@ -88,6 +156,16 @@ int main(void)
     test_uri_parser("http://localhost:80/");
     test_uri_parser("http://user:pw@localhost:80/");
     test_uri_parser("http://user:pw@localhost:80/?a=b#anchor");
+    test_uri_parser("/static/images/2025/header-background.png?v=3");
+    test_uri_parser("/search?q=percent%20encoded%20query&page=2");
+    test_uri_parser("/files/percent%20encoded%20name.txt");
+
+    const std::string head =
+        "POST /api/items?page=2 HTTP/1.1\r\nHost: example.com\r\n"
+        "Content-Type: text/plain\r\nContent-Length: 0\r\n"
+        "User-Agent: probe/1.0\r\nX-Request-Id: 42\r\n\r\n";
+    test_request_parser(head, false);
+    test_request_parser(head, true);
 
     return 0;
 }
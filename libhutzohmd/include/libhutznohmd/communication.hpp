@@ -49,6 +49,7 @@ namespace hutzn {
     +receive(data: buffer, max_size: size): boolean
     +send(data: buffer): boolean
     +send(data: string): boolean
+    +send(data: buffer list): boolean
   }
 
   interface connection {
@@ -156,6 +157,17 @@ public:
 
     //! @copydoc connection::send(const buffer&)
     virtual bool send(const std::string& data) = 0;
+
+    //! @brief Invokes a blocking send operation of several buffers at once.
+    //!
+    //! The buffers are sent in their order like one concatenated buffer, but
+    //! without copying them. This is used to answer pipelined requests with
+    //! as few system calls as possible.
+    //! @param[in] data Buffers to send.
+    //! @return         Returns true when all data were successfully sent. In
+    //!                 case of a closed connection or a connection shut down
+    //!                 during the send it will return false.
+    virtual bool send(const std::vector<buffer>& data) = 0;
 };
 
 //! @brief Connects to endpoints to receive and send data.
@@ -202,9 +202,11 @@ to the requesting client.
 struct request_handler_id {
     //! This string contains only the path of the URL (e.g. "/index.html"). This
     //! path must begin with a slash and must not contain two or more
-    //! consecutive slashes. The valid character is described with the token
-    //! "pchar" in RFC 3986 chapter 3.3. Scheme, authorization, host, port,
-    //! queries and fragments are not allowed in this path.
+    //! consecutive slashes or "." and ".." segments, because the paths of
+    //! requests are normalized before they are compared. The valid character
+    //! is described with the token "pchar" in RFC 3986 chapter 3.3. Scheme,
+    //! authorization, host, port, queries and fragments are not allowed in
+    //! this path.
     std::string path;
 
     //! Only GET, PUT, DELETE and POST are allowed verbs here. All other verbs
@@ -22,6 +22,9 @@
 #include <libhutznohmd/communication.hpp>
 #include <libhutznohmd/types.hpp>
 
+#include <functional>
+#include <string_view>
+
 namespace hutzn
 {
 
@@ -106,6 +109,7 @@ namespace hutzn {
     UNSUPPORTED_MEDIA_TYPE
     EXPECTATION_FAILED
     UPGRADE_REQUIRED
+    REQUEST_HEADER_FIELDS_TOO_LARGE
     INTERNAL_SERVER_ERROR
     NOT_IMPLEMENTED
     BAD_GATEWAY
@@ -126,6 +130,10 @@ namespace hutzn {
     +keeps_connection(): bool
     +date(): time
     +content(): buffer
+    +read_some(in/out data: buffer, max_size: size): bool
+    +stream_content(sink: content_sink): bool
+    +header_value(name: string): string
+    +registered_header_value(id: custom_header_id): string
     +content_length(): size
     +content_type(): mime
     +accept(in/out handle: pointer, type: mime): bool
@@ -218,6 +226,29 @@ not present
 
 since 0.9.0
 
+@subsection sub_content_digest Content-Digest
+
+This header field is optional and carries checksums or hash sums of the
+content as defined by [RFC9530|https://www.rfc-editor.org/rfc/rfc9530]. The
+algorithms crc32c and sha-256 are used to check the content for transmission
+errors, any other algorithm is ignored. The sums are calculated while the
+content is received, when it is streamed. To enable this header field on the
+response, call @ref response::set_content_digest after setting the content.
+
+@subsubsection subsub_content_digest_example Example:
+
+@code
+Content-Digest: crc32c=:4waSgw==:
+@endcode
+
+@subsubsection subsub_content_digest_default Default:
+
+not present
+
+@subsubsection subsub_content_digest_implemented Implementation Status:
+
+since 0.9.0
+
 @subsection sub_content_type Content-Type
 
 A content type header defines how the application should interpret the content.
@@ -407,6 +438,34 @@ not present
 
 since 0.9.0
 
+@subsection sub_transfer_encoding Transfer-Encoding
+
+Announces, that the content of a request is sent in chunks. This enables clients
+to send a content, whose length is not known in advance. The only supported
+transfer coding is @c chunked. Chunk extensions and trailer fields are ignored,
+but are limited like the header. A request, whose last transfer coding is not
+@c chunked, is rejected with 400 (Bad Request), while a request with any other
+coding is rejected with 501 (Not Implemented). The decoded content is limited
+to \f$2^{31}-1\f$ bytes like a content with @c Content-Length and a request
+with a larger content is rejected. The header field @c Content-Length is
+ignored, when this header field is present, and the connection is closed after
+such a request. The length of the decoded content could be retrieved by @ref
+request::content_length after the content was fetched.
+
+@subsubsection subsub_transfer_encoding_example Example:
+
+@code
+Transfer-Encoding: chunked
+@endcode
+
+@subsubsection subsub_transfer_encoding_default Default:
+
+not present
+
+@subsubsection subsub_transfer_encoding_implemented Implementation Status:
+
+since 0.9.0
+
 @subsection sub_user_agent User-Agent
 
 Contains information about the requesting client product.
@@ -735,6 +794,10 @@ enum class http_status_code : uint16_t {
     //! The client should switch to a different protocol.
     UPGRADE_REQUIRED = 426,
 
+    //! The request cannot be processed, due to the size or number of its
+    //! header fields.
+    REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
+
     //! A standard response code indicating a server error, where no other
     //! message is suitable.
     INTERNAL_SERVER_ERROR = 500,
@@ -768,12 +831,45 @@ enum class http_expectation : uint8_t {
     CONTINUE = 1
 };
 
+//! Algorithms of the Content-Digest header field, which are supported.
+enum class digest_algorithm : uint8_t {
+    //! CRC32C checksum. It detects transmission errors at almost no cost.
+    CRC32C = 0,
+
+    //! SHA-256 hash sum.
+    SHA_256 = 1
+};
+
+//! Receives the content of a request in parts. Returns false to stop receiving
+//! any further part.
+using content_sink =
+    std::function<bool(const char_t* const data, const size_t size)>;
+
+//! Identifies a custom header field name, that was registered before parsing
+//! any request. It allows to retrieve the header field value without
+//! comparing any string.
+using custom_header_id = uint8_t;
+
+//! Is returned, when a custom header field name could not be registered.
+static const custom_header_id invalid_custom_header_id = 0xFF;
+
+//! Registers a custom header field name for all requests parsed afterwards and
+//! returns its identifier. Header field names are compared case-insensitively
+//! and registering the same name twice returns the same identifier. At most 32
+//! names could be registered. Returns @ref invalid_custom_header_id, when no
+//! further name could be registered or the name is empty. Register the names
+//! at startup, because requests, which are already parsed, are not updated.
+custom_header_id register_custom_header(const char_t* const name);
+
 //! Is used by the request processor to find the right request handler and to
 //! serve as abstraction of the request to its users (request handlers). Note,
 //! that the lifetime of the strings retrieved by interface's methods are bound
 //! to the lifetime of the request object itself. This means, that after
 //! releasing the request object, all such strings are getting invalid! Ideally
-//! these pointers are not getting stored inside of other objects.
+//! these pointers are not getting stored inside of other objects. Each string
+//! accessor has a counterpart returning a std::string_view, which avoids
+//! determining the length of the string again. A string, which is not present,
+//! is returned as an empty view with NULL data.
 class request
 {
 public:
@@ -782,11 +878,32 @@ public:
 
     //! Fetches the content, which is not already fetched by the request
     //! processor. Call it at least one time before calling @ref
-    //! request::content.
+    //! request::content. A content with chunked transfer-encoding is decoded
+    //! while it is received.
     //! @return Returns false, when an optional md5 fails to suuceed content
-    //!         validation and true in any other case.
+    //!         validation, when the content could not be received completely
+    //!         or was read in parts before or when a chunked content is
+    //!         malformed or too large and true in any other case.
     virtual bool fetch_content(void) = 0;
 
+    //! Reads the next part of the content instead of fetching it as a whole.
+    //! This keeps the memory bounded for large contents. Appends at most
+    //! max_size bytes to the data. The content could not be fetched anymore,
+    //! after reading a part of it. Content-MD5 is not verified in this case,
+    //! but see @ref request::stream_content.
+    //! @return Returns true, when at least one byte was appended and false,
+    //!         when the content was read completely or could not be read.
+    virtual bool read_some(buffer& data, const size_t max_size) = 0;
+
+    //! Passes the content part by part to the sink as it is received. The
+    //! same restrictions as for @ref request::read_some apply. An optional
+    //! Content-MD5 is calculated while the parts are received and verified
+    //! after the last part was passed to the sink.
+    //! @return Returns true, when the whole content was passed to the sink and
+    //!         false, when the content could not be read, the sink returned
+    //!         false or the md5 sum does not match.
+    virtual bool stream_content(const content_sink& sink) = 0;
+
     //! Returns the HTTP verb used by the request (GET, PUT, DELETE or POST are
     //! allowed).
     virtual http_verb method(void) const = 0;
@@ -795,18 +912,34 @@ public:
     //! fragment.
     virtual const char_t* path(void) const = 0;
 
+    //! Returns the same as @ref request::path together with its length.
+    virtual std::string_view path_view(void) const = 0;
+
     //! The host name used by the request client. It could be part of the
     //! request line or the header field Host. If a host is present at both
     //! places, the header field Host overwrites that one in the request line.
     //! This is currently just an information.
     virtual const char_t* host(void) const = 0;
 
-    //! Returns a value of a key, that is in the query part of the URL.
+    //! Returns the same as @ref request::host together with its length.
+    virtual std::string_view host_view(void) const = 0;
+
+    //! Returns a value of a key, that is in the query part of the URL. Keys and
+    //! values are percent-decoded and a plus sign is decoded as space. A key
+    //! without a value has an empty value. Returns NULL, when the key is not
+    //! present. Only as many entries are read as could fit into the longest
+    //! request line, even when the query is part of the header field Host.
     virtual const char_t* query(const char_t* const key) const = 0;
 
+    //! Returns the same as @ref request::query together with its length.
+    virtual std::string_view query_view(const char_t* const key) const = 0;
+
     //! Returns the fragment of the URL.
     virtual const char_t* fragment(void) const = 0;
 
+    //! Returns the same as @ref request::fragment together with its length.
+    virtual std::string_view fragment_view(void) const = 0;
+
     //! Returns the used HTTP version. This influences server behaviour
     //! (e.g. connection duration).
     virtual http_version version(void) const = 0;
@@ -814,9 +947,21 @@ public:
     //! Returns the content of any custom header field. Only those, which are
     //! available by explicit member functions are available. If the header
     //! field is not present, it returns an empty string. Will never return
-    //! a null-pointer.
+    //! a null-pointer. The name is compared case-insensitively.
     virtual const char_t* header_value(const char_t* const name) const = 0;
 
+    //! Returns the same as @ref request::header_value together with its
+    //! length.
+    virtual std::string_view header_value_view(
+        const char_t* const name) const = 0;
+
+    //! Returns the content of a custom header field, whose name was registered
+    //! by @ref register_custom_header. This is faster than @ref
+    //! request::header_value, because no string is compared. Returns NULL,
+    //! when the header field is not present or the identifier is invalid.
+    virtual const char_t* registered_header_value(
+        const custom_header_id id) const = 0;
+
     //! Returns true, if the connection will be kept after the request is
     //! processed.
     virtual bool keeps_connection(void) const = 0;
@@ -866,13 +1011,22 @@ public:
     //! Returns the content of the from field.
     virtual const char_t* from(void) const = 0;
 
+    //! Returns the same as @ref request::from together with its length.
+    virtual std::string_view from_view(void) const = 0;
+
     //! Returns the content of the referer field.
     virtual const char_t* referer(void) const = 0;
 
+    //! Returns the same as @ref request::referer together with its length.
+    virtual std::string_view referer_view(void) const = 0;
+
     //! Returns the content of the user agent field. Usually this is used to
     //! work around some idiosyncrasies of some specific clients to improve the
     //! result of the web service.
     virtual const char_t* user_agent(void) const = 0;
+
+    //! Returns the same as @ref request::user_agent together with its length.
+    virtual std::string_view user_agent_view(void) const = 0;
 };
 
 //! The request handler uses this interface to assemble the response.
@@ -895,6 +1049,11 @@ public:
     //! is generated or not.
     virtual void set_content(const buffer& content, const bool set_md5) = 0;
 
+    //! Sets or overwrites the Content-Digest header field. It is calculated
+    //! over the content, which was set before, by the given algorithm. Setting
+    //! another content clears the header field.
+    virtual void set_content_digest(const digest_algorithm algorithm) = 0;
+
     //! Sets or overwrites the Content-Location header field.
     virtual void set_content_location(const char_t* const content_location) = 0;
 
@@ -190,4 +190,36 @@ TEST(internet_socket, normal_use_case)
     EXPECT_TRUE(listnr->listening());
 }
 
+TEST(internet_socket, vectored_send)
+{
+    listener_ptr listnr = listen("127.0.0.1", 10000);
+    EXPECT_TRUE(listnr->set_lingering_timeout(0));
+    EXPECT_TRUE(listnr->listening());
+
+    std::thread thread([] {
+        auto conn = internet_socket_connection::create("127.0.0.1", 10000);
+        EXPECT_TRUE(conn->connect());
+        EXPECT_TRUE(conn->set_lingering_timeout(0));
+        buffer data;
+        while ((data.size() < 6) && conn->receive(data, 8)) {
+        }
+        EXPECT_EQ(buffer({0, 1, 2, 3, 4, 5}), data);
+    });
+
+    connection_ptr connection = listnr->accept();
+    EXPECT_NE(connection_ptr(), connection);
+    EXPECT_TRUE(connection->set_lingering_timeout(0));
+    const std::vector<buffer> data = {{0, 1}, {}, {2, 3, 4}, {5}};
+    EXPECT_TRUE(connection->send(data));
+
+    thread.join();
+    EXPECT_TRUE(listnr->listening());
+}
+
+TEST(internet_socket, unconnected_vectored_send)
+{
+    auto conn = internet_socket_connection::create("127.0.0.1", 10000);
+    EXPECT_FALSE(conn->send(std::vector<buffer>{{0}}));
+}
+
 } // namespace hutzn
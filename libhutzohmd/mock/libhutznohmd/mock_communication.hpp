@@ -34,6 +34,7 @@ public:
     MOCK_METHOD2(receive, bool(buffer&, const size_t&));
     MOCK_METHOD1(send, bool(const buffer&));
     MOCK_METHOD1(send, bool(const std::string&));
+    MOCK_METHOD1(send, bool(const std::vector<buffer>&));
     MOCK_METHOD1(set_lingering_timeout, bool(const int32_t&));
 };
 
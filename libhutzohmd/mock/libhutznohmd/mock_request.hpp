@@ -30,13 +30,23 @@ class request_mock : public request
 {
 public:
     MOCK_METHOD0(fetch_content, bool(void));
+    MOCK_METHOD2(read_some, bool(buffer&, const size_t));
+    MOCK_METHOD1(stream_content, bool(const content_sink&));
     MOCK_CONST_METHOD0(method, http_verb(void));
     MOCK_CONST_METHOD0(path, const char_t*(void));
+    MOCK_CONST_METHOD0(path_view, std::string_view(void));
     MOCK_CONST_METHOD0(host, const char_t*(void));
+    MOCK_CONST_METHOD0(host_view, std::string_view(void));
     MOCK_CONST_METHOD1(query, const char_t*(const char_t* const));
+    MOCK_CONST_METHOD1(query_view, std::string_view(const char_t* const));
     MOCK_CONST_METHOD0(fragment, const char_t*(void));
+    MOCK_CONST_METHOD0(fragment_view, std::string_view(void));
     MOCK_CONST_METHOD0(version, http_version(void));
     MOCK_CONST_METHOD1(header_value, const char_t*(const char_t* const));
+    MOCK_CONST_METHOD1(header_value_view,
+                       std::string_view(const char_t* const));
+    MOCK_CONST_METHOD1(registered_header_value,
+                       const char_t*(const custom_header_id));
     MOCK_CONST_METHOD0(keeps_connection, bool(void));
     MOCK_CONST_METHOD0(date, time_t(void));
     MOCK_CONST_METHOD0(content, const void*(void));
@@ -45,8 +55,11 @@ public:
     MOCK_CONST_METHOD2(accept, bool(void*&, mime&));
     MOCK_CONST_METHOD0(expect, http_expectation(void));
     MOCK_CONST_METHOD0(from, const char_t*(void));
+    MOCK_CONST_METHOD0(from_view, std::string_view(void));
     MOCK_CONST_METHOD0(referer, const char_t*(void));
+    MOCK_CONST_METHOD0(referer_view, std::string_view(void));
     MOCK_CONST_METHOD0(user_agent, const char_t*(void));
+    MOCK_CONST_METHOD0(user_agent_view, std::string_view(void));
 };
 
 using request_mock_ptr = std::shared_ptr<request_mock>;
@@ -56,6 +69,7 @@ class response_mock : public response
 public:
     MOCK_METHOD2(set_header, bool(const char_t* const, const char_t* const));
     MOCK_METHOD2(set_content, void(const buffer&, const bool));
+    MOCK_METHOD1(set_content_digest, void(const digest_algorithm));
     MOCK_METHOD1(set_content_location, void(const char_t* const));
     MOCK_METHOD1(set_location, void(const char_t* const));
     MOCK_METHOD1(set_retry_after, bool(const time_t));
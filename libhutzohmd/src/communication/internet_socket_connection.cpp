@@ -18,8 +18,11 @@
 
 #include "internet_socket_connection.hpp"
 
+#include <sys/uio.h>
+
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <limits>
 #include <string>
 
@@ -109,6 +112,57 @@ bool internet_socket_connection::send(const std::string& data)
     return send(data.data(), data.size());
 }
 
+bool internet_socket_connection::send(const std::vector<buffer>& data)
+{
+    bool result = false;
+    // send will only succeed when the socket is connected
+    if (is_connected_) {
+        // the io vector refers to the non-empty buffers and gets advanced while
+        // sending, because sendmsg may send them only partially
+        std::vector<iovec> io_vector;
+        io_vector.reserve(data.size());
+        for (const buffer& b : data) {
+            if (!b.empty()) {
+                io_vector.push_back(
+                    iovec{const_cast<char_t*>(b.data()), b.size()});
+            }
+        }
+
+        static const size_t max_io_vector_size = IOV_MAX;
+        result = true;
+        size_t index = 0;
+        while (index < io_vector.size()) {
+            msghdr message{};
+            message.msg_iov = &(io_vector[index]);
+            message.msg_iovlen =
+                std::min(io_vector.size() - index, max_io_vector_size);
+            const ssize_t sent_size =
+                send_message_signal_safe(socket_, &message, 0);
+            if (sent_size <= 0) {
+                result = false;
+                break;
+            }
+
+            // skip all completely sent buffers
+            size_t remaining = static_cast<size_t>(sent_size);
+            while ((index < io_vector.size()) &&
+                   (remaining >= io_vector[index].iov_len)) {
+                remaining -= io_vector[index].iov_len;
+                index++;
+            }
+
+            // the first buffer, that was not completely sent, gets shortened
+            if (remaining > 0) {
+                assert(index < io_vector.size());
+                iovec& v = io_vector[index];
+                v.iov_base = static_cast<char_t*>(v.iov_base) + remaining;
+                v.iov_len -= remaining;
+            }
+        }
+    }
+    return result;
+}
+
 bool internet_socket_connection::send(const char_t* data, const size_t& size)
 {
     bool result = false;
@@ -76,6 +76,9 @@ public:
     //! @copydoc block_device::send()
     bool send(const std::string& data) override;
 
+    //! @copydoc block_device::send()
+    bool send(const std::vector<buffer>& data) override;
+
     //! @copydoc connection::set_lingering_timeout()
     bool set_lingering_timeout(const int32_t& timeout) override;
 
@@ -98,6 +98,20 @@ ssize_t send_signal_safe(const int32_t file_descriptor,
     return sent;
 }
 
+ssize_t send_message_signal_safe(const int32_t file_descriptor,
+                                 const msghdr* const message,
+                                 const int32_t flags) noexcept(true)
+{
+    // loop until this sendmsg command is not interrupted by a signal
+    ssize_t sent;
+    do {
+        sent = sendmsg(file_descriptor, message, flags);
+    } while ((sent == -1) && (errno == EINTR));
+
+    // return the result which must not be an interruption
+    return sent;
+}
+
 ssize_t receive_signal_safe(const int32_t file_descriptor, void* const buffer,
                             const size_t size,
                             const int32_t flags) noexcept(true)
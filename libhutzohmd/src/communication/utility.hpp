@@ -20,6 +20,7 @@
 #define LIBHUTZNOHMD_COMMUNICATION_UTILITY_HPP
 
 #include <arpa/inet.h>
+#include <sys/socket.h>
 
 #include <string>
 
@@ -73,6 +74,19 @@ ssize_t send_signal_safe(const int32_t file_descriptor,
                          const void* const buffer, const size_t size,
                          const int32_t flags) noexcept(true);
 
+//! @brief Calls the API function sendmsg and handles interfering signals.
+//!
+//! It returns the number of sent bytes of all buffers described by the message.
+//! When the socket is getting closed while sending data or on any other error,
+//! it will return -1. In this case @c errno is set.
+//! @param[in] file_descriptor File to send data to.
+//! @param[in] message         Message, that describes the buffers to send.
+//! @param[in] flags           Flags configuring the send operation.
+//! @return Number of sent bytes or -1 on error.
+ssize_t send_message_signal_safe(const int32_t file_descriptor,
+                                 const msghdr* const message,
+                                 const int32_t flags) noexcept(true);
+
 //! @brief Calls the API function recv and handles interfering signals.
 //!
 //! It returns the number of received bytes. When the socket is getting closed
@@ -20,6 +20,10 @@
 
 #include <array>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 #include "utility/common.hpp"
 
 namespace hutzn
@@ -33,28 +37,51 @@ static const size_t sextets_per_evaluation_chunk = 4;
 static const size_t sextets_size = 6;
 static const size_t hexade_bitmask = 0x3FU;
 
-//! @brief Returns the encoder map of the base64 implementation.
-//!
-//! @return A reference to the encoder map of base64.
-const std::string& get_base64_encoder_map()
-{
-    static const std::string base64_encoder_map =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
-    return base64_encoder_map;
-}
+static const size_t second_hexade = sextets_size;
+static const size_t third_hexade = second_hexade + sextets_size;
+static const size_t fourth_hexade = third_hexade + sextets_size;
+
+static const size_t second_byte_offset = bits_per_byte;
+static const size_t third_byte_offset = second_byte_offset + bits_per_byte;
+static const size_t byte_bitmask = 0xFFU;
+
+//! Encoder map of the base64 implementation.
+static const char_t base64_encoder_map[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789+/";
+
+//! Decoder map of the base64 implementation, which accepts both alphabets.
+static const std::array<int8_t, 1 << bits_per_byte> base64_decoder_map = {
+    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, 62, -1, 62, -1, 63, 52, 53, 54, 55, 56, 57,
+     58, 59, 60, 61, -1, -1, -1, -1, -1, -1, -1, 0,  1,  2,  3,  4,  5,  6,
+     7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+     25, -1, -1, -1, -1, 63, -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
+     37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1}};
 
 //! @brief Completes a base64 string.
 //!
 //! Whenever the number of bytes is not divisible by 3, the remaining bytes get
 //! filled with padding.
-//! @param[out] result           Bytes get appended to that string.
+//! @param[out] destination      Characters get written to that buffer.
 //! @param[in]  bytes_in_backlog Bytes stored in a bit backlog.
 //! @param[in]  bit_backlog      Backlog of read bits to get converted.
-void append_base64_last_bytes(std::string& result, uint8_t bytes_in_backlog,
-                              uint32_t bit_backlog)
+//! @return                      Number of written characters.
+size_t write_base64_last_bytes(char_t* destination, uint8_t bytes_in_backlog,
+                               uint32_t bit_backlog)
 {
+    char_t* const begin = destination;
+
     // finish string only when there is data to convert
     if (bytes_in_backlog != 0) {
 
@@ -67,100 +94,299 @@ void append_base64_last_bytes(std::string& result, uint8_t bytes_in_backlog,
             bytes_in_backlog++;
         }
 
-        static const size_t second_hexade = sextets_size;
-        static const size_t third_hexade = second_hexade + sextets_size;
-        static const size_t fourth_hexade = third_hexade + sextets_size;
-
-        // append all original hexades
-        result.push_back(
-            get_base64_encoder_map()[(bit_backlog >> fourth_hexade) &
-                                     hexade_bitmask]);
-        result.push_back(
-            get_base64_encoder_map()[(bit_backlog >> third_hexade) &
-                                     hexade_bitmask]);
+        // write all original hexades
+        *(destination++) =
+            base64_encoder_map[(bit_backlog >> fourth_hexade) & hexade_bitmask];
+        *(destination++) =
+            base64_encoder_map[(bit_backlog >> third_hexade) & hexade_bitmask];
         if ((evaluation_chunk_size - 1) == original_bytes_in_backlog) {
-            result.push_back(
-                get_base64_encoder_map()[(bit_backlog >> second_hexade) &
-                                         hexade_bitmask]);
+            *(destination++) =
+                base64_encoder_map[(bit_backlog >> second_hexade) &
+                                   hexade_bitmask];
         } else {
             // when there was no hexade, fill with padding
-            result.push_back('=');
+            *(destination++) = '=';
         }
 
         // at least one byte was empty, so fill at least one padding byte
-        result.push_back('=');
+        *(destination++) = '=';
     }
+
+    return static_cast<size_t>(destination - begin);
+}
+
+//! @brief Signature of the functions, which encode the bulk of the data.
+//!
+//! They return the number of encoded bytes, which is a multiple of 3. Each 3
+//! bytes are encoded into 4 characters.
+using encode_function = size_t (*)(const uint8_t*, size_t, char_t*);
+
+//! @brief Signature of the functions, which decode the bulk of a string.
+//!
+//! They return the number of decoded characters, which is a multiple of 4.
+//! Each 4 characters are decoded into 3 bytes. They stop at the first part of
+//! the string, which contains a character outside of the alphabets.
+using decode_function = size_t (*)(const char_t*, size_t, uint8_t*);
+
+//! @brief Leaves the bulk of the data to the scalar loops.
+//!
+//! @return Always 0.
+size_t encode_nothing(const uint8_t*, size_t, char_t*)
+{
+    return 0;
+}
+
+//! @brief Leaves the bulk of the string to the scalar loops.
+//!
+//! @return Always 0.
+size_t decode_nothing(const char_t*, size_t, uint8_t*)
+{
+    return 0;
+}
+
+#if defined(__x86_64__)
+
+//! Number of bytes in a vector register.
+static const size_t vector_size = sizeof(__m128i);
+
+//! Number of bytes, which are encoded into one vector of characters.
+static const size_t vector_bytes =
+    (vector_size / sextets_per_evaluation_chunk) * evaluation_chunk_size;
+
+//! @brief Encodes 12 bytes per step with SSSE3 instructions.
+//!
+//! The bytes are spread to 32 bit lanes and split into sextets by
+//! multiplications. The sextets are mapped to characters by adding an offset,
+//! which is looked up per range of the alphabet.
+//! @param[in]  data        Bytes to encode.
+//! @param[in]  size        Number of bytes.
+//! @param[out] destination Encoded characters.
+//! @return                 Number of encoded bytes.
+__attribute__((target("ssse3"))) size_t encode_vectors(const uint8_t* data,
+                                                       size_t size,
+                                                       char_t* destination)
+{
+    const __m128i spread =
+        _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m128i offsets =
+        _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                      '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    // a whole vector is loaded, therefore 4 bytes beyond the encoded bytes
+    // have to be readable
+    size_t result = 0;
+    while ((size - result) >= vector_size) {
+        __m128i in = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data + result));
+        in = _mm_shuffle_epi8(in, spread);
+
+        // sextets a and c of each lane
+        const __m128i ac = _mm_mulhi_epu16(
+            _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+            _mm_set1_epi32(0x04000040));
+        // sextets b and d of each lane
+        const __m128i bd =
+            _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+                            _mm_set1_epi32(0x01000010));
+        const __m128i sextets = _mm_or_si128(ac, bd);
+
+        // 0..25 select 13, 26..51 select 0 and 52..63 select 1..12
+        __m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+        const __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+        range = _mm_or_si128(range, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+        const __m128i characters =
+            _mm_add_epi8(sextets, _mm_shuffle_epi8(offsets, range));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), characters);
+        destination += vector_size;
+        result += vector_bytes;
+    }
+    return result;
+}
+
+//! @brief Returns a mask of the characters within a range.
+//!
+//! @param[in] characters Characters to check.
+//! @param[in] first      First character of the range.
+//! @param[in] last       Last character of the range.
+//! @return               All bits are set for characters within the range.
+__attribute__((target("ssse3"))) inline __m128i in_range(
+    const __m128i characters, const char_t first, const char_t last)
+{
+    const __m128i below = _mm_set1_epi8(static_cast<char_t>(first - 1));
+    const __m128i above = _mm_set1_epi8(static_cast<char_t>(last + 1));
+    return _mm_and_si128(_mm_cmpgt_epi8(characters, below),
+                         _mm_cmplt_epi8(characters, above));
+}
+
+//! @brief Decodes 16 characters per step with SSSE3 instructions.
+//!
+//! Each character is mapped to its sextet by the range it lies in. The
+//! sextets are merged by multiply-add instructions and the bytes are brought
+//! into order by a shuffle.
+//! @param[in]  data        Characters to decode.
+//! @param[in]  size        Number of characters.
+//! @param[out] destination Decoded bytes.
+//! @return                 Number of decoded characters.
+__attribute__((target("ssse3"))) size_t decode_vectors(const char_t* data,
+                                                       size_t size,
+                                                       uint8_t* destination)
+{
+    const __m128i order =
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    // a whole vector is stored, therefore the loop stops early enough to keep
+    // the 4 bytes beyond the decoded bytes within the destination
+    static const size_t reserve = vector_size + (vector_size / 2);
+
+    size_t result = 0;
+    bool valid = true;
+    while (valid && ((size - result) >= reserve)) {
+        const __m128i in = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data + result));
+
+        const __m128i upper = in_range(in, 'A', 'Z');
+        const __m128i lower = in_range(in, 'a', 'z');
+        const __m128i digit = in_range(in, '0', '9');
+        const __m128i c62 =
+            _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('+')),
+                         _mm_cmpeq_epi8(in, _mm_set1_epi8('-')));
+        const __m128i c63 =
+            _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')),
+                         _mm_cmpeq_epi8(in, _mm_set1_epi8('_')));
+        const __m128i known = _mm_or_si128(
+            _mm_or_si128(upper, lower),
+            _mm_or_si128(digit, _mm_or_si128(c62, c63)));
+
+        valid = (0xFFFF == _mm_movemask_epi8(known));
+        if (valid) {
+            const __m128i sextets = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_and_si128(upper, _mm_sub_epi8(in, _mm_set1_epi8('A'))),
+                    _mm_and_si128(lower,
+                                  _mm_sub_epi8(in, _mm_set1_epi8('a' - 26)))),
+                _mm_or_si128(
+                    _mm_and_si128(digit,
+                                  _mm_add_epi8(in, _mm_set1_epi8(52 - '0'))),
+                    _mm_or_si128(_mm_and_si128(c62, _mm_set1_epi8(62)),
+                                 _mm_and_si128(c63, _mm_set1_epi8(63)))));
+
+            // 4 sextets are merged into 24 bits of each lane
+            const __m128i pairs =
+                _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+            const __m128i lanes =
+                _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination),
+                             _mm_shuffle_epi8(lanes, order));
+
+            destination += vector_bytes;
+            result += vector_size;
+        }
+    }
+    return result;
 }
 
+//! @brief Selects the fastest encoder, that the processor supports.
+//!
+//! @return Function to encode the bulk of the data.
+encode_function select_encode_function(void)
+{
+    return (0 != __builtin_cpu_supports("ssse3")) ? &encode_vectors
+                                                  : &encode_nothing;
+}
+
+//! @brief Selects the fastest decoder, that the processor supports.
+//!
+//! @return Function to decode the bulk of the string.
+decode_function select_decode_function(void)
+{
+    return (0 != __builtin_cpu_supports("ssse3")) ? &decode_vectors
+                                                  : &decode_nothing;
+}
+
+#else
+
+//! @brief Selects the fastest encoder, that the processor supports.
+//!
+//! @return Function to encode the bulk of the data.
+encode_function select_encode_function(void)
+{
+    return &encode_nothing;
+}
+
+//! @brief Selects the fastest decoder, that the processor supports.
+//!
+//! @return Function to decode the bulk of the string.
+decode_function select_decode_function(void)
+{
+    return &decode_nothing;
+}
+
+#endif
+
 } // namespace
 
-std::string encode_base64(const std::vector<uint8_t>& data)
+size_t encode_base64(const uint8_t* const data, const size_t size,
+                     char_t* const destination)
 {
-    std::string result;
-    const uint8_t* p = data.data();
-    size_t remaining = data.size();
+    static const encode_function encode_bulk = select_encode_function();
+
+    const size_t bulk_size = encode_bulk(data, size, destination);
+    const uint8_t* p = data + bulk_size;
+    char_t* d = destination + base64_encoded_size(bulk_size);
+    size_t remaining = size - bulk_size;
+
+    // every 3 bytes are encoded into 4 hexades
+    while (remaining >= evaluation_chunk_size) {
+        const uint32_t bit_backlog =
+            (static_cast<uint32_t>(p[0]) << third_byte_offset) |
+            (static_cast<uint32_t>(p[1]) << second_byte_offset) |
+            static_cast<uint32_t>(p[2]);
+        *(d++) = base64_encoder_map[(bit_backlog >> fourth_hexade) &
+                                    hexade_bitmask];
+        *(d++) = base64_encoder_map[(bit_backlog >> third_hexade) &
+                                    hexade_bitmask];
+        *(d++) = base64_encoder_map[(bit_backlog >> second_hexade) &
+                                    hexade_bitmask];
+        *(d++) = base64_encoder_map[bit_backlog & hexade_bitmask];
+        p += evaluation_chunk_size;
+        remaining -= evaluation_chunk_size;
+    }
+
+    // write the remaining rest
     uint32_t bit_backlog = 0;
-    uint8_t bytes_in_backlog = 0;
-
-    // loop till all bytes were read
-    while (remaining > 0) {
-
-        // put these bytes into a backlog
-        bit_backlog = (bit_backlog << bits_per_byte) | (*p);
-        bytes_in_backlog++;
-        p++;
-        remaining--;
-
-        // everytime the limit is reached, encoding of 4 hexades has to be done
-        if (evaluation_chunk_size == bytes_in_backlog) {
-            for (ssize_t bits_to_shift =
-                     ((sextets_per_evaluation_chunk - 1) * sextets_size);
-                 bits_to_shift >= 0; bits_to_shift -= sextets_size) {
-                const uint8_t token =
-                    (bit_backlog >> bits_to_shift) & hexade_bitmask;
-                result.push_back(get_base64_encoder_map()[token]);
-            }
-            bytes_in_backlog = 0;
-        }
+    for (size_t i = 0; i < remaining; i++) {
+        bit_backlog = (bit_backlog << bits_per_byte) | p[i];
     }
+    d += write_base64_last_bytes(d, static_cast<uint8_t>(remaining),
+                                 bit_backlog);
 
-    // append the remaining rest
-    append_base64_last_bytes(result, bytes_in_backlog, bit_backlog);
+    return static_cast<size_t>(d - destination);
+}
 
+std::string encode_base64(const std::vector<uint8_t>& data)
+{
+    std::string result(base64_encoded_size(data.size()), '\0');
+    encode_base64(data.data(), data.size(), &result[0]);
     return result;
 }
 
-std::vector<uint8_t> decode_base64(const char_t* const encoded_string,
-                                   const size_t encoded_string_size)
+bool decode_base64(const char_t* const encoded_string,
+                   const size_t encoded_string_size, uint8_t* const destination,
+                   size_t& decoded_size)
 {
-    static const std::array<int8_t, 1 << bits_per_byte> base64_decoder_map = {
-        {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, 62, -1, 62, -1, 63, 52, 53, 54, 55, 56, 57,
-         58, 59, 60, 61, -1, -1, -1, -1, -1, -1, -1, 0,  1,  2,  3,  4,  5,  6,
-         7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
-         25, -1, -1, -1, -1, 63, -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
-         37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-         -1, -1, -1, -1}};
-
-    std::vector<uint8_t> result;
-
-    static const size_t second_byte_offset = bits_per_byte;
-    static const size_t third_byte_offset = second_byte_offset + bits_per_byte;
-    static const size_t byte_bitmask = 0xFFU;
+    static const decode_function decode_bulk = select_decode_function();
+
+    const size_t bulk_size =
+        decode_bulk(encoded_string, encoded_string_size, destination);
+    uint8_t* d = destination + base64_decoded_max_size(bulk_size);
 
     uint32_t bit_backlog = 0;
     uint8_t sextets_in_backlog = 0;
 
-    // loop over every byte in the base64 string
-    for (size_t i = 0; i < encoded_string_size; ++i) {
+    // loop over every remaining byte in the base64 string
+    for (size_t i = bulk_size; i < encoded_string_size; ++i) {
         const uint8_t& ub = static_cast<const uint8_t&>(encoded_string[i]);
 
         // every byte has a token represensation
@@ -178,24 +404,18 @@ std::vector<uint8_t> decode_base64(const char_t* const encoded_string,
         // whenever the number of sextets per chunk is reached the conversion
         // starts
         if (sextets_per_evaluation_chunk == sextets_in_backlog) {
-            result.push_back((bit_backlog >> third_byte_offset) & byte_bitmask);
-            result.push_back((bit_backlog >> second_byte_offset) &
-                             byte_bitmask);
-            result.push_back(bit_backlog & byte_bitmask);
+            *(d++) = (bit_backlog >> third_byte_offset) & byte_bitmask;
+            *(d++) = (bit_backlog >> second_byte_offset) & byte_bitmask;
+            *(d++) = bit_backlog & byte_bitmask;
             sextets_in_backlog = 0;
         }
     }
 
     // there may be remaining sextets in the bit backlog if the string was not
-    // correctly terminated by padding
-    if (sextets_in_backlog != 0) {
-
-        // it is not possible to convert only 6 bits into at least one byte
-        if (sextets_in_backlog == 1) {
-
-            // this is an error
-            return std::vector<uint8_t>();
-        }
+    // correctly terminated by padding, but it is not possible to convert only
+    // 6 bits into at least one byte
+    const bool result = (1 != sextets_in_backlog);
+    if (result && (sextets_in_backlog != 0)) {
 
         // fill up with zero bits as padding
         const uint8_t original_sextets_in_backlog = sextets_in_backlog;
@@ -205,13 +425,24 @@ std::vector<uint8_t> decode_base64(const char_t* const encoded_string,
         }
 
         // convert the chunk
-        result.push_back((bit_backlog >> third_byte_offset) & byte_bitmask);
+        *(d++) = (bit_backlog >> third_byte_offset) & byte_bitmask;
         if (original_sextets_in_backlog == evaluation_chunk_size) {
-            result.push_back((bit_backlog >> second_byte_offset) &
-                             byte_bitmask);
+            *(d++) = (bit_backlog >> second_byte_offset) & byte_bitmask;
         }
     }
 
+    decoded_size = result ? static_cast<size_t>(d - destination) : 0;
+    return result;
+}
+
+std::vector<uint8_t> decode_base64(const char_t* const encoded_string,
+                                   const size_t encoded_string_size)
+{
+    std::vector<uint8_t> result(base64_decoded_max_size(encoded_string_size));
+    size_t decoded_size = 0;
+    decode_base64(encoded_string, encoded_string_size, result.data(),
+                  decoded_size);
+    result.resize(decoded_size);
     return result;
 }
 
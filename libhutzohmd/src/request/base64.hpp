@@ -38,6 +38,27 @@ namespace hutzn
 //! @return         A base64 encoded string.
 std::string encode_base64(const std::vector<uint8_t>& data);
 
+//! @brief Returns the number of characters of the base64 encoding.
+//!
+//! @param[in] size Number of bytes to encode.
+//! @return         Number of characters including the padding.
+constexpr size_t base64_encoded_size(const size_t size)
+{
+    return ((size + 2) / 3) * 4;
+}
+
+//! @brief Encodes data in base64 format into a buffer of the caller.
+//!
+//! Encodes like @ref encode_base64(const std::vector<uint8_t>&), but does not
+//! allocate. The destination is not null-terminated.
+//! @param[in]  data        Bytes to encode.
+//! @param[in]  size        Number of bytes to encode.
+//! @param[out] destination Buffer of at least base64_encoded_size(size)
+//!                         characters.
+//! @return                 Number of written characters.
+size_t encode_base64(const uint8_t* const data, const size_t size,
+                     char_t* const destination);
+
 //! @brief Decodes a base64 formatted string.
 //!
 //! Stores it in a vector as binary encoded data. It will act a bit more
@@ -52,6 +73,32 @@ std::string encode_base64(const std::vector<uint8_t>& data);
 std::vector<uint8_t> decode_base64(const char_t* const encoded_string,
                                    const size_t encoded_string_size);
 
+//! @brief Returns the maximum number of bytes, that a base64 encoded string
+//! decodes to.
+//!
+//! @param[in] size Number of characters of the encoded string.
+//! @return         Maximum number of decoded bytes.
+constexpr size_t base64_decoded_max_size(const size_t size)
+{
+    return (size * 3) / 4;
+}
+
+//! @brief Decodes a base64 formatted string into a buffer of the caller.
+//!
+//! Decodes like @ref decode_base64(const char_t* const, const size_t), but
+//! does not allocate.
+//! @param[in]  encoded_string      Base64 encoded string.
+//! @param[in]  encoded_string_size Size of the encoded string.
+//! @param[out] destination         Buffer of at least
+//!                                 base64_decoded_max_size(encoded_string_size)
+//!                                 bytes.
+//! @param[out] decoded_size        Number of decoded bytes.
+//! @return                         False, when the string is malformed. The
+//!                                 decoded size is 0 in this case.
+bool decode_base64(const char_t* const encoded_string,
+                   const size_t encoded_string_size, uint8_t* const destination,
+                   size_t& decoded_size);
+
 } // namespace hutzn
 
 #endif // LIBHUTZNOHMD_REQUEST_BASE64_HPP
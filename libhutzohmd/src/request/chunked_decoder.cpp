@@ -0,0 +1,289 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "chunked_decoder.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace hutzn
+{
+
+namespace
+{
+
+//! Maximum chunk size, that could be shifted by one hex digit without
+//! overflowing.
+static const size_t maximum_shiftable_size =
+    std::numeric_limits<size_t>::max() >> 4;
+
+//! Maximum number of hex digits of a chunk size including leading zeros.
+static const size_t maximum_size_digits = 2 * sizeof(size_t);
+
+//! @brief Converts a hex digit into its value.
+//!
+//! @param[in] ch Character to convert.
+//! @return       Value of the digit or -1 if the character is no hex digit.
+int32_t hex_value(const char_t ch)
+{
+    int32_t result;
+    if ((ch >= '0') && (ch <= '9')) {
+        result = ch - '0';
+    } else if ((ch >= 'a') && (ch <= 'f')) {
+        result = (ch - 'a') + 10;
+    } else if ((ch >= 'A') && (ch <= 'F')) {
+        result = (ch - 'A') + 10;
+    } else {
+        result = -1;
+    }
+    return result;
+}
+
+} // namespace
+
+chunked_decoder::chunked_decoder(const size_t max_content_length,
+                                 const size_t max_metadata_length,
+                                 const size_t max_trailer_count)
+    : max_content_length_(max_content_length)
+    , max_metadata_length_(max_metadata_length)
+    , max_trailer_count_(max_trailer_count)
+    , state_(decoder_state::size)
+    , size_digits_(0)
+    , chunk_remaining_(0)
+    , content_length_(0)
+    , metadata_length_(0)
+    , trailer_count_(0)
+    , is_line_feed_expected_(false)
+{
+}
+
+void chunked_decoder::reset(const size_t max_content_length,
+                            const size_t max_metadata_length,
+                            const size_t max_trailer_count)
+{
+    max_content_length_ = max_content_length;
+    max_metadata_length_ = max_metadata_length;
+    max_trailer_count_ = max_trailer_count;
+    state_ = decoder_state::size;
+    size_digits_ = 0;
+    chunk_remaining_ = 0;
+    content_length_ = 0;
+    metadata_length_ = 0;
+    trailer_count_ = 0;
+    is_line_feed_expected_ = false;
+}
+
+chunked_state chunked_decoder::decode(char_t* const data, const size_t size,
+                                      size_t& head, size_t& tail)
+{
+    assert(tail <= head);
+
+    // the final states are not left anymore and every byte beyond the content
+    // is not touched
+    while ((head < size) && (state_ != decoder_state::finished) &&
+           (state_ != decoder_state::malformed) &&
+           (state_ != decoder_state::too_large) &&
+           (state_ != decoder_state::fields_too_large)) {
+
+        if (state_ == decoder_state::data) {
+            // the chunk data is copied as a whole instead of bytewise
+            decode_data(data, size, head, tail);
+        } else if (is_line_feed_expected_ && (data[head] != '\n')) {
+            // a bare carriage return could be interpreted as line break by
+            // other parsers, which must not see a different content
+            state_ = decoder_state::malformed;
+        } else if (data[head] == '\r') {
+            // a line break could start with a carriage return in every state
+            is_line_feed_expected_ = true;
+            head++;
+        } else {
+            const char_t ch = data[head++];
+            is_line_feed_expected_ = false;
+
+            switch (state_) {
+            case decoder_state::size:
+                decode_size(ch);
+                break;
+
+            case decoder_state::extension:
+                // chunk extensions are not supported and are therefore
+                // skipped
+                if (ch == '\n') {
+                    finish_size_line();
+                } else {
+                    skip_metadata();
+                }
+                break;
+
+            case decoder_state::data_end:
+                if (ch == '\n') {
+                    size_digits_ = 0;
+                    state_ = decoder_state::size;
+                } else {
+                    state_ = decoder_state::malformed;
+                }
+                break;
+
+            case decoder_state::trailer:
+                // an empty line terminates the content
+                if (ch == '\n') {
+                    state_ = decoder_state::finished;
+                } else if (trailer_count_ < max_trailer_count_) {
+                    trailer_count_++;
+                    state_ = decoder_state::trailer_field;
+                    skip_metadata();
+                } else {
+                    state_ = decoder_state::fields_too_large;
+                }
+                break;
+
+            case decoder_state::trailer_field:
+                // trailer fields are not supported and are therefore skipped
+                if (ch == '\n') {
+                    state_ = decoder_state::trailer;
+                } else {
+                    skip_metadata();
+                }
+                break;
+
+            case decoder_state::data:
+            case decoder_state::finished:
+            case decoder_state::malformed:
+            case decoder_state::too_large:
+            case decoder_state::fields_too_large:
+            default:
+                assert(false);
+                break;
+            }
+        }
+    }
+
+    return external_state();
+}
+
+size_t chunked_decoder::content_length(void) const
+{
+    return content_length_;
+}
+
+void chunked_decoder::decode_size(const char_t ch)
+{
+    const int32_t value = hex_value(ch);
+    if (value >= 0) {
+        // the size must not overflow, when shifting in the next digit
+        if (chunk_remaining_ > maximum_shiftable_size) {
+            state_ = decoder_state::too_large;
+        } else if (size_digits_ == maximum_size_digits) {
+            // endless leading zeros would never overflow the size
+            state_ = decoder_state::malformed;
+        } else {
+            chunk_remaining_ =
+                (chunk_remaining_ << 4) | static_cast<size_t>(value);
+            size_digits_++;
+        }
+    } else if (size_digits_ == 0) {
+        // every chunk size line has to start with at least one digit
+        state_ = decoder_state::malformed;
+    } else if ((ch == ';') || (ch == ' ') || (ch == '\t')) {
+        state_ = decoder_state::extension;
+        skip_metadata();
+    } else if (ch == '\n') {
+        finish_size_line();
+    } else {
+        state_ = decoder_state::malformed;
+    }
+}
+
+void chunked_decoder::finish_size_line(void)
+{
+    if (chunk_remaining_ == 0) {
+        state_ = decoder_state::trailer;
+    } else if (chunk_remaining_ > (max_content_length_ - content_length_)) {
+        state_ = decoder_state::too_large;
+    } else {
+        state_ = decoder_state::data;
+    }
+}
+
+void chunked_decoder::skip_metadata(void)
+{
+    if (metadata_length_ < max_metadata_length_) {
+        metadata_length_++;
+    } else {
+        state_ = decoder_state::fields_too_large;
+    }
+}
+
+void chunked_decoder::decode_data(char_t* const data, const size_t size,
+                                  size_t& head, size_t& tail)
+{
+    size_t length = size - head;
+    if (length > chunk_remaining_) {
+        length = chunk_remaining_;
+    }
+
+    // the regions could overlap, because the decoded data is written into the
+    // raw data
+    if (head != tail) {
+        memmove(data + tail, data + head, length);
+    }
+    head += length;
+    tail += length;
+    content_length_ += length;
+    chunk_remaining_ -= length;
+
+    if (chunk_remaining_ == 0) {
+        state_ = decoder_state::data_end;
+    }
+}
+
+chunked_state chunked_decoder::external_state(void) const
+{
+    chunked_state result;
+    switch (state_) {
+    case decoder_state::finished:
+        result = chunked_state::FINISHED;
+        break;
+
+    case decoder_state::malformed:
+        result = chunked_state::MALFORMED;
+        break;
+
+    case decoder_state::too_large:
+        result = chunked_state::TOO_LARGE;
+        break;
+
+    case decoder_state::fields_too_large:
+        result = chunked_state::FIELDS_TOO_LARGE;
+        break;
+
+    case decoder_state::size:
+    case decoder_state::extension:
+    case decoder_state::data:
+    case decoder_state::data_end:
+    case decoder_state::trailer:
+    case decoder_state::trailer_field:
+    default:
+        result = chunked_state::NEED_MORE_DATA;
+        break;
+    }
+    return result;
+}
+
+} // namespace hutzn
@@ -0,0 +1,203 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_CHUNKED_DECODER_HPP
+#define LIBHUTZNOHMD_REQUEST_CHUNKED_DECODER_HPP
+
+#include <cstddef>
+
+#include "libhutznohmd/types.hpp"
+
+namespace hutzn
+{
+
+//! Is returned by the chunked decoder to tell its user how to proceed.
+enum class chunked_state : uint8_t {
+    //! All data was decoded, but the last chunk was not yet reached.
+    NEED_MORE_DATA = 0,
+
+    //! The last chunk and the trailer were decoded completely.
+    FINISHED = 1,
+
+    //! The content is not a valid chunked encoding.
+    MALFORMED = 2,
+
+    //! The content exceeds the maximum content length.
+    TOO_LARGE = 3,
+
+    //! The chunk extensions or trailer fields exceed their limits.
+    FIELDS_TOO_LARGE = 4
+};
+
+//! @brief Decodes a content with chunked transfer-encoding incrementally.
+//!
+//! The data is decoded in place, which means that the decoded data is written
+//! into the same buffer that contains the raw data. This is possible, because
+//! the decoded data is never longer than the raw data. The data could be passed
+//! to the decoder as it arrives. Chunk extensions and trailer fields are
+//! discarded, but are limited like the header to prevent a client from sending
+//! them endlessly. Line breaks may either be CR-LF or a single LF, while a
+//! carriage return anywhere else is malformed.
+class chunked_decoder
+{
+public:
+    //! @brief Constructs the decoder.
+    //!
+    //! @param[in] max_content_length  Maximum number of decoded bytes. Every
+    //!                                content, that would exceed this limit,
+    //!                                is rejected.
+    //! @param[in] max_metadata_length Maximum number of bytes of all chunk
+    //!                                extensions and trailer fields.
+    //! @param[in] max_trailer_count   Maximum number of trailer fields.
+    explicit chunked_decoder(const size_t max_content_length,
+                             const size_t max_metadata_length,
+                             const size_t max_trailer_count);
+
+    //! @brief Resets the decoder to decode another content.
+    //!
+    //! @param[in] max_content_length  Maximum number of decoded bytes.
+    //! @param[in] max_metadata_length Maximum number of bytes of all chunk
+    //!                                extensions and trailer fields.
+    //! @param[in] max_trailer_count   Maximum number of trailer fields.
+    void reset(const size_t max_content_length,
+               const size_t max_metadata_length,
+               const size_t max_trailer_count);
+
+    //! @brief Decodes a part of the raw data.
+    //!
+    //! Reads the raw data from head to the end of the data and writes the
+    //! decoded data to tail. Both indices are getting increased. When the
+    //! content was decoded completely, the head points to the first byte beyond
+    //! the content. The tail must never be greater than the head.
+    //! @param[in,out] data Buffer containing the raw data.
+    //! @param[in]     size Size of the buffer.
+    //! @param[in,out] head Index of the first raw byte to decode.
+    //! @param[in,out] tail Index to write the next decoded byte to.
+    //! @return             State of the decoder after decoding.
+    chunked_state decode(char_t* const data, const size_t size, size_t& head,
+                         size_t& tail);
+
+    //! @brief Returns the number of decoded bytes.
+    //!
+    //! @return Number of decoded bytes of all chunks.
+    size_t content_length(void) const;
+
+private:
+    /*! @brief Defines the decoder's state machine.
+
+    @startuml{chunked_decoder_state_machine.svg} "Chunked decoder's state machine"
+    [*] --> size
+    size --> size : current is hex digit
+    size --> extension : current is ';', space or tab
+    size --> data : current is LF and size is not 0
+    size --> trailer : current is LF and size is 0
+    extension --> extension : metadata is within its limit
+    extension --> data : current is LF and size is not 0
+    extension --> trailer : current is LF and size is 0
+    data --> data_end : chunk is complete
+    data_end --> size : current is LF
+    trailer --> finished : current is LF
+    trailer --> trailer_field : trailer count is within its limit
+    trailer_field --> trailer_field : metadata is within its limit
+    trailer_field --> trailer : current is LF
+    finished --> [*]
+    note "A CR is skipped before a LF\nand is malformed otherwise." as N1
+    @enduml
+    */
+    enum class decoder_state {
+        //! Reads the hexadecimal size of the next chunk.
+        size = 0,
+
+        //! Skips the chunk extension till the end of the line.
+        extension = 1,
+
+        //! Copies the chunk data.
+        data = 2,
+
+        //! Expects the line break after the chunk data.
+        data_end = 3,
+
+        //! Expects either a trailer field or the final empty line.
+        trailer = 4,
+
+        //! Skips a trailer field till the end of the line.
+        trailer_field = 5,
+
+        //! The content was decoded completely.
+        finished = 6,
+
+        //! The content was malformed.
+        malformed = 7,
+
+        //! The content exceeded the maximum content length.
+        too_large = 8,
+
+        //! The chunk extensions or trailer fields exceeded their limits.
+        fields_too_large = 9
+    };
+
+    //! @brief Called in state size for each character.
+    void decode_size(const char_t ch);
+
+    //! @brief Called at the end of a chunk size line.
+    void finish_size_line(void);
+
+    //! @brief Called for each skipped byte of an extension or trailer field.
+    void skip_metadata(void);
+
+    //! @brief Called in state data to copy as much chunk data as available.
+    void decode_data(char_t* const data, const size_t size, size_t& head,
+                     size_t& tail);
+
+    //! @brief Returns the external state of the decoder.
+    chunked_state external_state(void) const;
+
+    //! Maximum number of decoded bytes.
+    size_t max_content_length_;
+
+    //! Maximum number of bytes of all chunk extensions and trailer fields.
+    size_t max_metadata_length_;
+
+    //! Maximum number of trailer fields.
+    size_t max_trailer_count_;
+
+    //! Current state of the decoder.
+    decoder_state state_;
+
+    //! Number of hex digits of the current chunk size line.
+    size_t size_digits_;
+
+    //! Remaining bytes of the current chunk.
+    size_t chunk_remaining_;
+
+    //! Number of decoded bytes of all chunks.
+    size_t content_length_;
+
+    //! Number of skipped bytes of all chunk extensions and trailer fields.
+    size_t metadata_length_;
+
+    //! Number of trailer fields.
+    size_t trailer_count_;
+
+    //! A carriage return was read, which has to be followed by a line feed.
+    bool is_line_feed_expected_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_CHUNKED_DECODER_HPP
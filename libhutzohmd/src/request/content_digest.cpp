@@ -0,0 +1,227 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "content_digest.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "request/crc32c.hpp"
+#include "utility/common.hpp"
+#include "utility/keyword_table.hpp"
+#include "utility/parsing.hpp"
+
+namespace hutzn
+{
+
+namespace
+{
+
+//! Encloses a byte sequence of a structured header field.
+static const char_t byte_sequence_delimiter = ':';
+
+//! Maximum number of characters of a sum of a supported algorithm.
+static const size_t max_encoded_sum_size = base64_encoded_size(sha256_size);
+
+//! Stores a decoded sum of a supported algorithm.
+using sum_array = std::array<uint8_t, base64_decoded_max_size(
+                                          max_encoded_sum_size)>;
+
+//! Names of the supported algorithms.
+static constexpr keyword_table<digest_algorithm, 2> algorithms{
+    {{{"crc32c", digest_algorithm::CRC32C},
+      {"sha-256", digest_algorithm::SHA_256}}}};
+
+//! @brief Converts a checksum into network byte order.
+//!
+//! @param[in] crc Checksum.
+//! @return        Bytes of the checksum.
+std::array<uint8_t, sizeof(uint32_t)> to_bytes(const uint32_t crc)
+{
+    std::array<uint8_t, sizeof(uint32_t)> result;
+    for (size_t i = 0; i < result.size(); i++) {
+        const size_t shift = (result.size() - 1 - i) * bits_per_byte;
+        result[i] = static_cast<uint8_t>(crc >> shift);
+    }
+    return result;
+}
+
+//! @brief Appends a string to a buffer.
+//!
+//! @param[in,out] destination Points to the end of the buffer.
+//! @param[in]     string      String to append.
+//! @param[in]     length      Length of the string.
+void append(char_t*& destination, const char_t* const string,
+            const size_t length)
+{
+    destination = std::copy(string, string + length, destination);
+}
+
+} // namespace
+
+size_t format_content_digest(const digest_algorithm algorithm,
+                             const char_t* const data, const size_t size,
+                             char_t* const destination)
+{
+    static const char_t crc32c_prefix[] = "crc32c=:";
+    static const char_t sha256_prefix[] = "sha-256=:";
+
+    char_t* end = destination;
+    if (digest_algorithm::CRC32C == algorithm) {
+        const std::array<uint8_t, sizeof(uint32_t)> crc =
+            to_bytes(calculate_crc32c(data, size));
+        append(end, crc32c_prefix, sizeof(crc32c_prefix) - 1);
+        end += encode_base64(crc.data(), crc.size(), end);
+    } else {
+        const sha256_array sha256 = calculate_sha256(data, size);
+        append(end, sha256_prefix, sizeof(sha256_prefix) - 1);
+        end += encode_base64(sha256.data(), sha256.size(), end);
+    }
+    *end = byte_sequence_delimiter;
+    end++;
+
+    return static_cast<size_t>(end - destination);
+}
+
+content_digest_verifier::content_digest_verifier(void)
+    : malformed_(false)
+    , has_crc32c_(false)
+    , expected_crc32c_(0)
+    , crc32c_(0)
+    , has_sha256_(false)
+    , expected_sha256_()
+    , sha256_()
+{
+}
+
+bool content_digest_verifier::parse(const char_t* value, size_t length)
+{
+    bool result = true;
+
+    // the value is a dictionary of algorithms and byte sequences:
+    // algorithm=:base64:, algorithm=:base64:
+    skip_whitespace(value, length);
+    while (result && (length > 0)) {
+        const char_t* const key = value;
+        const char_t* const equals =
+            static_cast<const char_t*>(::memchr(value, '=', length));
+        const char_t* const begin = (NULL != equals) ? (equals + 1) : NULL;
+        const char_t* const end = value + length;
+        const char_t* const sequence_end =
+            ((NULL != begin) && (begin < end) &&
+             (byte_sequence_delimiter == *begin))
+                ? std::find(begin + 1, end, byte_sequence_delimiter)
+                : end;
+        if (sequence_end == end) {
+            result = false;
+        } else {
+            digest_algorithm algorithm;
+            const size_t key_length = static_cast<size_t>(equals - key);
+            if (algorithms.find(key, key_length, algorithm)) {
+                // the sums of other algorithms are not decoded at all
+                sum_array sum;
+                size_t sum_size = 0;
+                const size_t encoded_size =
+                    static_cast<size_t>(sequence_end - begin - 1);
+                result = (encoded_size <= max_encoded_sum_size) &&
+                         decode_base64(begin + 1, encoded_size, sum.data(),
+                                       sum_size);
+                if (digest_algorithm::CRC32C == algorithm) {
+                    has_crc32c_ = result && (sum_size == sizeof(uint32_t));
+                    expected_crc32c_ = 0;
+                    for (size_t i = 0; has_crc32c_ && (i < sum_size); i++) {
+                        expected_crc32c_ =
+                            (expected_crc32c_ << bits_per_byte) | sum[i];
+                    }
+                    result = has_crc32c_;
+                } else {
+                    has_sha256_ = result && (sum_size == sha256_size);
+                    if (has_sha256_) {
+                        std::copy(sum.begin(), sum.begin() + sha256_size,
+                                  expected_sha256_.begin());
+                    }
+                    result = has_sha256_;
+                }
+            }
+
+            // continues with the next member of the dictionary
+            value = sequence_end + 1;
+            length = static_cast<size_t>(end - value);
+            skip_whitespace(value, length);
+            if ((length > 0) && (',' == *value)) {
+                skip_one_character(value, length);
+                skip_whitespace(value, length);
+                result = result && (length > 0);
+            } else {
+                result = result && (0 == length);
+            }
+        }
+    }
+
+    malformed_ = malformed_ || (false == result);
+    return result;
+}
+
+bool content_digest_verifier::empty(void) const
+{
+    return (false == malformed_) && (false == has_crc32c_) &&
+           (false == has_sha256_);
+}
+
+void content_digest_verifier::update(const char_t* const data,
+                                     const size_t size)
+{
+    if (has_crc32c_) {
+        crc32c_ = update_crc32c(crc32c_, data, size);
+    }
+    if (has_sha256_) {
+        sha256_.update(data, size);
+    }
+}
+
+bool content_digest_verifier::verify(void)
+{
+    bool result = (false == malformed_);
+    if (has_crc32c_) {
+        result = result && (crc32c_ == expected_crc32c_);
+        crc32c_ = 0;
+    }
+    if (has_sha256_) {
+        result = (sha256_.finish() == expected_sha256_) && result;
+    }
+    return result;
+}
+
+void content_digest_verifier::restart(void)
+{
+    crc32c_ = 0;
+    sha256_.reset();
+}
+
+void content_digest_verifier::reset(void)
+{
+    malformed_ = false;
+    has_crc32c_ = false;
+    expected_crc32c_ = 0;
+    crc32c_ = 0;
+    has_sha256_ = false;
+    sha256_.reset();
+}
+
+} // namespace hutzn
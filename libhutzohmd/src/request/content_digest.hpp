@@ -0,0 +1,113 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_CONTENT_DIGEST_HPP
+#define LIBHUTZNOHMD_REQUEST_CONTENT_DIGEST_HPP
+
+#include <cstdint>
+
+#include "libhutznohmd/request.hpp"
+#include "request/base64.hpp"
+#include "request/sha256.hpp"
+
+namespace hutzn
+{
+
+//! Maximum number of characters of a Content-Digest header field value, that
+//! contains one sum.
+static const std::size_t max_content_digest_length =
+    sizeof("sha-256=::") - 1 + base64_encoded_size(sha256_size);
+
+//! @brief Formats the value of a Content-Digest header field.
+//!
+//! The value contains the sum of one algorithm as defined by
+//! [RFC9530|https://www.rfc-editor.org/rfc/rfc9530]. It is not
+//! null-terminated.
+//! @param[in]  algorithm   Algorithm to calculate the sum.
+//! @param[in]  data        Content to calculate the sum of.
+//! @param[in]  size        Size of the content.
+//! @param[out] destination Buffer of at least max_content_digest_length
+//!                         characters.
+//! @return                 Number of written characters.
+std::size_t format_content_digest(const digest_algorithm algorithm,
+                                  const char_t* const data,
+                                  const std::size_t size,
+                                  char_t* const destination);
+
+//! @brief Verifies a content against a Content-Digest header field.
+//!
+//! The expected sums are taken from the header field value. The content could
+//! be passed as a whole or in parts as it arrives. Only the sums of supported
+//! algorithms are calculated and the sums of all other algorithms are ignored.
+class content_digest_verifier
+{
+public:
+    //! Constructs a verifier, which does not expect any sum.
+    content_digest_verifier(void);
+
+    //! @brief Takes the expected sums of a Content-Digest header field.
+    //!
+    //! @param[in] value  Value of the header field.
+    //! @param[in] length Length of the value.
+    //! @return           False, when the value is malformed or a sum of a
+    //!                   supported algorithm has a wrong size. The
+    //!                   verification fails in this case.
+    bool parse(const char_t* value, std::size_t length);
+
+    //! @brief Returns whether any sum is expected.
+    //!
+    //! @return True when no sum of a supported algorithm is expected and the
+    //!         header field value was not malformed.
+    bool empty(void) const;
+
+    //! @brief Appends a part of the content.
+    //!
+    //! @param[in] data Pointer to the part of the content.
+    //! @param[in] size Size of the part.
+    void update(const char_t* const data, const std::size_t size);
+
+    //! @brief Compares all expected sums with the sums of the content.
+    //!
+    //! The calculation starts again afterwards.
+    //! @return True when all sums match.
+    bool verify(void);
+
+    //! Forgets all parts of the content, but keeps the expected sums.
+    void restart(void);
+
+    //! Forgets the expected sums and all parts of the content.
+    void reset(void);
+
+private:
+    //! True when the header field value could not be parsed.
+    bool malformed_;
+
+    //! True when a CRC32C checksum is expected.
+    bool has_crc32c_;
+    uint32_t expected_crc32c_;
+    uint32_t crc32c_;
+
+    //! True when a SHA-256 sum is expected.
+    bool has_sha256_;
+    sha256_array expected_sha256_;
+    sha256_context sha256_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_CONTENT_DIGEST_HPP
@@ -0,0 +1,241 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#include "utility/common.hpp"
+
+namespace hutzn
+{
+
+namespace
+{
+
+//! Reversed polynomial of CRC32C.
+static const uint32_t polynomial = 0x82F63B78U;
+
+//! Number of bytes, which are processed at once.
+static const size_t slice_size = sizeof(uint64_t);
+
+using crc_table =
+    std::array<std::array<uint32_t, byte_state_count>, slice_size>;
+
+//! @brief Builds the tables for the slicing-by-8 algorithm.
+//!
+//! The first table is the usual byte-wise table. Each further table continues
+//! the previous one by another zero byte.
+//! @return Tables of all slices.
+constexpr crc_table make_crc_table(void)
+{
+    crc_table result{};
+    for (size_t value = 0; value < byte_state_count; value++) {
+        uint32_t crc = static_cast<uint32_t>(value);
+        for (size_t bit = 0; bit < bits_per_byte; bit++) {
+            crc = (crc >> 1) ^ (((crc & 1U) != 0) ? polynomial : 0U);
+        }
+        result[0][value] = crc;
+    }
+    for (size_t slice = 1; slice < slice_size; slice++) {
+        for (size_t value = 0; value < byte_state_count; value++) {
+            const uint32_t previous = result[slice - 1][value];
+            result[slice][value] =
+                (previous >> bits_per_byte) ^ result[0][previous & 0xFFU];
+        }
+    }
+    return result;
+}
+
+//! Tables for the slicing-by-8 algorithm.
+static constexpr crc_table table = make_crc_table();
+
+//! @brief Processes the bytes one by one.
+//!
+//! @param[in] crc   Inverted checksum of the previous bytes.
+//! @param[in] begin First byte to process.
+//! @param[in] end   Byte behind the last byte to process.
+//! @return          Inverted checksum including these bytes.
+uint32_t update_bytes(uint32_t crc, const uint8_t* begin,
+                      const uint8_t* const end)
+{
+    while (begin < end) {
+        crc = (crc >> bits_per_byte) ^ table[0][(crc ^ *begin) & 0xFFU];
+        begin++;
+    }
+    return crc;
+}
+
+//! Signature of the functions, which calculate an inverted checksum.
+using update_function = uint32_t (*)(uint32_t, const uint8_t*, const size_t);
+
+//! @brief Calculates the inverted checksum with lookup tables.
+//!
+//! @param[in] crc  Inverted checksum of the previous bytes.
+//! @param[in] data Bytes to process.
+//! @param[in] size Number of bytes to process.
+//! @return         Inverted checksum including these bytes.
+uint32_t update_with_tables(uint32_t crc, const uint8_t* const data,
+                            const size_t size)
+{
+    const uint8_t* const end = data + size;
+    const uint8_t* const slices_end = data + (size - (size % slice_size));
+
+    const uint8_t* it = data;
+    while (it < slices_end) {
+        // the bytes are combined in little endian order independently of the
+        // platform
+        const uint32_t low = crc ^ (static_cast<uint32_t>(it[0]) |
+                                    (static_cast<uint32_t>(it[1]) << 8) |
+                                    (static_cast<uint32_t>(it[2]) << 16) |
+                                    (static_cast<uint32_t>(it[3]) << 24));
+        crc = table[7][low & 0xFFU] ^ table[6][(low >> 8) & 0xFFU] ^
+              table[5][(low >> 16) & 0xFFU] ^ table[4][low >> 24] ^
+              table[3][it[4]] ^ table[2][it[5]] ^ table[1][it[6]] ^
+              table[0][it[7]];
+        it += slice_size;
+    }
+
+    return update_bytes(crc, it, end);
+}
+
+#if defined(__x86_64__)
+
+//! @brief Calculates the inverted checksum with the crc32 instruction.
+//!
+//! @param[in] crc  Inverted checksum of the previous bytes.
+//! @param[in] data Bytes to process.
+//! @param[in] size Number of bytes to process.
+//! @return         Inverted checksum including these bytes.
+__attribute__((target("sse4.2"))) uint32_t update_with_instruction(
+    uint32_t crc, const uint8_t* const data, const size_t size)
+{
+    const uint8_t* const end = data + size;
+    const uint8_t* const slices_end = data + (size - (size % slice_size));
+
+    uint64_t crc64 = crc;
+    const uint8_t* it = data;
+    while (it < slices_end) {
+        uint64_t slice;
+        ::memcpy(&slice, it, sizeof(slice));
+        crc64 = _mm_crc32_u64(crc64, slice);
+        it += slice_size;
+    }
+    crc = static_cast<uint32_t>(crc64);
+
+    while (it < end) {
+        crc = _mm_crc32_u8(crc, *it);
+        it++;
+    }
+    return crc;
+}
+
+//! @brief Selects the fastest implementation, that the processor supports.
+//!
+//! @return Function to calculate the checksum.
+update_function select_update_function(void)
+{
+    return (0 != __builtin_cpu_supports("sse4.2")) ? &update_with_instruction
+                                                   : &update_with_tables;
+}
+
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+//! @brief Calculates the inverted checksum with the crc32c instructions.
+//!
+//! @param[in] crc  Inverted checksum of the previous bytes.
+//! @param[in] data Bytes to process.
+//! @param[in] size Number of bytes to process.
+//! @return         Inverted checksum including these bytes.
+uint32_t update_with_instruction(uint32_t crc, const uint8_t* const data,
+                                 const size_t size)
+{
+    const uint8_t* const end = data + size;
+    const uint8_t* const slices_end = data + (size - (size % slice_size));
+
+    const uint8_t* it = data;
+    while (it < slices_end) {
+        uint64_t slice;
+        ::memcpy(&slice, it, sizeof(slice));
+        crc = __crc32cd(crc, slice);
+        it += slice_size;
+    }
+
+    while (it < end) {
+        crc = __crc32cb(crc, *it);
+        it++;
+    }
+    return crc;
+}
+
+//! @brief Selects the fastest implementation, that the processor supports.
+//!
+//! The instructions are part of the target architecture in this case.
+//! @return Function to calculate the checksum.
+update_function select_update_function(void)
+{
+    return &update_with_instruction;
+}
+
+#else
+
+//! @brief Selects the fastest implementation, that the processor supports.
+//!
+//! @return Function to calculate the checksum.
+update_function select_update_function(void)
+{
+    return &update_with_tables;
+}
+
+#endif
+
+} // namespace
+
+uint32_t update_crc32c(const uint32_t crc, const char_t* const data,
+                       const size_t size)
+{
+    static const update_function update = select_update_function();
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(data);
+    return ~update(~crc, bytes, size);
+}
+
+uint32_t calculate_crc32c(const char_t* const data, const size_t size)
+{
+    return update_crc32c(0, data, size);
+}
+
+namespace detail
+{
+
+uint32_t update_crc32c_portable(const uint32_t crc, const char_t* const data,
+                                const size_t size)
+{
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(data);
+    return ~update_with_tables(~crc, bytes, size);
+}
+
+} // namespace detail
+
+} // namespace hutzn
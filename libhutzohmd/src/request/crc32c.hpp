@@ -0,0 +1,66 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_CRC32C_HPP
+#define LIBHUTZNOHMD_REQUEST_CRC32C_HPP
+
+#include <cstdint>
+
+#include "libhutznohmd/types.hpp"
+
+namespace hutzn
+{
+
+//! @brief Continues the CRC32C (Castagnoli) checksum of a message.
+//!
+//! The checksum is calculated with the crc32 instruction of SSE 4.2 or ARMv8,
+//! when the processor supports it, and with lookup tables otherwise. A message
+//! could be passed in parts by passing the result of one call to the next one.
+//! @param[in] crc  Checksum of the previous parts or 0 for the first part.
+//! @param[in] data Pointer to the part of the message.
+//! @param[in] size Size of the part.
+//! @return         Checksum of the message including this part.
+uint32_t update_crc32c(const uint32_t crc, const char_t* const data,
+                       const std::size_t size);
+
+//! @brief Calculates the CRC32C checksum of a given vector of bytes.
+//!
+//! @param[in] data Pointer to the data to calculate.
+//! @param[in] size Size of the data.
+//! @return         Checksum of the data.
+uint32_t calculate_crc32c(const char_t* const data, const std::size_t size);
+
+namespace detail
+{
+
+//! @brief Continues the CRC32C checksum without any processor extension.
+//!
+//! Is the fallback of @ref update_crc32c and is equal to it in all other
+//! aspects.
+//! @param[in] crc  Checksum of the previous parts or 0 for the first part.
+//! @param[in] data Pointer to the part of the message.
+//! @param[in] size Size of the part.
+//! @return         Checksum of the message including this part.
+uint32_t update_crc32c_portable(const uint32_t crc, const char_t* const data,
+                                const std::size_t size);
+
+} // namespace detail
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_CRC32C_HPP
@@ -0,0 +1,88 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "custom_header_registry.hpp"
+
+#include <strings.h>
+
+#include "utility/key_value_table.hpp"
+
+namespace hutzn
+{
+
+custom_header_id register_custom_header(const char_t* const name)
+{
+    return custom_header_registry::instance().add(name);
+}
+
+custom_header_registry& custom_header_registry::instance(void)
+{
+    static custom_header_registry registry;
+    return registry;
+}
+
+custom_header_registry::custom_header_registry(void)
+    : add_mutex_()
+    , size_(0)
+    , hashes_()
+    , names_()
+{
+}
+
+custom_header_id custom_header_registry::add(const char_t* const name)
+{
+    custom_header_id result = invalid_custom_header_id;
+
+    if ((NULL != name) && ('\0' != name[0])) {
+        std::lock_guard<std::mutex> lock(add_mutex_);
+
+        const uint32_t name_hash = key_value_table::hash(name, false);
+        result = find(name_hash, name);
+
+        const size_t size = size_.load(std::memory_order_relaxed);
+        if ((invalid_custom_header_id == result) && (size < capacity)) {
+            hashes_[size] = name_hash;
+            names_[size] = name;
+
+            // the name has to be stored before it gets visible to the readers
+            size_.store(size + 1, std::memory_order_release);
+            result = static_cast<custom_header_id>(size);
+        }
+    }
+
+    return result;
+}
+
+custom_header_id custom_header_registry::find(const uint32_t name_hash,
+                                              const char_t* const name) const
+{
+    custom_header_id result = invalid_custom_header_id;
+
+    const size_t size = size_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < size; i++) {
+        if ((hashes_[i] == name_hash) &&
+            (0 == ::strcasecmp(names_[i].c_str(), name))) {
+            result = static_cast<custom_header_id>(i);
+            break;
+        }
+    }
+
+    return result;
+}
+
+} // namespace hutzn
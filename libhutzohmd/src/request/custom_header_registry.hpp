@@ -0,0 +1,86 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_CUSTOM_HEADER_REGISTRY_HPP
+#define LIBHUTZNOHMD_REQUEST_CUSTOM_HEADER_REGISTRY_HPP
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "libhutznohmd/request.hpp"
+
+namespace hutzn
+{
+
+//! @brief Stores the custom header field names, that are registered by the
+//! application.
+//!
+//! Names are only added and never removed. Adding a name is synchronized by a
+//! mutex, while looking up a name does not lock at all. This is possible,
+//! because a name is completely stored before the number of names is
+//! published.
+class custom_header_registry
+{
+public:
+    //! Maximum number of names, that could be registered.
+    static const size_t capacity = 32;
+
+    //! @brief Returns the registry of the process.
+    //!
+    //! @return Registry of the process.
+    static custom_header_registry& instance(void);
+
+    //! @brief Constructs an empty registry.
+    custom_header_registry(void);
+
+    custom_header_registry(const custom_header_registry&) = delete;
+    custom_header_registry& operator=(const custom_header_registry&) = delete;
+
+    //! @brief Registers a header field name.
+    //!
+    //! @param[in] name Null-terminated header field name.
+    //! @return         Identifier of the name or invalid_custom_header_id.
+    custom_header_id add(const char_t* const name);
+
+    //! @brief Looks up the identifier of a header field name.
+    //!
+    //! @param[in] name_hash Case-insensitive hash of the name.
+    //! @param[in] name      Null-terminated header field name.
+    //! @return              Identifier of the name or invalid_custom_header_id.
+    custom_header_id find(const uint32_t name_hash,
+                          const char_t* const name) const;
+
+private:
+    //! Serializes adding names.
+    std::mutex add_mutex_;
+
+    //! Number of names, which are published to the readers.
+    std::atomic<size_t> size_;
+
+    //! Case-insensitive hashes of the names.
+    std::array<uint32_t, capacity> hashes_;
+
+    //! Registered names.
+    std::array<std::string, capacity> names_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_CUSTOM_HEADER_REGISTRY_HPP
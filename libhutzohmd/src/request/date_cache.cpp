@@ -0,0 +1,85 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "date_cache.hpp"
+
+namespace hutzn
+{
+
+namespace
+{
+
+//! @brief Reads the realtime clock in a resolution of at least one second.
+//!
+//! The coarse clock does not need to query the hardware and is therefore
+//! preferred, when it is available.
+//! @return Current time in epoch time.
+time_t read_coarse_clock(void)
+{
+#ifdef CLOCK_REALTIME_COARSE
+    static const clockid_t clock = CLOCK_REALTIME_COARSE;
+#else
+    static const clockid_t clock = CLOCK_REALTIME;
+#endif
+
+    struct timespec time;
+    time_t result = -1;
+    if (0 == ::clock_gettime(clock, &time)) {
+        result = time.tv_sec;
+    }
+    return result;
+}
+
+} // namespace
+
+date_cache& date_cache::instance(void)
+{
+    static thread_local date_cache cache;
+    return cache;
+}
+
+date_cache::date_cache(void)
+    : date_cache(&read_coarse_clock)
+{
+}
+
+date_cache::date_cache(const clock_function clock)
+    : clock_(clock)
+    , timestamp_(-1)
+    , date_()
+{
+}
+
+time_t date_cache::now(void)
+{
+    const time_t timestamp = clock_();
+    if (timestamp != timestamp_) {
+        const size_t length = format_timestamp(timestamp, date_.data());
+        date_[length] = '\0';
+        timestamp_ = timestamp;
+    }
+    return timestamp;
+}
+
+const char_t* date_cache::date(void)
+{
+    now();
+    return date_.data();
+}
+
+} // namespace hutzn
@@ -0,0 +1,81 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_DATE_CACHE_HPP
+#define LIBHUTZNOHMD_REQUEST_DATE_CACHE_HPP
+
+#include <array>
+#include <ctime>
+
+#include "request/timestamp.hpp"
+
+namespace hutzn
+{
+
+//! @brief Provides the current time as epoch value and as IMF-fixdate.
+//!
+//! The date of a response is only precise to the second. Therefore the date
+//! is rendered once per second instead of for each response. The time is read
+//! from a coarse clock, which is much cheaper than a precise one. Each thread
+//! has its own cache, which is why no synchronization is necessary.
+class date_cache
+{
+public:
+    //! Returns the current time in epoch time.
+    using clock_function = time_t (*)(void);
+
+    //! @brief Returns the cache of the calling thread.
+    //!
+    //! @return Cache, which must only be used by the calling thread.
+    static date_cache& instance(void);
+
+    //! @brief Constructs a cache, which reads the coarse realtime clock.
+    date_cache(void);
+
+    //! @brief Constructs a cache, which reads a custom clock.
+    //!
+    //! @param[in] clock Function, that returns the current time.
+    explicit date_cache(const clock_function clock);
+
+    //! @brief Returns the current time.
+    //!
+    //! Renders the date again, when the second changed since the last call.
+    //! @return Current time in epoch time.
+    time_t now(void);
+
+    //! @brief Returns the current time as IMF-fixdate.
+    //!
+    //! Can be copied into the Date header field of a response.
+    //! @return Null-terminated date of imf_fixdate_length characters or an
+    //!         empty string, when the clock is beyond the range of dates.
+    const char_t* date(void);
+
+private:
+    //! Reads the current time.
+    clock_function clock_;
+
+    //! Time of the rendered date.
+    time_t timestamp_;
+
+    //! Rendered and null-terminated date.
+    std::array<char_t, imf_fixdate_length + 1> date_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_DATE_CACHE_HPP
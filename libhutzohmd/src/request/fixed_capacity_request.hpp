@@ -0,0 +1,169 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_FIXED_CAPACITY_REQUEST_HPP
+#define LIBHUTZNOHMD_REQUEST_FIXED_CAPACITY_REQUEST_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+
+#include "request/memory_allocating_request.hpp"
+#include "utility/key_value_table.hpp"
+
+namespace hutzn
+{
+
+namespace detail
+{
+
+//! @brief Holds the table memory of a fixed_capacity_request.
+//!
+//! It is a base class of the request and is therefore constructed before the
+//! request uses its memory. The memory is large enough for the header fields
+//! and query entries, which fit into the capacities. It does never fall back
+//! to the heap.
+template <size_t header_size, size_t header_count>
+class fixed_request_storage
+{
+public:
+    //! Maximum length of the request line. It bounds the number of query
+    //! entries, also of those in the Host header field.
+    static const size_t request_line_size =
+        (header_size < 2048) ? header_size : 2048;
+
+protected:
+    //! @brief Constructs the memory.
+    fixed_request_storage(void)
+        : memory_()
+        , resource_(memory_.data(), memory_.size(),
+                    std::pmr::null_memory_resource())
+    {
+    }
+
+    fixed_request_storage(const fixed_request_storage&) = delete;
+    fixed_request_storage& operator=(const fixed_request_storage&) = delete;
+
+    //! @brief Returns the memory resource of the tables.
+    //!
+    //! @return Memory resource, which serves the preallocated memory only.
+    std::pmr::memory_resource* resource(void)
+    {
+        return &resource_;
+    }
+
+private:
+    //! @brief Returns the number of entries, which do not fit into the inline
+    //! capacity of a table.
+    static constexpr size_t overflow(const size_t entries)
+    {
+        return (entries > key_value_table::inline_capacity)
+                   ? (entries - key_value_table::inline_capacity)
+                   : 0;
+    }
+
+    //! Number of bytes of an entry beyond the inline capacity of a table.
+    static const size_t entry_size =
+        sizeof(uint32_t) + sizeof(const char_t*) + sizeof(std::string_view);
+
+    //! Memory lost by aligning each allocation of the growing vectors.
+    static const size_t alignment_slack = 6 * 64 * alignof(std::max_align_t);
+
+    //! The vectors of a table double their capacity, while the memory of the
+    //! smaller capacities is never reused, which needs twice the memory. Each
+    //! query entry takes at least two characters of the request line.
+    static const size_t memory_size =
+        (2 * entry_size *
+         (overflow(header_count) + overflow(request_line_size / 2))) +
+        alignment_slack;
+
+    //! Preallocated memory of the tables.
+    alignas(std::max_align_t) std::array<uint8_t, memory_size> memory_;
+
+    //! Hands out the preallocated memory.
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+} // namespace detail
+
+//! @brief Request, which lives in memory of fixed capacities.
+//!
+//! The capacities are compile-time parameters: the number of header bytes, the
+//! number of header fields and the number of content bytes. All memory is
+//! allocated on construction, therefore the request should be constructed
+//! once per connection and be reset for each further request on that
+//! connection. Parsing a request within the capacities does not allocate. A
+//! request exceeding the capacities is rejected with the matching status code
+//! (414, 431 or 413).
+//!
+//! Chunked contents are decoded in a separate buffer, which is borrowed from
+//! the buffer pool of the thread. Data pipelined by the client is kept in the
+//! data buffer behind this request until the next request begins. Only data,
+//! which was read in one part larger than the free space of the data buffer,
+//! is kept in the heap.
+template <size_t header_size, size_t header_count, size_t content_size>
+class fixed_capacity_request
+    : private detail::fixed_request_storage<header_size, header_count>,
+      public memory_allocating_request
+{
+public:
+    //! Storage of the request.
+    using storage = detail::fixed_request_storage<header_size, header_count>;
+
+    //! @brief Constructs a request by a connection.
+    //!
+    //! @param[in] connection Connection to use when more data is needed.
+    //! @param[in] head_cache Optional cache of parsed heads.
+    explicit fixed_capacity_request(const connection_ptr& connection,
+                                    parsed_head_cache* const head_cache = NULL)
+        : storage()
+        , memory_allocating_request(connection, make_data_buffer(), limits(),
+                                    storage::resource(), head_cache)
+    {
+    }
+
+    //! @brief Returns the limits of the request, which match the capacities.
+    //!
+    //! @return Limits of the request.
+    static header_limits limits(void)
+    {
+        header_limits result;
+        result.max_request_line_length = storage::request_line_size;
+        result.max_header_length = header_size;
+        result.max_header_count = header_count;
+        result.max_content_length = content_size;
+        return result;
+    }
+
+private:
+    //! @brief Returns an empty buffer, which holds the header and the content.
+    //!
+    //! The lexer receives at most the header size at once while fetching the
+    //! header, therefore the buffer never has to grow.
+    static buffer make_data_buffer(void)
+    {
+        buffer result;
+        result.reserve((2 * header_size) + content_size);
+        return result;
+    }
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_FIXED_CAPACITY_REQUEST_HPP
@@ -0,0 +1,333 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_FIXED_CAPACITY_RESPONSE_HPP
+#define LIBHUTZNOHMD_REQUEST_FIXED_CAPACITY_RESPONSE_HPP
+
+#include <strings.h>
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#include "libhutznohmd/request.hpp"
+#include "request/base64.hpp"
+#include "request/content_digest.hpp"
+#include "request/md5.hpp"
+
+namespace hutzn
+{
+
+//! @brief Response, which lives in memory of fixed capacities.
+//!
+//! The capacities are compile-time parameters: the number of header field
+//! slots, the number of bytes of all header field names and values and the
+//! number of content bytes. Setting a header field or the content never
+//! allocates. Names and values are copied into the header bytes, which are
+//! reused only after a reset. Therefore the response should be constructed
+//! once per connection and be reset for each further response on that
+//! connection.
+//!
+//! A header field, which does not fit, is not set. A content, which does not
+//! fit, is not set at all. The response marks itself as overflowed in both
+//! cases, which should be answered with an internal server error.
+template <size_t header_slots, size_t header_size, size_t content_size>
+class fixed_capacity_response : public response
+{
+public:
+    //! @brief Constructs an empty response.
+    fixed_capacity_response(void)
+        : names_()
+        , values_()
+        , header_count_(0)
+        , header_data_()
+        , header_data_length_(0)
+        , content_()
+        , content_length_(0)
+        , overflowed_(false)
+    {
+    }
+
+    fixed_capacity_response(const fixed_capacity_response&) = delete;
+    fixed_capacity_response& operator=(const fixed_capacity_response&) =
+        delete;
+
+    //! @copydoc response::set_header()
+    bool set_header(const char_t* const name,
+                    const char_t* const value) override
+    {
+        static const std::array<const char_t*, 7> predefined_names = {
+            {"content-digest", "content-length", "content-location",
+             "content-md5", "location", "retry-after", "server"}};
+
+        bool is_predefined = (NULL == name);
+        for (const char_t* const predefined_name : predefined_names) {
+            if (is_predefined || (0 == ::strcasecmp(predefined_name, name))) {
+                is_predefined = true;
+                break;
+            }
+        }
+
+        return (false == is_predefined) && store_header(name, value);
+    }
+
+    //! @copydoc response::set_content()
+    void set_content(const buffer& content, const bool set_md5) override
+    {
+        if (content.size() <= content_size) {
+            ::memcpy(content_.data(), content.data(), content.size());
+            content_length_ = content.size();
+
+            char_t md5_string[base64_encoded_size(md5_size) + 1] = {'\0'};
+            if (set_md5) {
+                const md5_array md5 =
+                    calculate_md5(content.data(), content.size());
+                const size_t length =
+                    encode_base64(md5.data(), md5.size(), md5_string);
+                md5_string[length] = '\0';
+            }
+            store_or_overflow("Content-MD5", md5_string);
+        } else {
+            content_length_ = 0;
+            store_header("Content-MD5", "");
+            overflowed_ = true;
+        }
+
+        // a digest of the previous content is not valid anymore
+        store_header("Content-Digest", "");
+    }
+
+    //! @copydoc response::set_content_digest()
+    void set_content_digest(const digest_algorithm algorithm) override
+    {
+        char_t digest[max_content_digest_length + 1];
+        const size_t length = format_content_digest(
+            algorithm, content_.data(), content_length_, digest);
+        digest[length] = '\0';
+        store_or_overflow("Content-Digest", digest);
+    }
+
+    //! @copydoc response::set_content_location()
+    void set_content_location(const char_t* const content_location) override
+    {
+        store_or_overflow("Content-Location", content_location);
+    }
+
+    //! @copydoc response::set_location()
+    void set_location(const char_t* const location) override
+    {
+        store_or_overflow("Location", location);
+    }
+
+    //! @copydoc response::set_retry_after()
+    bool set_retry_after(const time_t retry_time) override
+    {
+        bool result = false;
+        if (retry_time >= 0) {
+            // the retry time is sent in seconds, which clears the header field
+            // when being 0
+            char_t seconds[std::numeric_limits<time_t>::digits10 + 2] = {'\0'};
+            if (retry_time > 0) {
+                const std::to_chars_result converted = std::to_chars(
+                    seconds, seconds + sizeof(seconds) - 1, retry_time);
+                *converted.ptr = '\0';
+            }
+            result = store_header("Retry-After", seconds);
+            overflowed_ = overflowed_ || (false == result);
+        }
+        return result;
+    }
+
+    //! @copydoc response::set_server()
+    void set_server(const char_t* const fingerprint) override
+    {
+        store_or_overflow("Server", fingerprint);
+    }
+
+    //! @brief Returns the number of set header fields.
+    //!
+    //! @return Number of header fields.
+    size_t header_count(void) const
+    {
+        return header_count_;
+    }
+
+    //! @brief Returns the name of a header field.
+    //!
+    //! @param[in] idx Index of the header field.
+    //! @return        Name or NULL, when the index is out of range.
+    const char_t* header_name(const size_t idx) const
+    {
+        return (idx < header_count_) ? &(header_data_[names_[idx]]) : NULL;
+    }
+
+    //! @brief Returns the value of a header field.
+    //!
+    //! @param[in] idx Index of the header field.
+    //! @return        Value or NULL, when the index is out of range.
+    const char_t* header_value(const size_t idx) const
+    {
+        return (idx < header_count_) ? &(header_data_[values_[idx]]) : NULL;
+    }
+
+    //! @brief Returns the value of a header field by its name.
+    //!
+    //! @param[in] name Name of the header field. It is compared
+    //!                 case-insensitively.
+    //! @return         Value or NULL, when the header field is not set.
+    const char_t* find_header(const char_t* const name) const
+    {
+        const size_t idx = index_of(name);
+        return header_value(idx);
+    }
+
+    //! @brief Returns the content.
+    //!
+    //! @return Content, which is not null-terminated.
+    const char_t* content(void) const
+    {
+        return content_.data();
+    }
+
+    //! @brief Returns the length of the content.
+    //!
+    //! @return Number of bytes of the content.
+    size_t content_length(void) const
+    {
+        return content_length_;
+    }
+
+    //! @brief Returns whether a header field or the content did not fit.
+    //!
+    //! @return True, when the response exceeded its capacities.
+    bool overflowed(void) const
+    {
+        return overflowed_;
+    }
+
+    //! @brief Clears the response for the next request on the connection.
+    void reset(void)
+    {
+        header_count_ = 0;
+        header_data_length_ = 0;
+        content_length_ = 0;
+        overflowed_ = false;
+    }
+
+private:
+    //! @brief Returns the index of a header field or the number of header
+    //! fields, when it is not set.
+    size_t index_of(const char_t* const name) const
+    {
+        size_t result = 0;
+        while ((result < header_count_) &&
+               (0 != ::strcasecmp(&(header_data_[names_[result]]), name))) {
+            result++;
+        }
+        return result;
+    }
+
+    //! @brief Appends a null-terminated string to the header bytes.
+    //!
+    //! @param[in] data String to append.
+    //! @param[out] offset Offset of the appended string.
+    //! @return True, when the string fitted into the header bytes.
+    bool append(const char_t* const data, size_t& offset)
+    {
+        bool result = false;
+        const size_t length = ::strlen(data) + 1;
+        if (length <= (header_size - header_data_length_)) {
+            ::memcpy(&(header_data_[header_data_length_]), data, length);
+            offset = header_data_length_;
+            header_data_length_ += length;
+            result = true;
+        }
+        return result;
+    }
+
+    //! @brief Sets, overwrites or clears a header field.
+    //!
+    //! @param[in] name  Name of the header field.
+    //! @param[in] value Value of the header field. An empty value or NULL
+    //!                  clears it.
+    //! @return          True, when the header field fitted.
+    bool store_header(const char_t* const name, const char_t* const value)
+    {
+        bool result;
+        const size_t idx = index_of(name);
+        if ((NULL == value) || ('\0' == value[0])) {
+            // the order of the other header fields is kept
+            if (idx < header_count_) {
+                for (size_t i = idx + 1; i < header_count_; i++) {
+                    names_[i - 1] = names_[i];
+                    values_[i - 1] = values_[i];
+                }
+                header_count_--;
+            }
+            result = true;
+        } else if (idx < header_count_) {
+            result = append(value, values_[idx]);
+        } else if (header_count_ < header_slots) {
+            result = append(name, names_[idx]) && append(value, values_[idx]);
+            if (result) {
+                header_count_++;
+            }
+        } else {
+            result = false;
+        }
+        return result;
+    }
+
+    //! @brief Stores a header field and marks the response as overflowed,
+    //! when it does not fit.
+    void store_or_overflow(const char_t* const name, const char_t* const value)
+    {
+        if (false == store_header(name, value)) {
+            overflowed_ = true;
+        }
+    }
+
+    //! Offsets of the header field names in the header bytes.
+    std::array<size_t, header_slots> names_;
+
+    //! Offsets of the header field values in the header bytes.
+    std::array<size_t, header_slots> values_;
+
+    //! Number of set header fields.
+    size_t header_count_;
+
+    //! Null-terminated names and values of the header fields.
+    std::array<char_t, header_size> header_data_;
+
+    //! Number of used header bytes.
+    size_t header_data_length_;
+
+    //! Content of the response. It has at least one byte to be addressable.
+    std::array<char_t, (content_size > 0) ? content_size : 1> content_;
+
+    //! Length of the content.
+    size_t content_length_;
+
+    //! True, when a header field or the content did not fit.
+    bool overflowed_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_FIXED_CAPACITY_RESPONSE_HPP
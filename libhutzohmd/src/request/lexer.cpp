@@ -18,57 +18,183 @@
 
 #include "lexer.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <string>
+
+#include "utility/buffer_pool.hpp"
 
 namespace hutzn
 {
 
-lexer::lexer(const connection_ptr& connection)
+namespace
+{
+
+//! Number of bytes to receive at once for a content of unknown length.
+static const size_t chunk_size = 4000;
+
+//! Maximum capacity of the content buffer, that is allocated in advance. The
+//! announced content length could not be trusted before it was received.
+static const size_t max_content_preallocation = 65536;
+
+//! Index of the pipelined data, as long as the end of the content is unknown.
+static const size_t unknown_index = std::numeric_limits<size_t>::max();
+
+//! @brief Returns the response, that is sent when rejecting a request.
+//!
+//! @param[in] status Status code of the response.
+//! @return           Response without content.
+std::string get_rejection_response(const http_status_code status)
+{
+    const char_t* reason;
+    if (status == http_status_code::REQUEST_ENTITY_TOO_LARGE) {
+        reason = "Request Entity Too Large";
+    } else if (status == http_status_code::REQUEST_URI_TOO_LONG) {
+        reason = "Request-URI Too Long";
+    } else if (status == http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE) {
+        reason = "Request Header Fields Too Large";
+    } else if (status == http_status_code::NOT_IMPLEMENTED) {
+        reason = "Not Implemented";
+    } else {
+        // requests are rejected with one of the above status codes or as bad
+        // request
+        assert(status == http_status_code::BAD_REQUEST);
+        reason = "Bad Request";
+    }
+
+    return "HTTP/1.1 " + std::to_string(static_cast<uint16_t>(status)) + " " +
+           reason + "\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+}
+
+//! @brief Passes the content, which was not yet passed, to the sink.
+//!
+//! Nothing is passed, when the sink is not set.
+//! @param[in]     content Buffer, which holds the content.
+//! @param[in]     end     Index behind the last byte of the content.
+//! @param[in]     sink    Sink, that gets the content.
+//! @param[in,out] passed  Index behind the last byte, which was passed.
+//! @return                False, when the sink stopped the fetching.
+bool pass_content(const buffer& content, const size_t end,
+                  const content_sink& sink, size_t& passed)
+{
+    bool result = true;
+    const size_t available = std::min(content.size(), end);
+    if (sink && (passed < available)) {
+        result = sink(content.data() + passed, available - passed);
+        passed = available;
+    }
+    return result;
+}
+
+} // namespace
+
+lexer::lexer(const connection_ptr& connection, const header_limits& limits)
     : connection_(connection)
+    , limits_(limits)
+    , header_lines_(0)
+    , rejection_status_(http_status_code::OK)
     , state_(lexer_state::copy)
-    , header_()
+    , data_(buffer_pool::instance().borrow(
+          buffer_pool::instance().header_receive_size()))
+    , header_length_(0)
+    , content_begin_(0)
     , content_()
+    , separate_content_(false)
+    , pipelined_begin_(unknown_index)
+    , pipelined_()
     , fetch_content_succeeded_(false)
+    , streaming_(false)
+    , streaming_complete_(false)
+    , content_offset_(0)
+    , streamed_length_(0)
+    , decoder_(0, 0, 0)
     , index_(0)
 {
 }
 
+lexer::lexer(const connection_ptr& connection, buffer&& pipelined_data,
+             const header_limits& limits)
+    : connection_(connection)
+    , limits_(limits)
+    , header_lines_(0)
+    , rejection_status_(http_status_code::OK)
+    , state_(lexer_state::copy)
+    , data_(std::move(pipelined_data))
+    , header_length_(0)
+    , content_begin_(0)
+    , content_()
+    , separate_content_(false)
+    , pipelined_begin_(unknown_index)
+    , pipelined_()
+    , fetch_content_succeeded_(false)
+    , streaming_(false)
+    , streaming_complete_(false)
+    , content_offset_(0)
+    , streamed_length_(0)
+    , decoder_(0, 0, 0)
+    , index_(0)
+{
+}
+
+lexer::~lexer(void) noexcept(true)
+{
+    buffer_pool& pool = buffer_pool::instance();
+    pool.give_back(std::move(data_));
+    pool.give_back(std::move(content_));
+    pool.give_back(std::move(pipelined_));
+}
+
 bool lexer::fetch_header(void)
 {
+    // receiving more than the largest allowed header at once is useless and
+    // bounds the growth of the data buffer
+    buffer_pool& pool = buffer_pool::instance();
+    const size_t receive_size =
+        std::min(pool.header_receive_size(), limits_.max_header_length);
+
     size_t tail = 0;
     size_t head = 0;
 
     // the last character is assumed to be 0 if no data was already processed
     char_t last = '\0';
 
-    static const size_t chunk_size = 4000;
-
     // loop will break, when one of the end states are reached
     // this will also guard calling the method twice or more
     while ((state_ != lexer_state::reached_content) &&
            (state_ != lexer_state::error)) {
 
-        // need more data
-        if (connection_->receive(header_, chunk_size)) {
+        // pipelined data of a previous request gets lexed first and more data
+        // is only needed, when all available data is processed
+        if ((head < data_.size()) ||
+            connection_->receive(data_, receive_size)) {
 
             // at least one character is available to get evaluated, because
-            // block_device::receive returns true, when at least one
-            // byte was read
+            // either there is unprocessed data or block_device::receive
+            // returns true, when at least one byte was read
+            // the limits are checked after each step to reject the request
+            // as early as possible
             do {
                 fetch_header_step(tail, head, last);
-            } while (head < header_.size());
+                check_header_limits(tail, head);
+            } while ((head < data_.size()) &&
+                     (state_ != lexer_state::reached_content) &&
+                     (state_ != lexer_state::error));
         } else {
             state_ = lexer_state::error;
         }
     }
 
-    // cutting off the header may be already done during
-    // fetch_header_reached_content, but when the header is received as a whole
-    // chunk this method will not get called and therefore the resize has to be
-    // repeated here to shrink the buffer to exactly the header size
-    if (tail > 0) {
-        assert(tail <= header_.size());
-        header_.resize(tail);
+    // the normalized header is at the beginning of the buffer, while the
+    // content starts right after the raw header
+    assert(tail <= data_.size());
+    header_length_ = tail;
+    if (state_ == lexer_state::reached_content) {
+        content_begin_ = head;
+        content_offset_ = head;
+
+        // the next headers are received with a size adapted to this header
+        pool.record_header_length(head);
     }
 
     // after the loop, the state has to be one of the end states
@@ -79,25 +205,83 @@ bool lexer::fetch_header(void)
     return state_ == lexer_state::reached_content;
 }
 
-bool lexer::fetch_content(const size_t length)
+void lexer::reject(const http_status_code status)
+{
+    state_ = lexer_state::error;
+    rejection_status_ = status;
+    connection_->send(get_rejection_response(status));
+}
+
+void lexer::reject_chunked_content(const chunked_state state)
+{
+    if (state == chunked_state::TOO_LARGE) {
+        reject(http_status_code::REQUEST_ENTITY_TOO_LARGE);
+    } else if (state == chunked_state::FIELDS_TOO_LARGE) {
+        reject(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE);
+    } else {
+        assert(state == chunked_state::MALFORMED);
+        reject(http_status_code::BAD_REQUEST);
+    }
+}
+
+http_status_code lexer::rejection_status(void) const
+{
+    return rejection_status_;
+}
+
+const header_limits& lexer::limits(void) const
+{
+    return limits_;
+}
+
+bool lexer::fetch_content(const size_t length, const content_sink& sink)
 {
     bool result = false;
-    if (state_ == lexer_state::reached_content) {
-        // never fetch more data than necessary
-        assert(content_.size() <= length);
+    if ((state_ == lexer_state::reached_content) && (false == streaming_)) {
+        // the content stays in the data buffer behind the header as long as it
+        // fits into it, because growing the buffer would invalidate all
+        // pointers into the header
+        if ((false == separate_content_) &&
+            (data_.capacity() < (content_begin_ + length))) {
+            move_content_into_own_buffer(
+                std::min(length, max_content_preallocation));
+        }
+
+        buffer& content = separate_content_ ? content_ : data_;
+        const size_t content_end =
+            separate_content_ ? length : (content_begin_ + length);
+
+        // a pipelining client could have sent the next request already, which
+        // must not be part of this content
+        if (content.size() > content_end) {
+            if (separate_content_) {
+                keep_pipelined_data(content.begin() +
+                                        static_cast<ssize_t>(content_end),
+                                    content.end());
+                content.resize(content_end);
+            } else {
+                pipelined_begin_ = content_end;
+            }
+        }
+
+        // the content, which was received together with the header, is passed
+        // first
+        size_t passed = separate_content_ ? 0 : content_begin_;
+        bool passing = pass_content(content, content_end, sink, passed);
 
         // fetching more data when necessary
-        bool fetch_more = (content_.size() < length);
+        bool fetch_more = passing && (content.size() < content_end);
         while (fetch_more) {
 
             // this must be done in a loop, because receive returns true, if
             // something is read
             // there is no gurantee, that all the necessary bytes are read
-            const size_t bytes_to_read = length - content_.size();
-            if (connection_->receive(content_, bytes_to_read)) {
+            const size_t bytes_to_read = content_end - content.size();
+            if (connection_->receive(content, bytes_to_read)) {
                 // recalculate fetch_more and continue receiving, when the
                 // content is not yet complete
-                fetch_more = (content_.size() < length);
+                passing = pass_content(content, content_end, sink, passed);
+                fetch_more = passing && (content.size() < content_end);
             } else {
                 // stop fetching, when receive fails
                 fetch_more = false;
@@ -105,7 +289,7 @@ bool lexer::fetch_content(const size_t length)
         }
 
         // returns true, when enough data is available
-        result = (length == content_.size());
+        result = passing && (content.size() >= content_end);
 
         // remember, that fetch_content once returned true
         fetch_content_succeeded_ = result;
@@ -114,14 +298,244 @@ bool lexer::fetch_content(const size_t length)
     return result;
 }
 
+bool lexer::fetch_chunked_content(const size_t max_length,
+                                  const content_sink& sink)
+{
+    bool result = false;
+    if (fetch_content_succeeded_) {
+        // the raw data was already decoded and is not available anymore,
+        // therefore the decoded content is passed as a whole
+        size_t passed = 0;
+        result = pass_content(content_, content_.size(), sink, passed);
+    } else if ((state_ == lexer_state::reached_content) &&
+               (false == streaming_)) {
+        // the length of the content is unknown, therefore it is decoded in its
+        // own buffer to keep the pointers into the header valid
+        if (false == separate_content_) {
+            move_content_into_own_buffer(chunk_size);
+        }
+
+        chunked_decoder decoder(max_length, limits_.max_header_length,
+                                limits_.max_header_count);
+        size_t tail = 0;
+        size_t head = 0;
+
+        // decode the data, which was received together with the header first
+        chunked_state state =
+            decoder.decode(content_.data(), content_.size(), head, tail);
+        size_t passed = 0;
+        bool passing = pass_content(content_, tail, sink, passed);
+        bool received = true;
+        while (passing && received &&
+               (state == chunked_state::NEED_MORE_DATA)) {
+            // drop the raw data, which was already decoded, before receiving
+            // more data to keep the buffer small
+            content_.resize(tail);
+            head = tail;
+            received = connection_->receive(content_, chunk_size);
+            if (received) {
+                state = decoder.decode(content_.data(), content_.size(), head,
+                                       tail);
+                passing = pass_content(content_, tail, sink, passed);
+            }
+        }
+
+        if (passing && (state == chunked_state::FINISHED)) {
+            // a pipelining client could have sent the next request already
+            keep_pipelined_data(content_.begin() + static_cast<ssize_t>(head),
+                                content_.end());
+            content_.resize(tail);
+            result = true;
+        } else {
+            // the raw data is partially decoded and therefore unusable
+            content_.clear();
+            if (passing && (state != chunked_state::NEED_MORE_DATA)) {
+                reject_chunked_content(state);
+            } else {
+                state_ = lexer_state::error;
+            }
+        }
+
+        // remember, that fetch_chunked_content once returned true
+        fetch_content_succeeded_ = result;
+    }
+
+    return result;
+}
+
+bool lexer::read_content(buffer& data, const size_t max_size,
+                         const size_t length)
+{
+    bool result = false;
+    if ((state_ == lexer_state::reached_content) &&
+        (false == fetch_content_succeeded_) && (false == separate_content_) &&
+        (false == streaming_complete_)) {
+        streaming_ = true;
+
+        assert(streamed_length_ <= length);
+        const size_t remaining = length - streamed_length_;
+
+        // a pipelining client could have sent the next request already, which
+        // must not be part of this content
+        if ((data_end() - content_offset_) > remaining) {
+            pipelined_begin_ = content_offset_ + remaining;
+        }
+
+        size_t size = std::min(max_size, remaining);
+        if (size > 0) {
+            const size_t old_size = data.size();
+            if (content_offset_ < data_end()) {
+                // the data, that was received together with the header, is
+                // read first
+                size = std::min(size, data_end() - content_offset_);
+                take_content(data, size);
+                result = true;
+            } else {
+                result = connection_->receive(data, size);
+            }
+            streamed_length_ += data.size() - old_size;
+        }
+
+        streaming_complete_ = (streamed_length_ == length);
+    }
+
+    return result;
+}
+
+bool lexer::read_chunked_content(buffer& data, const size_t max_size,
+                                 const size_t max_length)
+{
+    bool result = false;
+    if ((state_ == lexer_state::reached_content) &&
+        (false == fetch_content_succeeded_) && (false == separate_content_) &&
+        (false == streaming_complete_) && (max_size > 0)) {
+        if (false == streaming_) {
+            decoder_.reset(max_length, limits_.max_header_length,
+                           limits_.max_header_count);
+            streaming_ = true;
+        }
+
+        const size_t old_size = data.size();
+        chunked_state state = chunked_state::NEED_MORE_DATA;
+
+        // the chunk framing decodes to nothing, therefore raw data is read
+        // till at least one byte was decoded
+        bool fetch_more = true;
+        while (fetch_more) {
+            // the raw data is decoded in place, which never needs more space
+            // than max_size, because the decoded data is never longer
+            bool received;
+            if (content_offset_ < data_.size()) {
+                take_content(data, std::min(max_size,
+                                            data_.size() - content_offset_));
+                received = true;
+            } else {
+                received = connection_->receive(data, max_size);
+            }
+
+            if (received) {
+                size_t head = old_size;
+                size_t tail = old_size;
+                state = decoder_.decode(data.data(), data.size(), head, tail);
+                if (state == chunked_state::FINISHED) {
+                    // the raw data beyond the content belongs to the next
+                    // request, which is still in the data buffer, when it was
+                    // taken from there and the buffer was not started over
+                    const size_t raw_remaining = data.size() - head;
+                    if (content_offset_ < data_.size()) {
+                        pipelined_begin_ = content_offset_ - raw_remaining;
+                    } else {
+                        keep_pipelined_data(
+                            data.begin() + static_cast<ssize_t>(head),
+                            data.end());
+                    }
+                    data.resize(tail);
+                } else if (state == chunked_state::NEED_MORE_DATA) {
+                    data.resize(tail);
+                } else {
+                    // the content is unusable and the connection could not
+                    // be used anymore, because the end of the content is
+                    // unknown
+                    data.resize(old_size);
+                    reject_chunked_content(state);
+                }
+            }
+
+            fetch_more = received && (state == chunked_state::NEED_MORE_DATA) &&
+                         (data.size() == old_size);
+        }
+
+        streamed_length_ += data.size() - old_size;
+        streaming_complete_ = (state == chunked_state::FINISHED);
+        result = (data.size() > old_size);
+    }
+
+    return result;
+}
+
+bool lexer::content_complete(void) const
+{
+    return fetch_content_succeeded_ || streaming_complete_;
+}
+
+buffer lexer::take_pipelined_data(void)
+{
+    buffer result;
+    if (false == pipelined_.empty()) {
+        result.swap(pipelined_);
+    } else if (pipelined_begin_ < data_.size()) {
+        result = buffer_pool::instance().borrow(data_.size() -
+                                                pipelined_begin_);
+        result.insert(result.end(),
+                      data_.begin() + static_cast<ssize_t>(pipelined_begin_),
+                      data_.end());
+        data_.resize(pipelined_begin_);
+    }
+    return result;
+}
+
+void lexer::reset(void)
+{
+    // the pipelined data is moved to the front of the data buffer, which
+    // keeps its capacity for the next header
+    if (false == pipelined_.empty()) {
+        data_.assign(pipelined_.begin(), pipelined_.end());
+        pipelined_.clear();
+    } else {
+        data_.erase(data_.begin(),
+                    data_.begin() + static_cast<ssize_t>(data_end()));
+    }
+    pipelined_begin_ = unknown_index;
+
+    // a large content buffer is not kept for all following requests
+    if (content_.capacity() > max_content_preallocation) {
+        buffer_pool::instance().give_back(std::move(content_));
+    }
+    content_.clear();
+
+    header_lines_ = 0;
+    rejection_status_ = http_status_code::OK;
+    state_ = lexer_state::copy;
+    header_length_ = 0;
+    content_begin_ = 0;
+    separate_content_ = false;
+    fetch_content_succeeded_ = false;
+    streaming_ = false;
+    streaming_complete_ = false;
+    content_offset_ = 0;
+    streamed_length_ = 0;
+    decoder_.reset(0, 0, 0);
+    index_ = 0;
+}
+
 int32_t lexer::get(void)
 {
     int32_t result;
-    if (index_ < header_.size()) {
+    if (index_ < header_length_) {
         // converting the character into an unsigned character first will
         // preserve the bit representation and enables the implementation to
         // reuse all negative numbers as error values
-        result = static_cast<uint8_t>(header_[index_++]);
+        result = static_cast<uint8_t>(data_[index_++]);
     } else {
         result = -1;
     }
@@ -141,16 +555,21 @@ size_t lexer::index(void) const
 void lexer::set_index(const size_t idx)
 {
     // set new index only when in range
-    if (idx <= header_.size()) {
+    if (idx <= header_length_) {
         index_ = idx;
     }
 }
 
+size_t lexer::header_length(void) const
+{
+    return header_length_;
+}
+
 const char_t* lexer::header_data(const size_t idx) const
 {
     const char_t* result;
-    if (idx < header_.size()) {
-        result = &(header_[idx]);
+    if (idx < header_length_) {
+        result = &(data_[idx]);
     } else {
         result = NULL;
     }
@@ -160,8 +579,8 @@ const char_t* lexer::header_data(const size_t idx) const
 char_t* lexer::header_data(const size_t idx)
 {
     char_t* result;
-    if (idx < header_.size()) {
-        result = &(header_[idx]);
+    if (idx < header_length_) {
+        result = &(data_[idx]);
     } else {
         result = NULL;
     }
@@ -172,7 +591,8 @@ const char_t* lexer::content(void) const
 {
     const char_t* result;
     if (fetch_content_succeeded_) {
-        result = &(content_[0]);
+        result = separate_content_ ? content_.data()
+                                   : (data_.data() + content_begin_);
     } else {
         result = NULL;
     }
@@ -183,16 +603,78 @@ size_t lexer::content_length(void) const
 {
     size_t result;
     if (fetch_content_succeeded_) {
-        result = content_.size();
+        result = separate_content_ ? content_.size()
+                                   : (data_end() - content_begin_);
     } else {
         result = 0;
     }
     return result;
 }
 
+void lexer::take_content(buffer& data, const size_t size)
+{
+    assert((content_offset_ + size) <= data_.size());
+    const buffer::const_iterator begin =
+        data_.begin() + static_cast<ssize_t>(content_offset_);
+    data.insert(data.end(), begin, begin + static_cast<ssize_t>(size));
+    content_offset_ += size;
+
+    // start over, when the buffered content was read completely to keep the
+    // data buffer from growing
+    if (content_offset_ == data_.size()) {
+        data_.resize(content_begin_);
+        content_offset_ = content_begin_;
+    }
+}
+
+void lexer::move_content_into_own_buffer(const size_t capacity)
+{
+    buffer_pool& pool = buffer_pool::instance();
+    pool.give_back(std::move(content_));
+    content_ = pool.borrow(capacity);
+    content_.insert(content_.end(),
+                    data_.begin() + static_cast<ssize_t>(content_begin_),
+                    data_.end());
+    data_.resize(content_begin_);
+    separate_content_ = true;
+}
+
+size_t lexer::data_end(void) const
+{
+    return std::min(pipelined_begin_, data_.size());
+}
+
+void lexer::keep_pipelined_data(const buffer::const_iterator begin,
+                                const buffer::const_iterator end)
+{
+    pipelined_begin_ = data_.size();
+    if (static_cast<ssize_t>(data_.capacity() - data_.size()) >=
+        (end - begin)) {
+        data_.insert(data_.end(), begin, end);
+    } else {
+        pipelined_.assign(begin, end);
+    }
+}
+
+void lexer::check_header_limits(const size_t tail, const size_t head)
+{
+    if ((state_ != lexer_state::reached_content) &&
+        (state_ != lexer_state::error)) {
+        // the tail contains the line break already, when the request line is
+        // complete but the next line was not yet started
+        if ((header_lines_ == 0) &&
+            (tail > (limits_.max_request_line_length + 1))) {
+            reject(http_status_code::REQUEST_URI_TOO_LONG);
+        } else if ((head > limits_.max_header_length) ||
+                   (header_lines_ > (limits_.max_header_count + 1))) {
+            reject(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE);
+        }
+    }
+}
+
 void lexer::fetch_header_step(size_t& tail, size_t& head, char_t& last)
 {
-    const char_t ch = header_[head];
+    const char_t ch = data_[head];
 
     switch (state_) {
     case lexer_state::copy:
@@ -207,14 +689,10 @@ void lexer::fetch_header_step(size_t& tail, size_t& head, char_t& last)
         fetch_header_possible_lws(tail, head, ch, last);
         break;
 
+    // also treat the end states as reason to crash, because the program will
+    // not get here in this case, because reaching them is a reason to break
+    // from the loops first
     case lexer_state::reached_content:
-        fetch_header_reached_content(tail, head);
-        break;
-
-    // also treat errors as reason to crash, because the only way to get in
-    // error state is when receive returns false
-    // the program will not get here in this case, because this is a reason to
-    // break from the outermost while loop first
     case lexer_state::error:
     default:
         assert(false);
@@ -229,7 +707,7 @@ void lexer::fetch_header_copy(size_t& tail, size_t& head, const char_t ch,
     head++;
 
     if (ch == '\r') {
-        header_[tail++] = '\n';
+        data_[tail++] = '\n';
         // delay updating the last character, because the last character is
         // necessary in the next state to determine transition into
         // lexer_state::possible_cr_lf
@@ -248,7 +726,7 @@ void lexer::fetch_header_copy(size_t& tail, size_t& head, const char_t ch,
         // update the last character here, because it is necessary to determine
         // the next state
         // copy also the character
-        header_[tail++] = ch;
+        data_[tail++] = ch;
         last = ch;
     }
 }
@@ -291,26 +769,15 @@ void lexer::fetch_header_possible_lws(size_t& tail, size_t& head,
         // the last character (newline) was already written and gets therefore
         // overwritten
         assert(tail > 0);
-        header_[tail - 1] = ' ';
+        data_[tail - 1] = ' ';
         last = ' ';
+    } else {
+        // the line ended, because it is not continued
+        header_lines_++;
     }
 
     // return to copying the stream
     state_ = lexer_state::copy;
 }
 
-void lexer::fetch_header_reached_content(size_t& tail, size_t& head)
-{
-    // found the content
-    // moving the remaining header data into the content data
-    content_.insert(content_.end(),
-                    header_.begin() + static_cast<ssize_t>(head),
-                    header_.end());
-    assert(tail <= header_.size());
-    header_.resize(tail);
-
-    // nothing more to be done, when body is reached
-    // the loop will break afterwards, because the end of the header is reached
-}
-
 } // namespace hutzn
@@ -19,11 +19,31 @@
 #ifndef LIBHUTZNOHMD_REQUEST_LEXER_HPP
 #define LIBHUTZNOHMD_REQUEST_LEXER_HPP
 
+#include <limits>
+
 #include "libhutznohmd/request.hpp"
+#include "request/chunked_decoder.hpp"
 
 namespace hutzn
 {
 
+//! Limits the memory, that is used by the header and the content of a request.
+struct header_limits {
+    //! Maximum number of bytes of the request line without the line break.
+    size_t max_request_line_length = 8192;
+
+    //! Maximum number of bytes of the whole header including the request line.
+    size_t max_header_length = 65536;
+
+    //! Maximum number of header fields.
+    size_t max_header_count = 100;
+
+    //! Maximum number of bytes of the content. It is the same limit as for the
+    //! value of the content length header field by default.
+    size_t max_content_length =
+        static_cast<size_t>(std::numeric_limits<int32_t>::max());
+};
+
 //! @brief Helps to parse a HTTP request.
 //!
 //! This class provides functionality to prepare the HTTP header for the parser.
@@ -31,7 +51,24 @@ namespace hutzn
 //! any character combination described as LWS by the HTTP standard with a
 //! space). This is all done within fetch_header. It stores the header and
 //! content data and gives access to them. Rewriting of the header data is
-//! possible.
+//! possible. The content is kept in the same buffer behind the header, as long
+//! as it fits, so that a small request needs only one buffer.
+//!
+//! The header is limited while it is received. A request exceeding these
+//! limits is rejected immediately by sending an error response. Therefore the
+//! header never takes more memory than allowed by the limits.
+//!
+//! The buffers are borrowed from the buffer pool of the thread to reuse their
+//! memory across requests.
+//!
+//! Clients are allowed to pipeline requests (sending the next request before
+//! the response of the current one was received). Therefore all bytes beyond
+//! the content are kept as pipelined data, which is the beginning of the next
+//! request on the same connection. They stay in the data buffer behind the
+//! request, as long as they fit into its capacity.
+//!
+//! The content could either be fetched as a whole or be read in parts as it
+//! arrives (streaming). Both modes could not be mixed for one request.
 class lexer
 {
 public:
@@ -39,26 +76,137 @@ public:
     //!
     //! Initializes all data structures.
     //! @param[in] connection Connection to use as data input.
-    explicit lexer(const connection_ptr& connection);
+    //! @param[in] limits     Limits of the header.
+    explicit lexer(const connection_ptr& connection,
+                   const header_limits& limits = header_limits());
+
+    //! @brief Constructs the lexer with data of a previous request.
+    //!
+    //! The pipelined data is lexed before anything more is received from the
+    //! connection.
+    //! @param[in] connection     Connection to use as data input.
+    //! @param[in] pipelined_data Data, that was already received from the
+    //!                           connection, but belongs to this request.
+    //! @param[in] limits         Limits of the header.
+    explicit lexer(const connection_ptr& connection, buffer&& pipelined_data,
+                   const header_limits& limits = header_limits());
+
+    //! @brief Gives the buffers back to the buffer pool of the thread.
+    ~lexer(void) noexcept(true);
+
+    explicit lexer(const lexer& rhs) = delete;
+    lexer& operator=(const lexer& rhs) = delete;
 
     //! @brief Reads the complete header.
     //!
-    //! Moves already read parts of the content to the content buffer. Call this
+    //! Keeps already read parts of the content behind the header. Call this
     //! method before using the lexer. Returns whether the header data was read
     //! and normalized successfully. This is no statement whether the header
-    //! data is valid.
+    //! data is valid. Returns also false, when the header exceeds the limits
+    //! and the request was rejected.
     //! @return True when reading was successful and false if not.
     bool fetch_header(void);
 
+    //! @brief Rejects the request.
+    //!
+    //! Sends a response with the status code and without content immediately.
+    //! The response asks the client to close the connection, because the rest
+    //! of the request could not be skipped reliably. Nothing more is read
+    //! afterwards.
+    //! @param[in] status Status code of the response.
+    void reject(const http_status_code status);
+
+    //! @brief Returns the status code, that was used to reject the request.
+    //!
+    //! @return Status code of the rejection or http_status_code::OK, when the
+    //!         request was not rejected.
+    http_status_code rejection_status(void) const;
+
+    //! @brief Returns the limits of the request.
+    //!
+    //! @return Limits, which were given on construction.
+    const header_limits& limits(void) const;
+
     //! @brief Reads the complete content from the connection.
     //!
     //! The length must be given to the function and the header must be fetched
     //! successfully first! Returns whether the content could be fetched
     //! completely. Returns also false, when the header was not fetched yet or
-    //! when the fetching failed.
+    //! when the fetching failed. Already received bytes beyond the length are
+    //! kept as pipelined data. Each received part of the content is passed to
+    //! the sink, when it is set. The content is passed from its beginning on
+    //! each call.
     //! @param[in] length Number of bytes to read from the connection.
+    //! @param[in] sink   Gets the parts of the content. Returning false stops
+    //!                   the fetching, which fails then.
     //! @return           True when reading was successful and false if not.
-    bool fetch_content(const size_t length);
+    bool fetch_content(const size_t length,
+                       const content_sink& sink = content_sink());
+
+    //! @brief Reads the complete content with chunked transfer-encoding.
+    //!
+    //! The header must be fetched successfully first! The content is decoded
+    //! while it is received, so that the content data contains the decoded
+    //! data only. Returns false, when the content is malformed, exceeds the
+    //! maximum length or could not be received completely. A malformed or too
+    //! large content is rejected, while its chunk extensions and trailer
+    //! fields are limited like the header. Already received bytes beyond the
+    //! content are kept as pipelined data. Each decoded part of the content is
+    //! passed to the sink, when it is set. The whole content is passed again,
+    //! when it was already fetched.
+    //! @param[in] max_length Maximum number of decoded bytes.
+    //! @param[in] sink       Gets the parts of the content. Returning false
+    //!                       stops the fetching, which fails then.
+    //! @return               True when reading was successful and false if not.
+    bool fetch_chunked_content(const size_t max_length,
+                               const content_sink& sink = content_sink());
+
+    //! @brief Reads the next part of the content from the connection.
+    //!
+    //! The header must be fetched successfully first! Appends at most max_size
+    //! bytes of the content to the data. Only the bytes, that were received
+    //! together with the header, are held by the lexer. Returns false, when
+    //! the content was already read completely, when receiving failed or when
+    //! the content was fetched as a whole before.
+    //! @param[in,out] data     Buffer to append the content to.
+    //! @param[in]     max_size Maximum number of bytes to append.
+    //! @param[in]     length   Length of the whole content.
+    //! @return                 True when at least one byte was appended.
+    bool read_content(buffer& data, const size_t max_size,
+                      const size_t length);
+
+    //! @brief Reads the next part of a content with chunked transfer-encoding.
+    //!
+    //! Works like read_content, but appends only decoded bytes. The content
+    //! gets rejected, when it is malformed or exceeds the maximum length.
+    //! @param[in,out] data       Buffer to append the content to.
+    //! @param[in]     max_size   Maximum number of bytes to append.
+    //! @param[in]     max_length Maximum number of decoded bytes of the whole
+    //!                           content.
+    //! @return                   True when at least one byte was appended.
+    bool read_chunked_content(buffer& data, const size_t max_size,
+                              const size_t max_length);
+
+    //! @brief Returns whether the content was fetched or read completely.
+    //!
+    //! @return True when the complete content was fetched or read.
+    bool content_complete(void) const;
+
+    //! @brief Returns the data, that was received beyond this request.
+    //!
+    //! It is the beginning of the next request on the connection and is
+    //! available after the content was fetched. The data is moved out of the
+    //! lexer, so that a second call returns an empty buffer.
+    //! @return Pipelined data, which is possibly empty.
+    buffer take_pipelined_data(void);
+
+    //! @brief Prepares the lexer for the next request on the same connection.
+    //!
+    //! The pipelined data becomes the beginning of the next request. The
+    //! buffers keep their capacity, except of a content buffer, which grew
+    //! larger than usual. The content has to be fetched or read completely
+    //! before, otherwise its rest is lexed as the next request.
+    void reset(void);
 
     //! @brief Returns the next token.
     //!
@@ -86,6 +234,12 @@ public:
     //! @param[in] idx Index to set.
     void set_index(const size_t idx);
 
+    //! @brief Returns the length of the normalized header.
+    //!
+    //! It is 0, when fetch_header was not yet successfully called.
+    //! @return Number of bytes in the header.
+    size_t header_length(void) const;
+
     //! @brief Returns a constant pointer on the header beginning at offset idx.
     //!
     //! It returns NULL, when the offset is out of scope.
@@ -113,6 +267,17 @@ public:
     size_t content_length(void) const;
 
 private:
+    //! @brief Appends size bytes of the content buffer to the data, that were
+    //! not yet read while streaming.
+    void take_content(buffer& data, const size_t size);
+
+    //! @brief Rejects the request, when the header exceeds one of the limits.
+    void check_header_limits(const size_t tail, const size_t head);
+
+    //! @brief Rejects the request with the status code matching the state of
+    //! the chunked decoder, which failed to decode the content.
+    void reject_chunked_content(const chunked_state state);
+
     //! @brief Steps the state machine of fetch_header one time.
     void fetch_header_step(size_t& tail, size_t& head, char_t& last);
 
@@ -130,9 +295,22 @@ private:
     void fetch_header_possible_lws(size_t& tail, size_t& head, const char_t ch,
                                    char_t& last);
 
-    //! @brief Called by the fetch_header state machine when in state
-    //! reached_content.
-    void fetch_header_reached_content(size_t& tail, size_t& head);
+    //! @brief Moves the content, that was received together with the header,
+    //! into the content buffer.
+    void move_content_into_own_buffer(const size_t capacity);
+
+    //! @brief Returns the index behind the data of this request in the data
+    //! buffer.
+    size_t data_end(void) const;
+
+    //! @brief Keeps the data of the next request, that was received into
+    //! another buffer.
+    //!
+    //! It is appended to the data buffer, as long as it fits into its
+    //! capacity, because growing the buffer would invalidate all pointers into
+    //! the header.
+    void keep_pipelined_data(const buffer::const_iterator begin,
+                             const buffer::const_iterator end);
 
     /*! @brief Defines a state machine for a HTTP lexer.
 
@@ -148,6 +326,8 @@ private:
     possible_cr_lf --> error : receive returns error
     possible_lws --> copy
     possible_lws --> error : receive returns error
+    copy --> error : header exceeds the limits
+    reached_content --> error : chunked content is malformed
     error --> [*]
     reached_content --> [*]
     @enduml
@@ -165,26 +345,72 @@ private:
         //! Final state when two LFs are at the tail.
         reached_content = 3,
 
-        //! Receive could return an error. Then this state is set.
+        //! Receive could return an error, the header could exceed the limits
+        //! or the chunked content could be malformed. Then this state is set.
         error = 4
     };
 
     //! Connection to read data from.
     connection_ptr connection_;
 
+    //! Limits of the header.
+    const header_limits limits_;
+
+    //! Number of completed lines of the header.
+    size_t header_lines_;
+
+    //! Status code used to reject the request.
+    http_status_code rejection_status_;
+
     //! Current state of the lexer.
     lexer_state state_;
 
-    //! Contains the header data. This data is partially reused as storage to
-    //! save heap space and allocation time.
-    buffer header_;
+    //! Contains the normalized header followed by the raw content. The header
+    //! is normalized in place to save heap space and allocation time. The
+    //! content stays in this buffer, as long as it fits into its capacity.
+    buffer data_;
+
+    //! Length of the normalized header.
+    size_t header_length_;
 
-    //! Contains the content data.
+    //! Index of the first content byte in the data buffer.
+    size_t content_begin_;
+
+    //! Contains the content data, when it does not fit into the data buffer.
     buffer content_;
 
+    //! True when the content is stored in the content buffer.
+    bool separate_content_;
+
+    //! Index of the data of the next request, that was received together with
+    //! this request. It is kept behind this request in the data buffer and is
+    //! not known before the end of the content was found.
+    size_t pipelined_begin_;
+
+    //! Contains the data of the next request, when it does not fit into the
+    //! data buffer.
+    buffer pipelined_;
+
     //! True when the fetch finished successfully.
     bool fetch_content_succeeded_;
 
+    //! True when the content is read in parts.
+    bool streaming_;
+
+    //! True when the content was read completely in parts.
+    bool streaming_complete_;
+
+    //! Index of the first byte in the data buffer, that was not yet read while
+    //! streaming.
+    size_t content_offset_;
+
+    //! Number of bytes of the content, that were already read while
+    //! streaming.
+    size_t streamed_length_;
+
+    //! Decodes a content with chunked transfer-encoding while streaming.
+    chunked_decoder decoder_;
+
     //! Current index.
     size_t index_;
 };
@@ -18,8 +18,7 @@
 
 #include "md5.hpp"
 
-#include <cassert>
-#include <cmath>
+#include <algorithm>
 
 #include "utility/common.hpp"
 
@@ -30,307 +29,458 @@ namespace
 {
 
 static const size_t block_size = 64;
-static const size_t processed_width_per_step = 16;
-static const size_t number_of_steps = block_size / processed_width_per_step;
-static const size_t a_idx_offset = 0;
-static const size_t b_idx_offset = 1;
-static const size_t c_idx_offset = 2;
-static const size_t d_idx_offset = 3;
+static const size_t words_per_block = 16;
+static const size_t digest_words = 4;
 
-//! Stores digest type, which is an intermediate result.
-using digest_type = std::array<uint32_t, number_of_steps>;
+//! Number of bytes, which store the size of the message at its end.
+static const size_t size_of_size = sizeof(uint64_t);
+
+//! Number of bytes of the padding blocks at the end of a message.
+static const size_t tail_size = 2 * block_size;
 
-//! Stores a table k.
-using table_k_type = std::array<uint32_t, block_size>;
+//! @brief Stores a word of each lane.
+//!
+//! The compiler maps its operations to the 128 bit vector instructions of the
+//! baseline instruction set (SSE2 or NEON). It falls back to scalar
+//! instructions, when the platform has no vector instructions.
+using lane_vector =
+    uint32_t __attribute__((vector_size(md5_lanes * sizeof(uint32_t))));
 
-//! A function pointer to f, g, h or i.
-using set_functor = uint32_t (*)(const uint32_t& a, const uint32_t& b,
-                                 const uint32_t& c, const uint32_t& d,
-                                 const uint32_t* x, const size_t& k,
-                                 const size_t& j, const uint8_t& s);
+//! Stores digest type, which is an intermediate result.
+template <typename word_type>
+using digest_type = std::array<word_type, digest_words>;
 
-//! @brief Defines a setting for a dword.
-struct dword_setting {
-    //! A number of indices, which are used to select an input data index for
-    //! a calculation.
-    std::array<size_t, processed_width_per_step> indices;
+//! Stores the words of a block.
+template <typename word_type>
+using block_type = std::array<word_type, words_per_block>;
 
-    //! Contains bit shift numbers, which are used by each step when rotating
-    //! the result of f, g, h and i.
-    std::array<uint8_t, number_of_steps> shifts;
+//! Stores the padding blocks at the end of a message.
+using tail_type = std::array<char_t, tail_size>;
 
-    //! Stores a function to f, g, h or i.
-    set_functor set_fn;
-};
+//! Initial value of the digest.
+static const digest_type<uint32_t> initial_digest = {
+    {0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U}};
 
-//! @brief Calculates an array of indices for use in dword_settings.
+//! @brief Rotates a value some bits left.
 //!
-//! These index arrays define a progression in a residue class ring.
-//! @param[in] seed Used initial index.
-//! @param[in] inc  Incrementation step.
-//! @param[in] mod  Modulus of incrementation.
-//! @return Array of indices.
-static std::array<size_t, processed_width_per_step> get_indice_array(
-    const size_t seed, const size_t inc, const size_t mod)
+//! The shifted out bits get inserted on the right. Works on a single word and
+//! on the words of all lanes.
+//! @param[in] x Value to rotate.
+//! @return      Rotated value.
+template <uint8_t bits, typename word_type>
+inline word_type rotate_left(const word_type x)
 {
-    std::array<size_t, processed_width_per_step> result;
-    size_t index = seed;
-    for (size_t i = 0; i < result.size(); i++) {
-        result[i] = index;
-        index = (index + inc) % mod;
-    }
-    assert(seed == index);
-    return result;
+    return (x << bits) | (x >> ((sizeof(uint32_t) * bits_per_byte) - bits));
 }
 
-//! @brief Calculates a table k.
+//! @brief Reads a little endian word of the input data.
 //!
-//! @return Table k.
-inline const table_k_type make_table_k()
+//! The compiler merges the byte accesses into a single load on little endian
+//! platforms. The data does not have to be aligned.
+//! @param[in] data Pointer to the first byte of the word.
+//! @return         Word in the byte order of the platform.
+inline uint32_t load_little_endian(const char_t* const data)
 {
-    static const uint64_t power =
-        static_cast<uint64_t>(1)
-        << (bits_per_byte * sizeof(table_k_type::value_type));
-
-    table_k_type result;
-    for (size_t i = 0; i < block_size; i++) {
-        result[i] = static_cast<uint32_t>(
-            std::floor(std::abs(std::sin(i + 1)) * power));
-    }
-    return result;
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(data);
+    return static_cast<uint32_t>(bytes[0]) |
+           (static_cast<uint32_t>(bytes[1]) << bits_per_byte) |
+           (static_cast<uint32_t>(bytes[2]) << (2 * bits_per_byte)) |
+           (static_cast<uint32_t>(bytes[3]) << (3 * bits_per_byte));
 }
 
-//! @brief Returns a specific value of table k.
+//! @brief Conforms to an operation with function f of md5 algorithm.
 //!
-//! The table k is lazy initialized, which means, that the first call will
-//! initialize it.
-//! @param[in] i Index to the value of table k.
-//! @return      Value of table k at index i.
-inline uint32_t get_value_of_k(const size_t i)
+//! The constant of table k and the number of bits to rotate left are template
+//! parameters, therefore they are part of the instructions.
+//! @param[in,out] a Value a, which gets replaced by the result.
+//! @param[in]     b Value b of function f.
+//! @param[in]     c Value c of function f.
+//! @param[in]     d Value d of function f.
+//! @param[in]     x Input data word.
+template <uint32_t k, uint8_t s, typename word_type>
+inline void step_f(word_type& a, const word_type b, const word_type c,
+                   const word_type d, const word_type x)
 {
-    static const table_k_type table_k = make_table_k();
-    return table_k[i];
+    // equal to (b & c) | ((~b) & d) with one operation less
+    const word_type f = d ^ (b & (c ^ d));
+    a = rotate_left<s>(a + f + x + k) + b;
 }
 
-//! @brief Rotates a value some bits left.
+//! @brief Conforms to an operation with function g of md5 algorithm.
 //!
-//! The shifted out bits get inserted on the right.
-//! @param[in] x    Value to rotate.
-//! @param[in] bits Number of bits to shift.
-//! @return         Rotated value.
-inline uint32_t rotate_left(const uint32_t& x, const uint8_t bits)
+//! @param[in,out] a Value a, which gets replaced by the result.
+//! @param[in]     b Value b of function g.
+//! @param[in]     c Value c of function g.
+//! @param[in]     d Value d of function g.
+//! @param[in]     x Input data word.
+template <uint32_t k, uint8_t s, typename word_type>
+inline void step_g(word_type& a, const word_type b, const word_type c,
+                   const word_type d, const word_type x)
 {
-    return (x << bits) | (x >> ((sizeof(x) * bits_per_byte) - bits));
+    // equal to (b & d) | (c & (~d)) with one operation less
+    const word_type g = c ^ (d & (b ^ c));
+    a = rotate_left<s>(a + g + x + k) + b;
 }
 
-//! @brief Conforms to function f of md5 algorithm.
+//! @brief Conforms to an operation with function h of md5 algorithm.
 //!
-//! @param[in] a Value a of function f.
-//! @param[in] b Value b of function f.
-//! @param[in] c Value c of function f.
-//! @param[in] d Value d of function f.
-//! @param[in] x Input data.
-//! @param[in] k Input data index.
-//! @param[in] j Index of table k.
-//! @param[in] s Number of bits to rotate left.
-//! @return      Result of function f.
-inline uint32_t set1(const uint32_t& a, const uint32_t& b, const uint32_t& c,
-                     const uint32_t& d, const uint32_t* x, const size_t& k,
-                     const size_t& j, const uint8_t& s)
+//! @param[in,out] a Value a, which gets replaced by the result.
+//! @param[in]     b Value b of function h.
+//! @param[in]     c Value c of function h.
+//! @param[in]     d Value d of function h.
+//! @param[in]     x Input data word.
+template <uint32_t k, uint8_t s, typename word_type>
+inline void step_h(word_type& a, const word_type b, const word_type c,
+                   const word_type d, const word_type x)
 {
-    const uint32_t f = (b & c) | ((~b) & d);
-    return rotate_left(a + f + x[k] + get_value_of_k(j), s) + b;
+    const word_type h = b ^ c ^ d;
+    a = rotate_left<s>(a + h + x + k) + b;
 }
 
-//! @brief Conforms to function g of md5 algorithm.
+//! @brief Conforms to an operation with function i of md5 algorithm.
 //!
-//! @param[in] a Value a of function g.
-//! @param[in] b Value b of function g.
-//! @param[in] c Value c of function g.
-//! @param[in] d Value d of function g.
-//! @param[in] x Input data.
-//! @param[in] k Input data index.
-//! @param[in] j Index of table k.
-//! @param[in] s Number of bits to rotate left.
-//! @return      Result of function g.
-inline uint32_t set2(const uint32_t& a, const uint32_t& b, const uint32_t& c,
-                     const uint32_t& d, const uint32_t* x, const size_t& k,
-                     const size_t& j, const uint8_t& s)
+//! @param[in,out] a Value a, which gets replaced by the result.
+//! @param[in]     b Value b of function i.
+//! @param[in]     c Value c of function i.
+//! @param[in]     d Value d of function i.
+//! @param[in]     x Input data word.
+template <uint32_t k, uint8_t s, typename word_type>
+inline void step_i(word_type& a, const word_type b, const word_type c,
+                   const word_type d, const word_type x)
 {
-    const uint32_t g = (b & d) | (c & (~d));
-    return rotate_left(a + g + x[k] + get_value_of_k(j), s) + b;
+    const word_type i = c ^ (b | (~d));
+    a = rotate_left<s>(a + i + x + k) + b;
 }
 
-//! @brief Conforms to function h of md5 algorithm.
+//! @brief Compresses one block.
 //!
-//! @param[in] a Value a of function h.
-//! @param[in] b Value b of function h.
-//! @param[in] c Value c of function h.
-//! @param[in] d Value d of function h.
-//! @param[in] x Input data.
-//! @param[in] k Input data index.
-//! @param[in] j Index of table k.
-//! @param[in] s Number of bits to rotate left.
-//! @return      Result of function h.
-inline uint32_t set3(const uint32_t& a, const uint32_t& b, const uint32_t& c,
-                     const uint32_t& d, const uint32_t* x, const size_t& k,
-                     const size_t& j, const uint8_t& s)
+//! All 64 operations are unrolled. The constants of table k are the integer
+//! parts of abs(sin(i + 1)) * 2^32 as defined by
+//! [RFC1321|http://tools.ietf.org/html/rfc1321]. The word type is either a
+//! single word or a vector of words of several independent messages.
+//! @param[in]     x      The words of the block.
+//! @param[in,out] result Is the digest before and the compressed block
+//!                       afterwards, which has to be added to the digest.
+template <typename word_type>
+void compress(const block_type<word_type>& x, digest_type<word_type>& result)
 {
-    const uint32_t h = b ^ c ^ d;
-    return rotate_left(a + h + x[k] + get_value_of_k(j), s) + b;
+    word_type a = result[0];
+    word_type b = result[1];
+    word_type c = result[2];
+    word_type d = result[3];
+
+    // round 1
+    step_f<0xD76AA478U, 7>(a, b, c, d, x[0]);
+    step_f<0xE8C7B756U, 12>(d, a, b, c, x[1]);
+    step_f<0x242070DBU, 17>(c, d, a, b, x[2]);
+    step_f<0xC1BDCEEEU, 22>(b, c, d, a, x[3]);
+    step_f<0xF57C0FAFU, 7>(a, b, c, d, x[4]);
+    step_f<0x4787C62AU, 12>(d, a, b, c, x[5]);
+    step_f<0xA8304613U, 17>(c, d, a, b, x[6]);
+    step_f<0xFD469501U, 22>(b, c, d, a, x[7]);
+    step_f<0x698098D8U, 7>(a, b, c, d, x[8]);
+    step_f<0x8B44F7AFU, 12>(d, a, b, c, x[9]);
+    step_f<0xFFFF5BB1U, 17>(c, d, a, b, x[10]);
+    step_f<0x895CD7BEU, 22>(b, c, d, a, x[11]);
+    step_f<0x6B901122U, 7>(a, b, c, d, x[12]);
+    step_f<0xFD987193U, 12>(d, a, b, c, x[13]);
+    step_f<0xA679438EU, 17>(c, d, a, b, x[14]);
+    step_f<0x49B40821U, 22>(b, c, d, a, x[15]);
+
+    // round 2
+    step_g<0xF61E2562U, 5>(a, b, c, d, x[1]);
+    step_g<0xC040B340U, 9>(d, a, b, c, x[6]);
+    step_g<0x265E5A51U, 14>(c, d, a, b, x[11]);
+    step_g<0xE9B6C7AAU, 20>(b, c, d, a, x[0]);
+    step_g<0xD62F105DU, 5>(a, b, c, d, x[5]);
+    step_g<0x02441453U, 9>(d, a, b, c, x[10]);
+    step_g<0xD8A1E681U, 14>(c, d, a, b, x[15]);
+    step_g<0xE7D3FBC8U, 20>(b, c, d, a, x[4]);
+    step_g<0x21E1CDE6U, 5>(a, b, c, d, x[9]);
+    step_g<0xC33707D6U, 9>(d, a, b, c, x[14]);
+    step_g<0xF4D50D87U, 14>(c, d, a, b, x[3]);
+    step_g<0x455A14EDU, 20>(b, c, d, a, x[8]);
+    step_g<0xA9E3E905U, 5>(a, b, c, d, x[13]);
+    step_g<0xFCEFA3F8U, 9>(d, a, b, c, x[2]);
+    step_g<0x676F02D9U, 14>(c, d, a, b, x[7]);
+    step_g<0x8D2A4C8AU, 20>(b, c, d, a, x[12]);
+
+    // round 3
+    step_h<0xFFFA3942U, 4>(a, b, c, d, x[5]);
+    step_h<0x8771F681U, 11>(d, a, b, c, x[8]);
+    step_h<0x6D9D6122U, 16>(c, d, a, b, x[11]);
+    step_h<0xFDE5380CU, 23>(b, c, d, a, x[14]);
+    step_h<0xA4BEEA44U, 4>(a, b, c, d, x[1]);
+    step_h<0x4BDECFA9U, 11>(d, a, b, c, x[4]);
+    step_h<0xF6BB4B60U, 16>(c, d, a, b, x[7]);
+    step_h<0xBEBFBC70U, 23>(b, c, d, a, x[10]);
+    step_h<0x289B7EC6U, 4>(a, b, c, d, x[13]);
+    step_h<0xEAA127FAU, 11>(d, a, b, c, x[0]);
+    step_h<0xD4EF3085U, 16>(c, d, a, b, x[3]);
+    step_h<0x04881D05U, 23>(b, c, d, a, x[6]);
+    step_h<0xD9D4D039U, 4>(a, b, c, d, x[9]);
+    step_h<0xE6DB99E5U, 11>(d, a, b, c, x[12]);
+    step_h<0x1FA27CF8U, 16>(c, d, a, b, x[15]);
+    step_h<0xC4AC5665U, 23>(b, c, d, a, x[2]);
+
+    // round 4
+    step_i<0xF4292244U, 6>(a, b, c, d, x[0]);
+    step_i<0x432AFF97U, 10>(d, a, b, c, x[7]);
+    step_i<0xAB9423A7U, 15>(c, d, a, b, x[14]);
+    step_i<0xFC93A039U, 21>(b, c, d, a, x[5]);
+    step_i<0x655B59C3U, 6>(a, b, c, d, x[12]);
+    step_i<0x8F0CCC92U, 10>(d, a, b, c, x[3]);
+    step_i<0xFFEFF47DU, 15>(c, d, a, b, x[10]);
+    step_i<0x85845DD1U, 21>(b, c, d, a, x[1]);
+    step_i<0x6FA87E4FU, 6>(a, b, c, d, x[8]);
+    step_i<0xFE2CE6E0U, 10>(d, a, b, c, x[15]);
+    step_i<0xA3014314U, 15>(c, d, a, b, x[6]);
+    step_i<0x4E0811A1U, 21>(b, c, d, a, x[13]);
+    step_i<0xF7537E82U, 6>(a, b, c, d, x[4]);
+    step_i<0xBD3AF235U, 10>(d, a, b, c, x[11]);
+    step_i<0x2AD7D2BBU, 15>(c, d, a, b, x[2]);
+    step_i<0xEB86D391U, 21>(b, c, d, a, x[9]);
+
+    result[0] = a;
+    result[1] = b;
+    result[2] = c;
+    result[3] = d;
 }
 
-//! @brief Conforms to function i of md5 algorithm.
+//! @brief Processes one block.
 //!
-//! @param[in] a Value a of function i.
-//! @param[in] b Value b of function i.
-//! @param[in] c Value c of function i.
-//! @param[in] d Value d of function i.
-//! @param[in] x Input data.
-//! @param[in] k Input data index.
-//! @param[in] j Index of table k.
-//! @param[in] s Number of bits to rotate left.
-//! @return      Result of function i.
-inline uint32_t set4(const uint32_t& a, const uint32_t& b, const uint32_t& c,
-                     const uint32_t& d, const uint32_t* x, const size_t& k,
-                     const size_t& j, const uint8_t& s)
+//! @param[in]     data   The data block to process.
+//! @param[in,out] digest The current digest result.
+void process(const char_t* const data, digest_type<uint32_t>& digest)
 {
-    const uint32_t i = c ^ (b | (~d));
-    return rotate_left(a + i + x[k] + get_value_of_k(j), s) + b;
+    block_type<uint32_t> x;
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = load_little_endian(data + (i * sizeof(uint32_t)));
+    }
+
+    digest_type<uint32_t> compressed = digest;
+    compress(x, compressed);
+
+    // add this to the digest
+    for (size_t i = 0; i < digest.size(); i++) {
+        digest[i] += compressed[i];
+    }
 }
 
-//! @brief Processes one step.
+//! @brief Processes one block of each lane.
 //!
-//! @param[out] digest          The current digest result.
-//! @param[in]  x               Input data block.
-//! @param[in]  beginning_index Start index of this step.
-//! @param[in]  settings        Settings to use for the step.
-void step_fn(digest_type& digest, const uint32_t* const x,
-             const size_t beginning_index, const dword_setting& settings)
+//! The digest of a lane, whose mask is zero, stays unchanged.
+//! @param[in]     blocks The data block of each lane.
+//! @param[in]     mask   All bits are set for the lanes to update.
+//! @param[in,out] digest The current digest results.
+void process_lanes(const std::array<const char_t*, md5_lanes>& blocks,
+                   const lane_vector mask, digest_type<lane_vector>& digest)
 {
-    for (size_t i = 0; i < processed_width_per_step; i += number_of_steps) {
-        for (size_t j = 0; j < number_of_steps; j++) {
-            const size_t idx = (number_of_steps - j) % number_of_steps;
-            uint32_t& a = digest[(idx + a_idx_offset) % number_of_steps];
-            uint32_t& b = digest[(idx + b_idx_offset) % number_of_steps];
-            uint32_t& c = digest[(idx + c_idx_offset) % number_of_steps];
-            uint32_t& d = digest[(idx + d_idx_offset) % number_of_steps];
-
-            a = settings.set_fn(a, b, c, d, x, settings.indices[i + j],
-                                beginning_index + i + j, settings.shifts[j]);
+    // each word of the block is gathered from all lanes
+    block_type<lane_vector> x;
+    for (size_t i = 0; i < x.size(); i++) {
+        for (size_t lane = 0; lane < md5_lanes; lane++) {
+            x[i][lane] =
+                load_little_endian(blocks[lane] + (i * sizeof(uint32_t)));
         }
     }
+
+    digest_type<lane_vector> compressed = digest;
+    compress(x, compressed);
+
+    // add this to the digest
+    for (size_t i = 0; i < digest.size(); i++) {
+        digest[i] += compressed[i] & mask;
+    }
 }
 
-//! @brief Processes one block.
+//! @brief Pads the end of a message.
 //!
-//! @param[in,out] data   The data block to process.
-//! @param[out]    digest The current digest result.
-void process(const char_t* data, digest_type& digest)
+//! @param[in]  rest      Bytes of the message behind its last complete block.
+//! @param[in]  rest_size Number of bytes behind the last complete block.
+//! @param[in]  size      Size of the whole message.
+//! @param[out] tail      Padding blocks.
+//! @return               Number of padding blocks, which is 1 or 2.
+size_t pad_tail(const char_t* const rest, const size_t rest_size,
+                const uint64_t size, tail_type& tail)
 {
-    static const std::array<dword_setting, number_of_steps> settings = {
-        {dword_setting{get_indice_array(0, 1, processed_width_per_step),
-                       {{7, 12, 17, 22}},
-                       &set1},
-         dword_setting{get_indice_array(1, 5, processed_width_per_step),
-                       {{5, 9, 14, 20}},
-                       &set2},
-         dword_setting{get_indice_array(5, 3, processed_width_per_step),
-                       {{4, 11, 16, 23}},
-                       &set3},
-         dword_setting{get_indice_array(0, 7, processed_width_per_step),
-                       {{6, 10, 15, 21}},
-                       &set4}}};
-
-    digest_type copy = digest;
-    const uint32_t* x = reinterpret_cast<const uint32_t*>(data);
-
-    // one process round consists of for steps, that are described in data
-    // above.
-    for (size_t i = 0; i < settings.size(); i++) {
-        step_fn(copy, x, processed_width_per_step * i, settings[i]);
+    static const uint8_t first_padding_byte = 0x80U;
+
+    // if there is not enough space to append the size, it is filled into
+    // another block
+    const size_t result = (rest_size < (block_size - size_of_size)) ? 1 : 2;
+    const size_t tail_end = result * block_size;
+    const size_t size_begin = tail_end - size_of_size;
+
+    std::copy(rest, rest + rest_size, tail.begin());
+    tail[rest_size] = static_cast<char_t>(first_padding_byte);
+    std::fill(tail.begin() + static_cast<ssize_t>(rest_size + 1),
+              tail.begin() + static_cast<ssize_t>(size_begin), 0);
+
+    // fill up the number of bits
+    const uint64_t processed_bits = size * bits_per_byte;
+    for (size_t i = 0; i < size_of_size; ++i) {
+        tail[size_begin + i] =
+            static_cast<char_t>(processed_bits >> (i * bits_per_byte));
     }
 
-    // add this to the digest
-    digest[a_idx_offset] += copy[a_idx_offset];
-    digest[b_idx_offset] += copy[b_idx_offset];
-    digest[c_idx_offset] += copy[c_idx_offset];
-    digest[d_idx_offset] += copy[d_idx_offset];
+    return result;
 }
 
-//! @brief Returns, whether the platform the code runs on is little endian.
+//! @brief Converts the digest into the byte order of the md5 sum.
 //!
-//! @return True, when the platform the code runs on is little endian and false
-//!         if not.
-bool is_little_endian()
+//! @param[in] digest Digest after processing the last block.
+//! @return           MD5 sum.
+md5_array to_md5_array(const digest_type<uint32_t>& digest)
 {
-    // endianess could be checked, by proving what gets written into the first
-    // byte of an 16 bit variable
-    static const uint16_t endianness_test_value = 1;
-    return (*reinterpret_cast<const uint8_t*>(&endianness_test_value)) == 1;
+    md5_array result;
+    for (size_t i = 0; i < result.size(); ++i) {
+        const size_t index = i / digest.size();
+        const size_t bits_to_shift = (i % digest.size()) * bits_per_byte;
+        result[i] = static_cast<uint8_t>(digest[index] >> bits_to_shift);
+    }
+    return result;
 }
 
-} // namespace
-
-md5_array calculate_md5(const char_t* const data, const size_t size)
+//! @brief Calculates the MD5 sums of at most md5_lanes messages.
+//!
+//! All lanes process their blocks in lockstep. A lane without any more blocks
+//! processes a block of zeros, which does not change its digest.
+//! @param[in]  data    Messages.
+//! @param[in]  sizes   Sizes of the messages.
+//! @param[in]  count   Number of messages.
+//! @param[out] digests MD5 sums of the messages.
+void calculate_md5_lanes(const char_t* const* const data,
+                         const size_t* const sizes, const size_t count,
+                         md5_array* const digests)
 {
-    assert(is_little_endian());
+    static const std::array<char_t, block_size> zero_block{};
+
+    std::array<tail_type, md5_lanes> tails;
+    std::array<size_t, md5_lanes> full_blocks;
+    std::array<size_t, md5_lanes> total_blocks;
+    size_t max_blocks = 0;
+    for (size_t lane = 0; lane < md5_lanes; lane++) {
+        if (lane < count) {
+            full_blocks[lane] = sizes[lane] / block_size;
+            const size_t rest_begin = full_blocks[lane] * block_size;
+            total_blocks[lane] =
+                full_blocks[lane] +
+                pad_tail(data[lane] + rest_begin, sizes[lane] - rest_begin,
+                         sizes[lane], tails[lane]);
+            max_blocks = std::max(max_blocks, total_blocks[lane]);
+        } else {
+            full_blocks[lane] = 0;
+            total_blocks[lane] = 0;
+        }
+    }
 
-    static const size_t size_of_size = sizeof(uint64_t);
-    static const size_t max_size_minus_size = block_size - size_of_size;
+    digest_type<lane_vector> digest;
+    for (size_t i = 0; i < digest.size(); i++) {
+        for (size_t lane = 0; lane < md5_lanes; lane++) {
+            digest[i][lane] = initial_digest[i];
+        }
+    }
 
-    digest_type digest{{0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U}};
-    const char_t* pointer = data;
-    size_t remaining = size;
+    for (size_t block = 0; block < max_blocks; block++) {
+        std::array<const char_t*, md5_lanes> blocks;
+        lane_vector mask;
+        for (size_t lane = 0; lane < md5_lanes; lane++) {
+            if (block < full_blocks[lane]) {
+                blocks[lane] = data[lane] + (block * block_size);
+            } else if (block < total_blocks[lane]) {
+                blocks[lane] = tails[lane].data() +
+                               ((block - full_blocks[lane]) * block_size);
+            } else {
+                blocks[lane] = zero_block.data();
+            }
+            mask[lane] = (block < total_blocks[lane]) ? 0xFFFFFFFFU : 0;
+        }
 
-    // process
-    while (remaining >= block_size) {
-        process(pointer, digest);
-        pointer += block_size;
-        remaining -= block_size;
+        process_lanes(blocks, mask, digest);
     }
 
-    // copy the rest
-    static const uint8_t invalid_last_bit = 0x80U;
-    std::array<char_t, block_size> data_buffer;
-    uint8_t last_bit = invalid_last_bit;
-    std::copy(data + size - static_cast<ssize_t>(remaining), data + size,
-              data_buffer.begin());
-
-    // if there is not enough space to append the size, we have to fill it into
-    // another block
-    if (remaining > (max_size_minus_size - 1)) {
-        std::fill(data_buffer.begin() + remaining, data_buffer.end(), 0);
-        data_buffer[remaining] = static_cast<char_t>(last_bit);
-        process(data_buffer.data(), digest);
-        last_bit = 0;
-        remaining = 0;
+    for (size_t lane = 0; lane < count; lane++) {
+        digest_type<uint32_t> lane_digest;
+        for (size_t i = 0; i < lane_digest.size(); i++) {
+            lane_digest[i] = digest[i][lane];
+        }
+        digests[lane] = to_md5_array(lane_digest);
     }
+}
 
-    // fill up the block till there are 8 bytes left for the size in bits
-    std::fill(data_buffer.begin() + remaining,
-              data_buffer.begin() + max_size_minus_size, 0);
-    data_buffer[remaining] = static_cast<char_t>(last_bit);
+} // namespace
 
-    // fill up the number of bits
-    const uint64_t processed_bits = size * bits_per_byte;
-    for (size_t i = 0; i < size_of_size; ++i) {
-        const size_t index = max_size_minus_size + i;
-        data_buffer[index] =
-            static_cast<char_t>(processed_bits >> (i * bits_per_byte));
+md5_context::md5_context(void)
+    : digest_(initial_digest)
+    , block_()
+    , block_length_(0)
+    , size_(0)
+{
+}
+
+void md5_context::update(const char_t* const data, const size_t size)
+{
+    size_t offset = 0;
+
+    // completes the block of the previous parts first
+    if (block_length_ > 0) {
+        offset = std::min(size, block_.size() - block_length_);
+        std::copy(data, data + offset, block_.begin() + block_length_);
+        block_length_ += offset;
+        if (block_length_ == block_.size()) {
+            process(block_.data(), digest_);
+            block_length_ = 0;
+        }
     }
 
-    // process last block
-    process(data_buffer.data(), digest);
+    // complete blocks are processed without copying them
+    while ((size - offset) >= block_.size()) {
+        process(data + offset, digest_);
+        offset += block_.size();
+    }
 
-    // return result
-    md5_array result;
-    for (size_t i = 0; i < result.size(); ++i) {
-        const size_t index = i / digest.size();
-        const size_t bits_to_shift = (i % digest.size()) * bits_per_byte;
-        result[i] = static_cast<uint8_t>(digest[index] >> bits_to_shift);
+    std::copy(data + offset, data + size, block_.begin() + block_length_);
+    block_length_ += size - offset;
+    size_ += size;
+}
+
+md5_array md5_context::finish(void)
+{
+    tail_type tail;
+    const size_t tail_blocks =
+        pad_tail(block_.data(), block_length_, size_, tail);
+    for (size_t i = 0; i < tail_blocks; i++) {
+        process(tail.data() + (i * block_size), digest_);
     }
+
+    const md5_array result = to_md5_array(digest_);
+    reset();
     return result;
 }
 
+void md5_context::reset(void)
+{
+    digest_ = initial_digest;
+    block_length_ = 0;
+    size_ = 0;
+}
+
+md5_array calculate_md5(const char_t* const data, const size_t size)
+{
+    md5_context context;
+    context.update(data, size);
+    return context.finish();
+}
+
+void calculate_md5(const char_t* const* const data, const size_t* const sizes,
+                   const size_t count, md5_array* const digests)
+{
+    for (size_t offset = 0; offset < count; offset += md5_lanes) {
+        calculate_md5_lanes(data + offset, sizes + offset,
+                            std::min(md5_lanes, count - offset),
+                            digests + offset);
+    }
+}
+
 } // namespace hutzn
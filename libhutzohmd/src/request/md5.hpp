@@ -35,12 +35,74 @@ using md5_array = std::array<uint8_t, md5_size>;
 
 //! @brief Calculates the MD5 sum of a given vector of bytes.
 //!
+//! Equal to a single update of an @ref md5_context followed by finish.
 //! @param[in] data Pointer to the data to calculate.
 //! @param[in] size Size of the data.
 //! @return         Array of 16 bytes, that contains the digest.
-//! @warning        This currently works only on little endian architectures.
 md5_array calculate_md5(const char_t* const data, const std::size_t size);
 
+//! @brief Calculates the MD5 sum of a message, which arrives in parts.
+//!
+//! Complete blocks are processed as soon as they are available, so that
+//! hashing overlaps with receiving or sending the message and needs no second
+//! pass over the whole message. Only an incomplete block is buffered between
+//! two updates.
+class md5_context
+{
+public:
+    //! Starts a new message.
+    md5_context(void);
+
+    //! @brief Appends a part of the message.
+    //!
+    //! @param[in] data Pointer to the part of the message.
+    //! @param[in] size Size of the part.
+    void update(const char_t* const data, const std::size_t size);
+
+    //! @brief Pads the message and returns its MD5 sum.
+    //!
+    //! The context starts a new message afterwards.
+    //! @return Array of 16 bytes, that contains the digest.
+    md5_array finish(void);
+
+    //! Discards all parts of the message and starts a new one.
+    void reset(void);
+
+private:
+    //! Number of bytes in a block, which is the unit of the md5 algorithm.
+    static const std::size_t block_size = 64;
+
+    //! Digest of all complete blocks processed so far.
+    std::array<uint32_t, 4> digest_;
+
+    //! Stores the bytes of the incomplete block.
+    std::array<char_t, block_size> block_;
+
+    //! Number of bytes in the incomplete block.
+    std::size_t block_length_;
+
+    //! Size of the message so far.
+    uint64_t size_;
+};
+
+//! Number of messages, which are hashed at once by the multi-message variant
+//! of calculate_md5.
+static const std::size_t md5_lanes = 4;
+
+//! @brief Calculates the MD5 sums of many independent messages.
+//!
+//! The messages are hashed in groups of md5_lanes messages. All messages of a
+//! group are processed together in vector registers (SSE, NEON or scalar
+//! registers as available), which multiplies the throughput for many small
+//! messages compared to hashing them one after another.
+//! @param[in]  data    Pointers to the messages.
+//! @param[in]  sizes   Sizes of the messages.
+//! @param[in]  count   Number of messages.
+//! @param[out] digests Array of count digests.
+void calculate_md5(const char_t* const* const data,
+                   const std::size_t* const sizes, const std::size_t count,
+                   md5_array* const digests);
+
 } // namespace hutzn
 
 #endif // LIBHUTZNOHMD_REQUEST_MD5_HPP
@@ -20,14 +20,14 @@
 
 #include <cassert>
 #include <cstring>
-#include <limits>
 
 #include "request/base64.hpp"
 #include "request/md5.hpp"
 #include "request/mime_handler.hpp"
 #include "request/timestamp.hpp"
+#include "utility/character_validation.hpp"
+#include "utility/keyword_table.hpp"
 #include "utility/parsing.hpp"
-#include "utility/trie.hpp"
 
 namespace hutzn
 {
@@ -35,116 +35,242 @@ namespace hutzn
 namespace
 {
 
-static const size_t trie_string_max_length = 16;
-
-static trie<http_verb> get_method_trie(size_t& max_size)
+//! Number of bytes to read at once, when streaming or skipping the content.
+static const size_t content_part_size = 4096;
+
+//! @brief Decodes a word of the query string in place.
+//!
+//! The word ends at the separator, at an ampersand or at the end of the query
+//! string. Percent-encoded characters and plus signs are decoded and the word
+//! gets null-terminated. The query string must have been validated by the uri
+//! before.
+//! @param[in,out] data      Points to the begin of the word and afterwards
+//!                          behind its end.
+//! @param[in] separator     Additional character, that ends the word.
+//! @param[in,out] word_hash Case-sensitive hash of the decoded word.
+//! @param[out] word_length  Length of the decoded word.
+//! @return                  Character, that has ended the word.
+static char_t decode_query_word(char_t*& data, const char_t separator,
+                                uint32_t& word_hash, size_t& word_length)
 {
-    trie<http_verb> result{true};
+    static const uint8_t char_encoding_size = 3;
+
+    // the decoded word is never longer than the encoded one
+    char_t* const word = data;
+    char_t* destination = data;
+    while (('\0' != *data) && ('&' != *data) && (separator != *data)) {
+        char_t ch = *data;
+        if ('%' == ch) {
+            ch = static_cast<char_t>(static_cast<uint8_t>(
+                (from_hex(data[1]) << nibble_size) + from_hex(data[2])));
+            data += char_encoding_size;
+        } else {
+            if ('+' == ch) {
+                ch = ' ';
+            }
+            data++;
+        }
 
-    // filling methods and automatically calculate the maximum length
-    max_size = 0;
-    const std::vector<std::pair<const char_t* const, http_verb>> verbs = {
-        std::make_pair("GET", http_verb::GET),
-        std::make_pair("PUT", http_verb::PUT),
-        std::make_pair("DELETE", http_verb::DELETE),
-        std::make_pair("POST", http_verb::POST)};
-    for (const std::pair<const char_t* const, http_verb>& pair : verbs) {
-        result.insert(pair.first, pair.second);
-        max_size =
-            std::max(max_size, ::strnlen(pair.first, trie_string_max_length));
+        word_hash = key_value_table::hash_step(word_hash, ch, true);
+        *destination = ch;
+        destination++;
     }
 
+    // the character has to be read before the null-termination overwrites it
+    const char_t result = *data;
+    *destination = '\0';
+    word_length = static_cast<size_t>(destination - word);
+    if ('\0' != result) {
+        data++;
+    }
     return result;
 }
 
-static trie<http_version> get_version_trie(size_t& max_size)
+//! @brief Reads a word from possibly unaligned memory.
+//!
+//! Comparing whole words instead of single characters needs one instruction
+//! per word. The compiler replaces the copy with a single load.
+template <typename word_type>
+static word_type load_word(const char_t* const data)
 {
-    trie<http_version> result{true};
-
-    // filling versions and automatically calculate the maximum length
-    max_size = 0;
-    const std::vector<std::pair<const char_t* const, http_version>> methods = {
-        std::make_pair("HTTP/1.0", http_version::HTTP_1_0),
-        std::make_pair("HTTP/1.1", http_version::HTTP_1_1),
-        std::make_pair("HTTP/2", http_version::HTTP_2)};
-    for (const std::pair<const char_t* const, http_version>& pair : methods) {
-        result.insert(pair.first, pair.second);
-        max_size =
-            std::max(max_size, ::strnlen(pair.first, trie_string_max_length));
-    }
-
+    word_type result;
+    ::memcpy(&result, data, sizeof(result));
     return result;
 }
 
-static trie<header_key> get_header_key_trie(size_t& max_size)
+//! Length of a version in the request line, which could be matched as one word.
+static const size_t version_length = sizeof(uint64_t);
+
+//! @brief Matches the method at the begin of a request line by comparing
+//! words.
+//!
+//! Only the upper-case methods followed by a single space are recognized. The
+//! data has to be at least as long as a 64 bit word.
+//! @param[in] data    Begin of the request line.
+//! @param[out] method Recognized method. It is unchanged, when nothing was
+//!                    recognized.
+//! @return            Length of the method or 0, when it was not recognized.
+static size_t match_method(const char_t* const data, http_verb& method)
 {
-    trie<header_key> result{true};
-
-    // filling versions and automatically calculate the maximum length
-    max_size = 0;
-    const std::vector<std::pair<const char_t* const, header_key>> header_keys =
-        {std::make_pair("accept", header_key::ACCEPT),
-         std::make_pair("connection", header_key::CONNECTION),
-         std::make_pair("content-length", header_key::CONTENT_LENGTH),
-         std::make_pair("content-md5", header_key::CONTENT_MD5),
-         std::make_pair("content-type", header_key::CONTENT_TYPE),
-         std::make_pair("date", header_key::DATE),
-         std::make_pair("from", header_key::FROM),
-         std::make_pair("host", header_key::HOST),
-         std::make_pair("referer", header_key::REFERER),
-         std::make_pair("user-agent", header_key::USER_AGENT)};
-    for (const std::pair<const char_t* const, header_key>& pair : header_keys) {
-        result.insert(pair.first, pair.second);
-        max_size =
-            std::max(max_size, ::strnlen(pair.first, trie_string_max_length));
+    static const size_t short_method_length = 3;
+    static const size_t long_method_length = 4;
+    static const size_t delete_length = 6;
+
+    size_t result = 0;
+    const uint32_t word = load_word<uint32_t>(data);
+    if (load_word<uint32_t>("GET ") == word) {
+        method = http_verb::GET;
+        result = short_method_length;
+    } else if (load_word<uint32_t>("PUT ") == word) {
+        method = http_verb::PUT;
+        result = short_method_length;
+    } else if ((load_word<uint32_t>("POST") == word) &&
+               (' ' == data[long_method_length])) {
+        method = http_verb::POST;
+        result = long_method_length;
+    } else if ((load_word<uint32_t>("DELE") == word) &&
+               (load_word<uint16_t>("TE") ==
+                load_word<uint16_t>(data + long_method_length)) &&
+               (' ' == data[delete_length])) {
+        method = http_verb::DELETE;
+        result = delete_length;
     }
-
     return result;
 }
 
-template <typename T>
-bool parse_specific_value(const trie<T>& t, const size_t& max_length,
-                          const char_t* const string, const size_t& length,
-                          T& value)
+//! @brief Matches the version at the end of a request line by comparing one
+//! word.
+//!
+//! @param[in] data     Begin of the version.
+//! @param[out] version Recognized version. It is unchanged, when nothing was
+//!                     recognized.
+//! @return             True when the version was recognized.
+static bool match_version(const char_t* const data, http_version& version)
 {
-    bool result = false;
-
-    // parsing the value will succeed, when the token is not too long and the
-    // found value length is exactly the token length
-    if (length <= max_length) {
-        auto r = t.find(string, length);
-        if (r.used_size() == length) {
-            value = r.value();
-            result = true;
-        }
+    bool result = true;
+    const uint64_t word = load_word<uint64_t>(data);
+    if (load_word<uint64_t>("HTTP/1.1") == word) {
+        version = http_version::HTTP_1_1;
+    } else if (load_word<uint64_t>("HTTP/1.0") == word) {
+        version = http_version::HTTP_1_0;
+    } else {
+        result = false;
     }
-
     return result;
 }
 
+//! Request methods.
+static constexpr keyword_table<http_verb, 4> methods{
+    {{{"get", http_verb::GET},
+      {"put", http_verb::PUT},
+      {"delete", http_verb::DELETE},
+      {"post", http_verb::POST}}}};
+
+//! HTTP versions.
+static constexpr keyword_table<http_version, 3> versions{
+    {{{"http/1.0", http_version::HTTP_1_0},
+      {"http/1.1", http_version::HTTP_1_1},
+      {"http/2", http_version::HTTP_2}}}};
+
+//! Header field names, which are handled by the request itself.
+static constexpr keyword_table<header_key, 13> header_keys{
+    {{{"accept", header_key::ACCEPT},
+      {"connection", header_key::CONNECTION},
+      {"content-digest", header_key::CONTENT_DIGEST},
+      {"content-length", header_key::CONTENT_LENGTH},
+      {"content-md5", header_key::CONTENT_MD5},
+      {"content-type", header_key::CONTENT_TYPE},
+      {"date", header_key::DATE},
+      {"expect", header_key::EXPECT},
+      {"from", header_key::FROM},
+      {"host", header_key::HOST},
+      {"referer", header_key::REFERER},
+      {"transfer-encoding", header_key::TRANSFER_ENCODING},
+      {"user-agent", header_key::USER_AGENT}}}};
+
 } // namespace
 
 memory_allocating_request::memory_allocating_request(
-    const connection_ptr& connection)
-    : lexer_(connection)
+    const connection_ptr& connection, const header_limits& limits,
+    std::pmr::memory_resource* const resource,
+    parsed_head_cache* const head_cache)
+    : lexer_(connection, limits)
+    , head_cache_(head_cache)
+    , method_(http_verb::GET)
+    , path_uri_()
+    , version_(http_version::HTTP_UNKNOWN)
+    , accept_()
+    , accept_string_(NULL)
+    , accept_length_(0)
+    , is_accept_parsed_(false)
+    , content_length_(0)
+    , is_content_length_set_(false)
+    , content_md5_(NULL)
+    , content_md5_length_(0)
+    , content_md5_context_()
+    , content_digest_()
+    , content_type_(mime_type::INVALID, mime_subtype::INVALID)
+    , content_type_value_()
+    , content_(NULL)
+    , host_uri_()
+    , is_keep_alive_set_(false)
+    , date_string_(NULL)
+    , date_length_(0)
+    , date_(0)
+    , is_date_parsed_(false)
+    , expect_(http_expectation::UNKNOWN)
+    , from_()
+    , referer_()
+    , is_chunked_(false)
+    , is_transfer_encoding_set_(false)
+    , transfer_coding_status_(http_status_code::OK)
+    , user_agent_()
+    , header_fields_(false, resource)
+    , query_entries_(true, resource)
+    , is_query_parsed_(false)
+    , registered_header_values_()
+{
+}
+
+memory_allocating_request::memory_allocating_request(
+    const connection_ptr& connection, buffer&& pipelined_data,
+    const header_limits& limits, std::pmr::memory_resource* const resource,
+    parsed_head_cache* const head_cache)
+    : lexer_(connection, std::move(pipelined_data), limits)
+    , head_cache_(head_cache)
     , method_(http_verb::GET)
     , path_uri_()
     , version_(http_version::HTTP_UNKNOWN)
     , accept_()
+    , accept_string_(NULL)
+    , accept_length_(0)
+    , is_accept_parsed_(false)
     , content_length_(0)
+    , is_content_length_set_(false)
     , content_md5_(NULL)
     , content_md5_length_(0)
+    , content_md5_context_()
+    , content_digest_()
     , content_type_(mime_type::INVALID, mime_subtype::INVALID)
+    , content_type_value_()
     , content_(NULL)
     , host_uri_()
     , is_keep_alive_set_(false)
+    , date_string_(NULL)
+    , date_length_(0)
     , date_(0)
+    , is_date_parsed_(false)
     , expect_(http_expectation::UNKNOWN)
-    , from_(NULL)
-    , referer_(NULL)
-    , user_agent_(NULL)
-    , header_fields_()
-    , query_entries_()
+    , from_()
+    , referer_()
+    , is_chunked_(false)
+    , is_transfer_encoding_set_(false)
+    , transfer_coding_status_(http_status_code::OK)
+    , user_agent_()
+    , header_fields_(false, resource)
+    , query_entries_(true, resource)
+    , is_query_parsed_(false)
+    , registered_header_values_()
 {
 }
 
@@ -153,50 +279,218 @@ bool memory_allocating_request::parse(const mime_handler& handler)
     bool result = false;
 
     const bool fetch_result = lexer_.fetch_header();
-    int32_t ch = lexer_.get();
-    if (fetch_result && parse_method(ch) && parse_uri(ch) &&
-        parse_version(ch)) {
-        ch = lexer_.get();
-        while (ch >= 0) {
-            if (is_newline(ch)) {
-                result = true;
-                break;
-            }
-
-            if (parse_header(handler, ch)) {
-                ch = lexer_.get();
-            }
+    if (fetch_result) {
+        result = (NULL != head_cache_) ? parse_cached_head(handler)
+                                       : parse_head(handler, NULL);
+
+        if (false == result) {
+            // a complete header, that could not be parsed, is malformed
+            lexer_.reject(http_status_code::BAD_REQUEST);
+        } else if (is_transfer_encoding_set_ && (false == is_chunked_)) {
+            // the end of the content could not be determined reliably, when
+            // chunked is not the last transfer coding (RFC 9112 section 6.3)
+            lexer_.reject(http_status_code::BAD_REQUEST);
+            result = false;
+        } else if (transfer_coding_status_ != http_status_code::OK) {
+            lexer_.reject(transfer_coding_status_);
+            result = false;
+        } else if ((false == is_chunked_) &&
+                   (content_length_ > lexer_.limits().max_content_length)) {
+            // a too large content is rejected before receiving any of it
+            lexer_.reject(http_status_code::REQUEST_ENTITY_TOO_LARGE);
+            result = false;
+        } else if (is_chunked_) {
+            // a chunked content overrides the content length
+            content_length_ = 0;
         }
     }
 
     return result;
 }
 
+http_status_code memory_allocating_request::rejection_status(void) const
+{
+    return lexer_.rejection_status();
+}
+
 bool memory_allocating_request::fetch_content(void)
 {
     bool result = true;
 
-    const size_t length = content_length();
-    if ((length > 0) && (lexer_.fetch_content(length))) {
-        content_ = lexer_.content();
+    // the sums are calculated, while the content is received
+    bool hashed = false;
+    const content_sink sink = [this, &hashed](const char_t* const data,
+                                              const size_t size) {
+        hashed = true;
+        if (NULL != content_md5_) {
+            content_md5_context_.update(data, size);
+        }
+        if (false == content_digest_.empty()) {
+            content_digest_.update(data, size);
+        }
+        return true;
+    };
+
+    if (is_chunked_) {
+        // the length of a chunked content is known after decoding it and any
+        // content length header field is ignored in this case
+        const size_t max_length = lexer_.limits().max_content_length;
+        if (lexer_.fetch_chunked_content(max_length, sink)) {
+            content_length_ = lexer_.content_length();
+            content_ = lexer_.content();
+        } else {
+            content_length_ = 0;
+            content_ = NULL;
+            result = false;
+        }
+    } else if (content_length_ > 0) {
+        // the content could not be fetched, when it is incomplete or was read
+        // in parts before
+        result = lexer_.fetch_content(content_length_, sink);
+        content_ = result ? lexer_.content() : NULL;
     }
 
-    if (NULL != content_md5_) {
-        md5_array md5_sum = calculate_md5(static_cast<const char_t*>(content_),
-                                          content_length_);
-        std::vector<uint8_t> expected_md5_sum =
-            decode_base64(content_md5_, content_md5_length_);
-        const bool md5_sum_valid = std::equal(md5_sum.begin(), md5_sum.end(),
-                                              expected_md5_sum.begin());
-        if (!md5_sum_valid) {
+    if (result) {
+        // the sums are verified, whenever they are present, because a content,
+        // which is not available, does not match them
+        if (NULL != content_md5_) {
+            result = is_content_md5_valid(content_md5_context_.finish());
+        }
+        if (false == content_digest_.empty()) {
+            result = content_digest_.verify() && result;
+        }
+        if (false == result) {
             content_ = NULL;
-            result = false;
         }
+    } else if (hashed) {
+        // a repeated call passes the content from its beginning again
+        content_md5_context_.reset();
+        content_digest_.restart();
     }
 
     return result;
 }
 
+bool memory_allocating_request::read_some(buffer& data, const size_t max_size)
+{
+    const size_t previous_size = data.size();
+    bool result;
+    if (is_chunked_) {
+        result = lexer_.read_chunked_content(
+            data, max_size, lexer_.limits().max_content_length);
+    } else {
+        result = lexer_.read_content(data, max_size, content_length_);
+    }
+
+    if (result && (NULL != content_md5_)) {
+        // only the appended bytes are hashed
+        content_md5_context_.update(data.data() + previous_size,
+                                    data.size() - previous_size);
+    }
+    if (result && (false == content_digest_.empty())) {
+        content_digest_.update(data.data() + previous_size,
+                               data.size() - previous_size);
+    }
+    return result;
+}
+
+bool memory_allocating_request::stream_content(const content_sink& sink)
+{
+    bool result = true;
+
+    // the same buffer is reused for each part
+    buffer data;
+    data.reserve(content_part_size);
+    while (result && read_some(data, content_part_size)) {
+        result = sink(data.data(), data.size());
+        data.clear();
+    }
+
+    result = result && lexer_.content_complete();
+    if (result && (NULL != content_md5_)) {
+        result = is_content_md5_valid(content_md5_context_.finish());
+    }
+    if (result && (false == content_digest_.empty())) {
+        result = content_digest_.verify();
+    }
+    return result;
+}
+
+buffer memory_allocating_request::take_pipelined_data(void)
+{
+    skip_content();
+    return lexer_.take_pipelined_data();
+}
+
+void memory_allocating_request::reset(void)
+{
+    skip_content();
+    lexer_.reset();
+
+    method_ = http_verb::GET;
+    path_uri_.reset();
+    version_ = http_version::HTTP_UNKNOWN;
+    content_length_ = 0;
+    is_content_length_set_ = false;
+    content_md5_ = NULL;
+    content_md5_length_ = 0;
+    content_md5_context_.reset();
+    content_digest_.reset();
+    content_type_ = mime(mime_type::INVALID, mime_subtype::INVALID);
+    content_type_value_ = std::string_view();
+    content_ = NULL;
+    host_uri_.reset();
+    is_keep_alive_set_ = false;
+    accept_string_ = NULL;
+    accept_length_ = 0;
+    is_accept_parsed_ = false;
+    date_string_ = NULL;
+    date_length_ = 0;
+    date_ = 0;
+    is_date_parsed_ = false;
+    expect_ = http_expectation::UNKNOWN;
+    from_ = std::string_view();
+    referer_ = std::string_view();
+    is_chunked_ = false;
+    is_transfer_encoding_set_ = false;
+    transfer_coding_status_ = http_status_code::OK;
+    user_agent_ = std::string_view();
+    header_fields_.clear();
+    query_entries_.clear();
+    is_query_parsed_ = false;
+    registered_header_values_.fill(NULL);
+}
+
+void memory_allocating_request::skip_content(void)
+{
+    // the content precedes the next request and is skipped part by part,
+    // which does nothing when it was already fetched or read completely
+    buffer skipped;
+    while (read_some(skipped, content_part_size)) {
+        skipped.clear();
+    }
+}
+
+bool memory_allocating_request::is_content_md5_valid(
+    const md5_array& md5_sum) const
+{
+    // a longer value could not contain a md5 sum, which is therefore not
+    // decoded at all
+    bool result = (content_md5_length_ <= base64_encoded_size(md5_size));
+    if (result) {
+        std::array<uint8_t, base64_decoded_max_size(base64_encoded_size(
+                                md5_size))>
+            expected_md5_sum;
+        size_t decoded_size = 0;
+        result = decode_base64(content_md5_, content_md5_length_,
+                               expected_md5_sum.data(), decoded_size) &&
+                 (decoded_size == md5_sum.size()) &&
+                 std::equal(md5_sum.begin(), md5_sum.end(),
+                            expected_md5_sum.begin());
+    }
+    return result;
+}
+
 http_verb memory_allocating_request::method(void) const
 {
     return method_;
@@ -204,37 +498,59 @@ http_verb memory_allocating_request::method(void) const
 
 const char_t* memory_allocating_request::path(void) const
 {
-    const char_t* result = path_uri_.path();
-    if (NULL == result) {
-        result = host_uri_.path();
+    return path_view().data();
+}
+
+std::string_view memory_allocating_request::path_view(void) const
+{
+    std::string_view result = path_uri_.path_view();
+    if (NULL == result.data()) {
+        result = host_uri_.path_view();
     }
     return result;
 }
 
 const char_t* memory_allocating_request::host(void) const
 {
-    const char_t* result = path_uri_.host();
-    if (NULL == result) {
-        result = host_uri_.host();
+    return host_view().data();
+}
+
+std::string_view memory_allocating_request::host_view(void) const
+{
+    std::string_view result = path_uri_.host_view();
+    if (NULL == result.data()) {
+        result = host_uri_.host_view();
     }
     return result;
 }
 
 const char_t* memory_allocating_request::query(const char_t* const key) const
 {
-    const char_t* result = NULL;
-    auto it = query_entries_.find(key);
-    if (it != query_entries_.end()) {
-        result = it->second;
+    return query_view(key).data();
+}
+
+std::string_view memory_allocating_request::query_view(
+    const char_t* const key) const
+{
+    // most requests do not use any query entry, therefore they are parsed, when
+    // they are needed for the first time
+    if (false == is_query_parsed_) {
+        parse_query();
+        is_query_parsed_ = true;
     }
-    return result;
+    return query_entries_.find_view(key);
 }
 
 const char_t* memory_allocating_request::fragment(void) const
 {
-    const char_t* result = path_uri_.fragment();
-    if (NULL == result) {
-        result = host_uri_.fragment();
+    return fragment_view().data();
+}
+
+std::string_view memory_allocating_request::fragment_view(void) const
+{
+    std::string_view result = path_uri_.fragment_view();
+    if (NULL == result.data()) {
+        result = host_uri_.fragment_view();
     }
     return result;
 }
@@ -246,22 +562,47 @@ http_version memory_allocating_request::version(void) const
 
 const char_t* memory_allocating_request::header_value(
     const char_t* const name) const
+{
+    return header_fields_.find(name);
+}
+
+std::string_view memory_allocating_request::header_value_view(
+    const char_t* const name) const
+{
+    return header_fields_.find_view(name);
+}
+
+const char_t* memory_allocating_request::registered_header_value(
+    const custom_header_id id) const
 {
     const char_t* result = NULL;
-    auto it = header_fields_.find(name);
-    if (it != header_fields_.end()) {
-        result = it->second;
+    if (id < registered_header_values_.size()) {
+        result = registered_header_values_[id];
     }
     return result;
 }
 
 bool memory_allocating_request::keeps_connection(void) const
 {
-    return (version() > http_version::HTTP_1_0) || is_keep_alive_set_;
+    // a request with both a content length and a chunked content may be
+    // interpreted differently by an intermediary, therefore the connection is
+    // closed after the response (RFC 9112 section 6.3)
+    const bool is_ambiguous = is_chunked_ && is_content_length_set_;
+    return (false == is_ambiguous) &&
+           ((version() > http_version::HTTP_1_0) || is_keep_alive_set_);
 }
 
 time_t memory_allocating_request::date(void) const
 {
+    // the date is converted on first use and an invalid date is ignored
+    if ((false == is_date_parsed_) && (NULL != date_string_)) {
+        const epoch_time_t parsed_date =
+            parse_timestamp(date_string_, date_length_);
+        if (parsed_date >= 0) {
+            date_ = parsed_date;
+        }
+    }
+    is_date_parsed_ = true;
     return date_;
 }
 
@@ -282,6 +623,11 @@ mime memory_allocating_request::content_type(void) const
 
 bool memory_allocating_request::accept(void*& handle, mime& type) const
 {
+    // the accept header is only needed, when a resource offers several types
+    if ((false == is_accept_parsed_) && (NULL != accept_string_)) {
+        accept_.parse(accept_string_, accept_length_);
+    }
+    is_accept_parsed_ = true;
     return accept_.next_value(handle, type);
 }
 
@@ -291,26 +637,265 @@ http_expectation memory_allocating_request::expect(void) const
 }
 
 const char_t* memory_allocating_request::from(void) const
+{
+    return from_.data();
+}
+
+std::string_view memory_allocating_request::from_view(void) const
 {
     return from_;
 }
 
 const char_t* memory_allocating_request::referer(void) const
+{
+    return referer_.data();
+}
+
+std::string_view memory_allocating_request::referer_view(void) const
 {
     return referer_;
 }
 
 const char_t* memory_allocating_request::user_agent(void) const
+{
+    return user_agent_.data();
+}
+
+std::string_view memory_allocating_request::user_agent_view(void) const
 {
     return user_agent_;
 }
 
-bool memory_allocating_request::parse_method(int32_t& ch)
+bool memory_allocating_request::parse_head(const mime_handler& handler,
+                                           parsed_head* recorder)
+{
+    bool result = false;
+
+    int32_t ch = -1;
+    if (parse_request_line(ch, recorder)) {
+        ch = lexer_.get();
+        while (ch >= 0) {
+            if (is_newline(ch)) {
+                if (NULL != recorder) {
+                    recorder->end = lexer_.index();
+                }
+                result = true;
+                break;
+            }
+
+            if (parse_header(handler, ch, recorder)) {
+                ch = lexer_.get();
+            }
+        }
+    }
+
+    return result;
+}
+
+bool memory_allocating_request::parse_cached_head(const mime_handler& handler)
+{
+    bool result;
+
+    const char_t* const head = lexer_.header_data(0);
+    const size_t length = lexer_.header_length();
+    const uint64_t hash = parsed_head_cache::hash(head, length);
+    const std::shared_ptr<const parsed_head> cached =
+        head_cache_->find(hash, head, length);
+    if (cached) {
+        replay_head(handler, *cached);
+        result = true;
+    } else if (head_cache_->accepts(length)) {
+        // parsing rewrites the head, therefore it is copied before
+        std::shared_ptr<parsed_head> parsed = std::make_shared<parsed_head>();
+        parsed->hash = hash;
+        parsed->head.assign(head, head + length);
+        parsed->end = 0;
+
+        // a content type, which was parsed with older mime types, is parsed
+        // again on replay
+        const uint64_t generation = handler.generation();
+        result = parse_head(handler, parsed.get());
+
+        // the end is only set, when the whole head was recorded
+        if (result && (0 != parsed->end)) {
+            record_head(handler, generation, *parsed);
+            head_cache_->insert(std::move(parsed));
+        }
+    } else {
+        result = parse_head(handler, NULL);
+    }
+
+    return result;
+}
+
+void memory_allocating_request::record_head(const mime_handler& handler,
+                                            const uint64_t generation,
+                                            parsed_head& parsed) const
+{
+    const char_t* const head = lexer_.header_data(0);
+    parsed.image.assign(head, head + parsed.end);
+    const char_t* const image = parsed.image.data();
+
+    parsed.target.relocate(path_uri_, head, image);
+    parsed.host.relocate(host_uri_, head, image);
+    parsed.content_length = content_length_;
+    parsed.is_content_length_set = is_content_length_set_;
+    parsed.accept = relocate(std::string_view(accept_string_, accept_length_),
+                             head, image);
+    parsed.content_md5 = relocate(
+        std::string_view(content_md5_, content_md5_length_), head, image);
+    parsed.date =
+        relocate(std::string_view(date_string_, date_length_), head, image);
+    parsed.from = relocate(from_, head, image);
+    parsed.referer = relocate(referer_, head, image);
+    parsed.user_agent = relocate(user_agent_, head, image);
+    parsed.content_digest = content_digest_;
+    parsed.content_type = content_type_;
+    parsed.content_type_value = relocate(content_type_value_, head, image);
+    parsed.content_type_handler = &handler;
+    parsed.content_type_generation = generation;
+    parsed.is_keep_alive_set = is_keep_alive_set_;
+    parsed.expect = expect_;
+    parsed.is_chunked = is_chunked_;
+    parsed.is_transfer_encoding_set = is_transfer_encoding_set_;
+    parsed.transfer_coding_status = transfer_coding_status_;
+}
+
+void memory_allocating_request::replay_head(const mime_handler& handler,
+                                            const parsed_head& parsed)
+{
+    // the parsed head replaces the byte-identical head, therefore all strings
+    // of the parsed head are found at the same offsets in the lexer's buffer
+    char_t* const head = lexer_.header_data(0);
+    const char_t* const image = parsed.image.data();
+    ::memcpy(head, image, parsed.image.size());
+
+    method_ = parsed.method;
+    version_ = parsed.version;
+    path_uri_.relocate(parsed.target, image, head);
+    host_uri_.relocate(parsed.host, image, head);
+    content_length_ = parsed.content_length;
+    is_content_length_set_ = parsed.is_content_length_set;
+
+    // the accept header field is parsed in place and the head is writable
+    const std::string_view accept = relocate(parsed.accept, image, head);
+    accept_string_ = const_cast<char_t*>(accept.data());
+    accept_length_ = accept.size();
+    const std::string_view content_md5 =
+        relocate(parsed.content_md5, image, head);
+    content_md5_ = content_md5.data();
+    content_md5_length_ = content_md5.size();
+    const std::string_view date = relocate(parsed.date, image, head);
+    date_string_ = date.data();
+    date_length_ = date.size();
+    from_ = relocate(parsed.from, image, head);
+    referer_ = relocate(parsed.referer, image, head);
+    user_agent_ = relocate(parsed.user_agent, image, head);
+    content_digest_ = parsed.content_digest;
+
+    // the mime types may have changed since the head was parsed
+    content_type_value_ = relocate(parsed.content_type_value, image, head);
+    if ((&handler == parsed.content_type_handler) &&
+        (handler.generation() == parsed.content_type_generation)) {
+        content_type_ = parsed.content_type;
+    } else if (NULL != content_type_value_.data()) {
+        content_type_ = handler.parse(content_type_value_.data(),
+                                      content_type_value_.size());
+    }
+
+    is_keep_alive_set_ = parsed.is_keep_alive_set;
+    expect_ = parsed.expect;
+    is_chunked_ = parsed.is_chunked;
+    is_transfer_encoding_set_ = parsed.is_transfer_encoding_set;
+    transfer_coding_status_ = parsed.transfer_coding_status;
+
+    // custom header fields are only inserted into the table, because their
+    // names and values are already null-terminated
+    for (const parsed_header_field& field : parsed.fields) {
+        set_header(handler, header_key::CUSTOM, head + field.key_begin,
+                   field.key_hash, head + field.value_begin,
+                   field.value_length);
+    }
+    lexer_.set_index(parsed.end);
+}
+
+bool memory_allocating_request::parse_request_line(int32_t& ch,
+                                                   parsed_head*& recorder)
 {
-    static size_t maximum_method_length = 0;
-    static const trie<http_verb> methods =
-        get_method_trie(maximum_method_length);
+    bool result;
+
+    size_t target_begin = 0;
+    size_t target_end = 0;
+    size_t line_end = 0;
+    if (match_request_line(target_begin, target_end, line_end)) {
+        // the uri is parsed in place like in parse_uri
+        result = path_uri_.parse(lexer_.header_data(target_begin),
+                                 target_end - target_begin, true);
+
+        // continue behind the newline like the generic path does
+        lexer_.set_index(line_end);
+        ch = lexer_.get();
 
+        if (NULL != recorder) {
+            recorder->method = method_;
+            recorder->version = version_;
+        }
+    } else {
+        ch = lexer_.get();
+        result = parse_method(ch) && parse_uri(ch) && parse_version(ch);
+        recorder = NULL;
+    }
+
+    return result;
+}
+
+bool memory_allocating_request::match_request_line(size_t& target_begin,
+                                                   size_t& target_end,
+                                                   size_t& line_end)
+{
+    bool result = false;
+
+    const size_t header_length = lexer_.header_length();
+    const char_t* const data = lexer_.header_data(0);
+    const void* const newline =
+        (NULL != data) ? ::memchr(data, '\n', header_length) : NULL;
+    if (NULL != newline) {
+        const size_t line_length =
+            static_cast<size_t>(static_cast<const char_t*>(newline) - data);
+
+        // the shortest line has a method of 3 characters and a target of 1
+        // character, which are each followed by a space
+        static const size_t min_line_length = 3 + 1 + 1 + 1 + version_length;
+
+        http_verb method = http_verb::GET;
+        http_version version = http_version::HTTP_UNKNOWN;
+        const size_t method_length =
+            (line_length >= min_line_length) ? match_method(data, method) : 0;
+        const size_t version_begin = line_length - version_length;
+        if ((method_length > 0) && (' ' == data[version_begin - 1]) &&
+            match_version(data + version_begin, version)) {
+            // the target must not contain any whitespace, otherwise the
+            // request line has an unusual shape, which the generic path
+            // handles
+            const size_t begin = method_length + 1;
+            const size_t end = version_begin - 1;
+            if ((end > begin) &&
+                ((end - begin) == ::strcspn(data + begin, " \t\n"))) {
+                method_ = method;
+                version_ = version;
+                target_begin = begin;
+                target_end = end;
+                line_end = line_length;
+                result = true;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool memory_allocating_request::parse_method(int32_t& ch)
+{
     bool result = false;
 
     size_t method_begin = 0;
@@ -327,9 +912,8 @@ bool memory_allocating_request::parse_method(int32_t& ch)
         if (is_whitespace(ch)) {
             const size_t method_length = lexer_.prev_index() - method_begin;
 
-            result = parse_specific_value(methods, maximum_method_length,
-                                          lexer_.header_data(method_begin),
-                                          method_length, method_);
+            result = methods.find(lexer_.header_data(method_begin),
+                                  method_length, method_);
             break;
         }
 
@@ -355,10 +939,8 @@ bool memory_allocating_request::parse_uri(int32_t& ch)
     size_t source_length = 0;
     while (ch >= 0) {
         if (is_whitespace(ch)) {
-            char_t* destination = lexer_.header_data(0);
-            size_t destination_length = lexer_.prev_index();
-            result = path_uri_.parse(source, source_length, destination,
-                                     destination_length, true);
+            // the whitespaces around the uri are overwritten while parsing
+            result = path_uri_.parse(source, source_length, true);
             break;
         }
 
@@ -369,12 +951,48 @@ bool memory_allocating_request::parse_uri(int32_t& ch)
     return result;
 }
 
-bool memory_allocating_request::parse_version(int32_t& ch)
+void memory_allocating_request::parse_query(void) const
 {
-    static size_t maximum_version_length = 0;
-    static const trie<http_version> versions =
-        get_version_trie(maximum_version_length);
+    const char_t* query_string = path_uri_.query();
+    if (NULL == query_string) {
+        query_string = host_uri_.query();
+    }
 
+    // each entry takes at least two characters of the request line, but the
+    // query string of the Host header field may be longer, whose further
+    // entries are ignored
+    const size_t max_entries = lexer_.limits().max_request_line_length / 2;
+
+    if (NULL != query_string) {
+        // the query string points into the lexer's data buffer, which is
+        // writable and is therefore split and decoded in place
+        char_t* data = const_cast<char_t*>(query_string);
+        while (('\0' != *data) && (query_entries_.size() < max_entries)) {
+            const char_t* const key = data;
+            uint32_t key_hash = key_value_table::initial_hash();
+            size_t key_length = 0;
+            const char_t key_end =
+                decode_query_word(data, '=', key_hash, key_length);
+
+            // a key without an equal sign has an empty value
+            std::string_view value{""};
+            if ('=' == key_end) {
+                const char_t* const value_string = data;
+                uint32_t value_hash = key_value_table::initial_hash();
+                size_t value_length = 0;
+                decode_query_word(data, '&', value_hash, value_length);
+                value = std::string_view(value_string, value_length);
+            }
+
+            if (key_length > 0) {
+                query_entries_.insert(key_hash, key, value);
+            }
+        }
+    }
+}
+
+bool memory_allocating_request::parse_version(int32_t& ch)
+{
     bool result = false;
 
     size_t version_begin = 0;
@@ -391,9 +1009,8 @@ bool memory_allocating_request::parse_version(int32_t& ch)
         if (is_newline(ch)) {
             const size_t version_length = lexer_.prev_index() - version_begin;
 
-            result = parse_specific_value(versions, maximum_version_length,
-                                          lexer_.header_data(version_begin),
-                                          version_length, version_);
+            result = versions.find(lexer_.header_data(version_begin),
+                                   version_length, version_);
             break;
         }
 
@@ -404,16 +1021,18 @@ bool memory_allocating_request::parse_version(int32_t& ch)
 }
 
 bool memory_allocating_request::parse_header(const mime_handler& handler,
-                                             int32_t& ch)
+                                             int32_t& ch,
+                                             parsed_head* const recorder)
 {
     bool result = false;
-    static size_t maximum_header_key_length = 0;
-    static const trie<header_key> header_keys =
-        get_header_key_trie(maximum_header_key_length);
 
     const size_t key_begin = lexer_.prev_index();
     size_t key_size = 0;
     char_t* key = lexer_.header_data(key_begin);
+
+    // the hash is calculated while reading the key, therefore looking up a
+    // custom header field does not need to read the key again
+    uint32_t key_hash = key_value_table::initial_hash();
     while (ch >= 0) {
         if (is_key_value_separator(ch)) {
             // overwrite the separator with null will null terminate the key
@@ -423,14 +1042,14 @@ bool memory_allocating_request::parse_header(const mime_handler& handler,
             break;
         }
 
+        key_hash = key_value_table::hash_step(
+            key_hash, static_cast<char_t>(ch), false);
         ch = lexer_.get();
     }
 
-    trie_find_result<header_key> key_result = header_keys.find(key, key_size);
+    // the header field name has to match exactly, otherwise it stays custom
     header_key key_enum = header_key::CUSTOM;
-    if (key_result.used_size() > 0) {
-        key_enum = key_result.value();
-    }
+    header_keys.find(key, key_size, key_enum);
 
     ch = lexer_.get();
     const size_t value_begin = lexer_.prev_index();
@@ -444,7 +1063,13 @@ bool memory_allocating_request::parse_header(const mime_handler& handler,
             const size_t value_end = lexer_.prev_index();
             lexer_.header_data(value_end)[0] = '\0';
             const size_t value_size = value_end - value_begin;
-            set_header(handler, key_enum, key, value, value_size);
+            set_header(handler, key_enum, key, key_hash, value, value_size);
+
+            // the results of all other header fields are recorded at once
+            if ((NULL != recorder) && (header_key::CUSTOM == key_enum)) {
+                recorder->fields.push_back(
+                    {key_hash, key_begin, value_begin, value_size});
+            }
             result = true;
             break;
         }
@@ -458,6 +1083,7 @@ bool memory_allocating_request::parse_header(const mime_handler& handler,
 bool memory_allocating_request::set_header(const mime_handler& handler,
                                            header_key key,
                                            char_t* const key_string,
+                                           const uint32_t key_hash,
                                            const char_t* value_string,
                                            size_t value_length)
 {
@@ -468,6 +1094,7 @@ bool memory_allocating_request::set_header(const mime_handler& handler,
     static const header_fn_array set_header_fns = {
         {&memory_allocating_request::set_accept,
          &memory_allocating_request::set_connection,
+         &memory_allocating_request::set_content_digest,
          &memory_allocating_request::set_content_length,
          &memory_allocating_request::set_content_md5,
          &memory_allocating_request::set_content_type,
@@ -476,6 +1103,7 @@ bool memory_allocating_request::set_header(const mime_handler& handler,
          &memory_allocating_request::set_from,
          &memory_allocating_request::set_host,
          &memory_allocating_request::set_referer,
+         &memory_allocating_request::set_transfer_encoding,
          &memory_allocating_request::set_user_agent}};
     skip_whitespace(value_string, value_length);
 
@@ -485,7 +1113,14 @@ bool memory_allocating_request::set_header(const mime_handler& handler,
         result = (this->*fn)(handler, key_string,
                              const_cast<char_t*>(value_string), value_length);
     } else {
-        header_fields_[key_string] = value_string;
+        header_fields_.insert(key_hash, key_string,
+                              std::string_view(value_string, value_length));
+
+        const custom_header_id id =
+            custom_header_registry::instance().find(key_hash, key_string);
+        if (id < registered_header_values_.size()) {
+            registered_header_values_[id] = value_string;
+        }
         result = true;
     }
     return result;
@@ -495,7 +1130,10 @@ bool memory_allocating_request::set_accept(const mime_handler&, char_t* const,
                                            char_t* const value_string,
                                            size_t value_length)
 {
-    return accept_.parse(value_string, value_length);
+    accept_string_ = value_string;
+    accept_length_ = value_length;
+    is_accept_parsed_ = false;
+    return true;
 }
 
 bool memory_allocating_request::set_connection(const mime_handler&,
@@ -514,6 +1152,14 @@ bool memory_allocating_request::set_connection(const mime_handler&,
     return true;
 }
 
+bool memory_allocating_request::set_content_digest(const mime_handler&,
+                                                   char_t* const,
+                                                   char_t* const value_string,
+                                                   size_t value_length)
+{
+    return content_digest_.parse(value_string, value_length);
+}
+
 bool memory_allocating_request::set_content_length(const mime_handler&,
                                                    char_t* const,
                                                    char_t* const value_string,
@@ -525,6 +1171,7 @@ bool memory_allocating_request::set_content_length(const mime_handler&,
         parse_unsigned_integer<int64_t>(value_pointer_copy, value_length);
     if (length >= 0) {
         content_length_ = static_cast<size_t>(length);
+        is_content_length_set_ = true;
         result = true;
     }
     return result;
@@ -546,6 +1193,7 @@ bool memory_allocating_request::set_content_type(const mime_handler& handler,
                                                  size_t value_length)
 {
     content_type_ = handler.parse(value_string, value_length);
+    content_type_value_ = std::string_view(value_string, value_length);
     return ((content_type_.first != mime_type::INVALID) &&
             (content_type_.second != mime_subtype::INVALID));
 }
@@ -554,11 +1202,10 @@ bool memory_allocating_request::set_date(const mime_handler&, char_t* const,
                                          char_t* const value_string,
                                          size_t value_length)
 {
-    epoch_time_t parsed_date = parse_timestamp(value_string, value_length);
-    if (parsed_date >= 0) {
-        date_ = parsed_date;
-    }
-    return (parsed_date >= 0);
+    date_string_ = value_string;
+    date_length_ = value_length;
+    is_date_parsed_ = false;
+    return true;
 }
 
 bool memory_allocating_request::set_expect(const mime_handler&, char_t* const,
@@ -575,34 +1222,93 @@ bool memory_allocating_request::set_expect(const mime_handler&, char_t* const,
 }
 
 bool memory_allocating_request::set_from(const mime_handler&, char_t* const,
-                                         char_t* const value_string, size_t)
+                                         char_t* const value_string,
+                                         size_t value_length)
 {
-    from_ = value_string;
+    from_ = std::string_view(value_string, value_length);
     return true;
 }
 
-bool memory_allocating_request::set_host(const mime_handler&,
-                                         char_t* const key_string,
+bool memory_allocating_request::set_host(const mime_handler&, char_t* const,
                                          char_t* const value_string,
                                          size_t value_length)
 {
-    return host_uri_.parse(value_string, value_length, key_string,
-                           value_length + 5, true);
+    return host_uri_.parse(value_string, value_length, true);
 }
 
 bool memory_allocating_request::set_referer(const mime_handler&, char_t* const,
-                                            char_t* const value_string, size_t)
+                                            char_t* const value_string,
+                                            size_t value_length)
 {
-    referer_ = value_string;
+    referer_ = std::string_view(value_string, value_length);
     return true;
 }
 
+bool memory_allocating_request::set_transfer_encoding(
+    const mime_handler&, char_t* const, char_t* const value_string,
+    size_t value_length)
+{
+    static const char_t chunked_str[] = "chunked";
+    static const size_t chunked_length = sizeof(chunked_str) - 1;
+
+    // the codings are listed in the order they were applied and several
+    // header fields form one list, therefore chunked has to be the last one
+    is_transfer_encoding_set_ = true;
+    bool result = true;
+    size_t index = 0;
+    while (index < value_length) {
+        const char_t* const end = static_cast<const char_t*>(
+            memchr(value_string + index, ',', value_length - index));
+        size_t length =
+            (NULL == end) ? (value_length - index)
+                          : static_cast<size_t>(end - value_string) - index;
+        const size_t next = index + length + 1;
+
+        // the parameters of a coding do not matter here
+        const char_t* const parameters = static_cast<const char_t*>(
+            memchr(value_string + index, ';', length));
+        if (NULL != parameters) {
+            length = static_cast<size_t>(parameters - value_string) - index;
+        }
+        while ((length > 0) && is_whitespace(value_string[index])) {
+            index++;
+            length--;
+        }
+        while ((length > 0) &&
+               is_whitespace(value_string[index + length - 1])) {
+            length--;
+        }
+
+        if (length == 0) {
+            // empty list elements are allowed and ignored
+        } else if ((length == chunked_length) &&
+                   (0 == ::strncasecmp(value_string + index, chunked_str,
+                                       chunked_length))) {
+            // chunked must not be applied more than once
+            if (is_chunked_) {
+                transfer_coding_status_ = http_status_code::BAD_REQUEST;
+                result = false;
+            }
+            is_chunked_ = true;
+        } else {
+            // any other coding (e.g. gzip) could not be decoded
+            if (transfer_coding_status_ == http_status_code::OK) {
+                transfer_coding_status_ = http_status_code::NOT_IMPLEMENTED;
+            }
+            is_chunked_ = false;
+            result = false;
+        }
+        index = next;
+    }
+    return result;
+}
+
 bool memory_allocating_request::set_user_agent(const mime_handler&,
                                                char_t* const,
                                                char_t* const value_string,
-                                               size_t)
+                                               size_t value_length)
 {
-    user_agent_ = value_string;
+    user_agent_ = std::string_view(value_string, value_length);
     return true;
 }
 
@@ -631,24 +1337,4 @@ bool memory_allocating_request::is_key_value_separator(const int32_t ch)
     return static_cast<int32_t>(':') == ch;
 }
 
-bool memory_allocating_request::enforced_null_terminated_less::operator()(
-    const char_t* const lhs, const char_t* const rhs) const
-{
-    bool result;
-    if (lhs == NULL) {
-        result = (rhs != NULL);
-    } else {
-        if (rhs == NULL) {
-            result = false;
-        } else {
-            // Exceptional use of unbound function strcmp (breaks MISRA C++:2008
-            // Rule 18-0-5), because neither lhs nor rhs is really unbound. Both
-            // are pointing to null-terminated parts of the lexer's raw data.
-            // The null-termination is ensured by the parsing algorithm.
-            result = (strcmp(lhs, rhs) < 0);
-        }
-    }
-    return result;
-}
-
 } // namespace hutzn
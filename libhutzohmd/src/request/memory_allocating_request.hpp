@@ -19,13 +19,19 @@
 #ifndef LIBHUTZNOHMD_REQUEST_MEMORY_ALLOCATING_REQUEST_HPP
 #define LIBHUTZNOHMD_REQUEST_MEMORY_ALLOCATING_REQUEST_HPP
 
-#include <map>
+#include <array>
+#include <memory_resource>
 
 #include "libhutznohmd/request.hpp"
 #include "request/accept_parser.hpp"
+#include "request/content_digest.hpp"
+#include "request/custom_header_registry.hpp"
 #include "request/lexer.hpp"
+#include "request/md5.hpp"
 #include "request/mime_handler.hpp"
+#include "request/parsed_head_cache.hpp"
 #include "request/uri.hpp"
+#include "utility/key_value_table.hpp"
 
 namespace hutzn
 {
@@ -41,6 +47,9 @@ enum class header_key : int8_t {
     //! Connection kind.
     CONNECTION,
 
+    //! Content-Digest kind.
+    CONTENT_DIGEST,
+
     //! Content-Length kind.
     CONTENT_LENGTH,
 
@@ -65,6 +74,9 @@ enum class header_key : int8_t {
     //! Referer kind.
     REFERER,
 
+    //! Transfer-Encoding kind.
+    TRANSFER_ENCODING,
+
     //! User-Agent kind.
     USER_AGENT,
 
@@ -79,7 +91,36 @@ public:
     //! @brief Constructs a request by a connection.
     //!
     //! @param[in] connection Connection to use when more data is needed.
-    explicit memory_allocating_request(const connection_ptr& connection);
+    //! @param[in] limits     Limits of the header.
+    //! @param[in] resource   Memory resource for the header fields and query
+    //!                       entries, e.g. the arena of the request. It has to
+    //!                       outlive the request.
+    //! @param[in] head_cache Optional cache of parsed heads, which is shared
+    //!                       by the requests of one thread, e.g. the one of
+    //!                       parsed_head_cache::instance. It has to outlive
+    //!                       the request.
+    explicit memory_allocating_request(
+        const connection_ptr& connection,
+        const header_limits& limits = header_limits(),
+        std::pmr::memory_resource* const resource =
+            std::pmr::get_default_resource(),
+        parsed_head_cache* const head_cache = NULL);
+
+    //! @brief Constructs a request by a connection and the data, that was
+    //! received together with the previous request on that connection.
+    //!
+    //! @param[in] connection     Connection to use when more data is needed.
+    //! @param[in] pipelined_data Data, that belongs to this request.
+    //! @param[in] limits         Limits of the header.
+    //! @param[in] resource       Memory resource for the header fields and
+    //!                           query entries.
+    //! @param[in] head_cache     Optional cache of parsed heads.
+    explicit memory_allocating_request(
+        const connection_ptr& connection, buffer&& pipelined_data,
+        const header_limits& limits = header_limits(),
+        std::pmr::memory_resource* const resource =
+            std::pmr::get_default_resource(),
+        parsed_head_cache* const head_cache = NULL);
 
     explicit memory_allocating_request(const memory_allocating_request& rhs) =
         delete;
@@ -90,35 +131,86 @@ public:
     //!
     //! Reads the header from the stream. Splits and converts the header's parts
     //! to improve operation speed afterwards. Needs a mime_handler to be used
-    //! when reading MIMEs.
+    //! when reading MIMEs. A request, whose header exceeds the limits or could
+    //! not be parsed, is rejected immediately. A head, which is found in the
+    //! head cache, is not tokenized again.
     //! @param[in] handler MIME handler to be used when parsing the header.
     //! @return            True then parsing was successful and false when not.
     bool parse(const mime_handler& handler);
 
+    //! @brief Returns the status code, that was used to reject the request.
+    //!
+    //! @return Status code of the rejection or http_status_code::OK, when the
+    //!         request was not rejected.
+    http_status_code rejection_status(void) const;
+
     //! @copydoc request::fetch_content()
     bool fetch_content(void) override;
 
+    //! @copydoc request::read_some()
+    bool read_some(buffer& data, const size_t max_size) override;
+
+    //! @copydoc request::stream_content()
+    bool stream_content(const content_sink& sink) override;
+
+    //! @brief Returns the data of the next request on the connection.
+    //!
+    //! Clients may pipeline their requests. All data received beyond this
+    //! request has to be passed to the next request. Skips the content of this
+    //! request first, if it was not already fetched or read completely.
+    //! @return Pipelined data, which is possibly empty.
+    buffer take_pipelined_data(void);
+
+    //! @brief Prepares the request for the next request on the connection.
+    //!
+    //! Reusing the request for all requests on a keep-alive connection avoids
+    //! constructing a new one each time. Skips the content of this request
+    //! first, if it was not already fetched or read completely. All buffers
+    //! and tables keep their capacity. Call @ref parse() afterwards. All
+    //! strings retrieved before are invalid after the call.
+    void reset(void);
+
     //! @copydoc request::method()
     http_verb method(void) const override;
 
     //! @copydoc request::path()
     const char_t* path(void) const override;
 
+    //! @copydoc request::path_view()
+    std::string_view path_view(void) const override;
+
     //! @copydoc request::host()
     const char_t* host(void) const override;
 
+    //! @copydoc request::host_view()
+    std::string_view host_view(void) const override;
+
     //! @copydoc request::query()
     const char_t* query(const char_t* const key) const override;
 
+    //! @copydoc request::query_view()
+    std::string_view query_view(const char_t* const key) const override;
+
     //! @copydoc request::fragment()
     const char_t* fragment(void) const override;
 
+    //! @copydoc request::fragment_view()
+    std::string_view fragment_view(void) const override;
+
     //! @copydoc request::version()
     http_version version(void) const override;
 
     //! @copydoc request::header_value()
     const char_t* header_value(const char_t* const name) const override;
 
+    //! @copydoc request::header_value_view()
+    std::string_view header_value_view(
+        const char_t* const name) const override;
+
+    //! @copydoc request::registered_header_value()
+    const char_t* registered_header_value(
+        const custom_header_id id) const override;
+
     //! @copydoc request::keeps_connection()
     bool keeps_connection(void) const override;
 
@@ -143,25 +235,73 @@ public:
     //! @copydoc request::from()
     const char_t* from(void) const override;
 
+    //! @copydoc request::from_view()
+    std::string_view from_view(void) const override;
+
     //! @copydoc request::referer()
     const char_t* referer(void) const override;
 
+    //! @copydoc request::referer_view()
+    std::string_view referer_view(void) const override;
+
     //! @copydoc request::user_agent()
     const char_t* user_agent(void) const override;
 
+    //! @copydoc request::user_agent_view()
+    std::string_view user_agent_view(void) const override;
+
 private:
+    //! Reads the rest of the content without storing it.
+    void skip_content(void);
+
+    //! Compares the md5 sum with the value of the Content-MD5 header field.
+    bool is_content_md5_valid(const md5_array& md5_sum) const;
+
+    //! Parses the request line and the header fields. Records their offsets,
+    //! when a recorder is given.
+    bool parse_head(const mime_handler& handler, parsed_head* recorder);
+
+    //! Looks up the head in the head cache and replays it or parses and
+    //! records it.
+    bool parse_cached_head(const mime_handler& handler);
+
+    //! Stores the results of parsing the head into its parsed form. The
+    //! content type is tagged with the handler and its generation before
+    //! parsing.
+    void record_head(const mime_handler& handler, const uint64_t generation,
+                     parsed_head& parsed) const;
+
+    //! Applies the parsed form of a byte-identical head without parsing any
+    //! part of it again.
+    void replay_head(const mime_handler& handler, const parsed_head& parsed);
+
+    //! Parses the request line. Tries the fast path first and falls back to
+    //! parsing the method, the uri and the version one by one. Recording stops
+    //! for an unusual request line by resetting the recorder.
+    bool parse_request_line(int32_t& ch, parsed_head*& recorder);
+
+    //! Recognizes the common shapes of a request line at once. The method and
+    //! the version are set and the bounds of the target are returned only
+    //! when the whole line matches.
+    bool match_request_line(size_t& target_begin, size_t& target_end,
+                            size_t& line_end);
+
     bool parse_method(int32_t& ch);
     bool parse_uri(int32_t& ch);
     bool parse_version(int32_t& ch);
 
+    //! Splits the query string into its entries and decodes them in place.
+    void parse_query(void) const;
+
     //! Parses a header utilizing the lexer member. Returns true, if a header
     //! could successfully get parsed. Returning false means, that the lexer has
     //! reached the end of the file. The in/out parameter ch is -1 in this case.
-    bool parse_header(const mime_handler& handler, int32_t& ch);
+    bool parse_header(const mime_handler& handler, int32_t& ch,
+                      parsed_head* const recorder);
 
     bool set_header(const mime_handler& handler, header_key key,
-                    char_t* const key_string, const char_t* value_string,
-                    size_t value_length);
+                    char_t* const key_string, const uint32_t key_hash,
+                    const char_t* value_string, size_t value_length);
 
     bool set_accept(const mime_handler& handler, char_t* const key_string,
                     char_t* const value_string, size_t value_length);
@@ -169,6 +309,10 @@ private:
     bool set_connection(const mime_handler& handler, char_t* const key_string,
                         char_t* const value_string, size_t value_length);
 
+    bool set_content_digest(const mime_handler& handler,
+                            char_t* const key_string,
+                            char_t* const value_string, size_t value_length);
+
     bool set_content_length(const mime_handler& handler,
                             char_t* const key_string,
                             char_t* const value_string, size_t value_length);
@@ -194,6 +338,11 @@ private:
     bool set_referer(const mime_handler& handler, char_t* const key_string,
                      char_t* const value_string, size_t value_length);
 
+    bool set_transfer_encoding(const mime_handler& handler,
+                               char_t* const key_string,
+                               char_t* const value_string,
+                               size_t value_length);
+
     bool set_user_agent(const mime_handler& handler, char_t* const key_string,
                         char_t* const value_string, size_t value_length);
 
@@ -203,36 +352,71 @@ private:
 
     lexer lexer_;
 
+    //! Optional cache of parsed heads.
+    parsed_head_cache* const head_cache_;
+
     http_verb method_;
     uri path_uri_;
     http_version version_;
 
-    accept_parser accept_;
+    //! The accept header field is parsed on first use.
+    mutable accept_parser accept_;
+    char_t* accept_string_;
+    size_t accept_length_;
+    mutable bool is_accept_parsed_;
+
     size_t content_length_;
+    bool is_content_length_set_;
     const char_t* content_md5_;
     size_t content_md5_length_;
+
+    //! Hashes the parts of the content while they are read, when a
+    //! Content-MD5 header field is present.
+    md5_context content_md5_context_;
+
+    //! Verifies the content against a Content-Digest header field.
+    content_digest_verifier content_digest_;
     mime content_type_;
+
+    //! Value of the Content-Type header field, which is parsed again, when a
+    //! cached head is replayed with changed mime types.
+    std::string_view content_type_value_;
     const void* content_;
     uri host_uri_;
     bool is_keep_alive_set_;
-    epoch_time_t date_;
+
+    //! The date header field is converted on first use.
+    const char_t* date_string_;
+    size_t date_length_;
+    mutable epoch_time_t date_;
+    mutable bool is_date_parsed_;
+
     http_expectation expect_;
-    const char_t* from_;
-    const char_t* referer_;
-    const char_t* user_agent_;
-
-    //! Do not use this in any other case than for storing header fields and
-    //! query entries! It is designed for only one purpose: To let the string's
-    //! content decide the order of the elements in the map. This map has to
-    //! enforce, that all characters are null-terminated!
-    struct enforced_null_terminated_less {
-        bool operator()(const char_t* const lhs, const char_t* const rhs) const;
-    };
-
-    std::map<const char_t* const, const char_t*, enforced_null_terminated_less>
-        header_fields_;
-    std::map<const char_t* const, const char_t*, enforced_null_terminated_less>
-        query_entries_;
+    std::string_view from_;
+    std::string_view referer_;
+
+    //! The content is chunked, when chunked is the last transfer coding. Any
+    //! other coding is not supported and rejects the request like a malformed
+    //! list of codings.
+    bool is_chunked_;
+    bool is_transfer_encoding_set_;
+    http_status_code transfer_coding_status_;
+
+    std::string_view user_agent_;
+
+    //! Custom header fields. The names are compared case-insensitively.
+    key_value_table header_fields_;
+
+    //! Query entries. The keys are compared case-sensitively. They are parsed
+    //! on first access.
+    mutable key_value_table query_entries_;
+
+    //! True when the query string was split into the query entries.
+    mutable bool is_query_parsed_;
+
+    //! Values of the custom header fields, whose names are registered.
+    std::array<const char_t*, custom_header_registry::capacity>
+        registered_header_values_;
 };
 
 } // namespace hutzn
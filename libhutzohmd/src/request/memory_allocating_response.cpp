@@ -38,6 +38,11 @@ void memory_allocating_response::set_content(const buffer& /*content*/,
 {
 }
 
+void memory_allocating_response::set_content_digest(
+    const digest_algorithm /*algorithm*/)
+{
+}
+
 void memory_allocating_response::set_content_location(
     const char_t* const /*content_location*/)
 {
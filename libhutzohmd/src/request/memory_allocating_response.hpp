@@ -40,6 +40,9 @@ public:
     //! @copydoc response::set_content()
     void set_content(const buffer& content, const bool set_md5) override;
 
+    //! @copydoc response::set_content_digest()
+    void set_content_digest(const digest_algorithm algorithm) override;
+
     //! @copydoc response::set_content_location()
     void set_content_location(const char_t* const content_location) override;
 
@@ -27,6 +27,7 @@ mime_handler::mime_handler(void)
     : mime_type_mutex_()
     , mime_types_()
     , mime_subtypes_()
+    , generation_(0)
 {
 }
 
@@ -34,28 +35,44 @@ mime_type mime_handler::register_mime_type(const std::string& type)
 {
     // registration has to be guarded
     std::lock_guard<std::mutex> lock(mime_type_mutex_);
-    return mime_types_.register_type(type);
+    const mime_type result = mime_types_.register_type(type);
+    if (result != mime_type::INVALID) {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+    return result;
 }
 
 mime_subtype mime_handler::register_mime_subtype(const std::string& subtype)
 {
     // registration has to be guarded
     std::lock_guard<std::mutex> lock(mime_type_mutex_);
-    return mime_subtypes_.register_type(subtype);
+    const mime_subtype result = mime_subtypes_.register_type(subtype);
+    if (result != mime_subtype::INVALID) {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+    return result;
 }
 
 bool mime_handler::unregister_mime_type(const mime_type& type)
 {
     // unregistration has to be guarded
     std::lock_guard<std::mutex> lock(mime_type_mutex_);
-    return mime_types_.unregister_type(type);
+    const bool result = mime_types_.unregister_type(type);
+    if (result) {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+    return result;
 }
 
 bool mime_handler::unregister_mime_subtype(const mime_subtype& subtype)
 {
     // unregistration has to be guarded
     std::lock_guard<std::mutex> lock(mime_type_mutex_);
-    return mime_subtypes_.unregister_type(subtype);
+    const bool result = mime_subtypes_.unregister_type(subtype);
+    if (result) {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+    return result;
 }
 
 bool mime_handler::are_two_types_valid(const mime& type1,
@@ -116,6 +133,11 @@ mime mime_handler::parse(const char_t* const data,
     return mime(type, subtype);
 }
 
+uint64_t mime_handler::generation(void) const
+{
+    return generation_.load(std::memory_order_acquire);
+}
+
 bool mime_handler::is_both_unset_or_set(const mime& t) const
 {
     const mime_type type = t.first;
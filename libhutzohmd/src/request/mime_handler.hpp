@@ -19,6 +19,7 @@
 #ifndef LIBHUTZNOHMD_REQUEST_MIME_HANDLER_HPP
 #define LIBHUTZNOHMD_REQUEST_MIME_HANDLER_HPP
 
+#include <atomic>
 #include <mutex>
 
 #include "libhutznohmd/request.hpp"
@@ -90,6 +91,13 @@ public:
     //!                       pair.
     mime parse(const char_t* const data, const size_t max_length) const;
 
+    //! @brief Returns the number of changes of the registered types.
+    //!
+    //! A mime, which was parsed before, is still valid as long as the
+    //! generation has not changed. Reading it does not lock.
+    //! @return Number of successful registrations and unregistrations.
+    uint64_t generation(void) const;
+
 private:
     //! @brief Returns whether both mime type and subtype is unset or both are
     //! set.
@@ -115,6 +123,9 @@ private:
 
     //! Stores registered mime subtypes.
     mime_data<mime_subtype> mime_subtypes_;
+
+    //! Number of changes of the registered types.
+    std::atomic<uint64_t> generation_;
 };
 
 } // namespace hutzn
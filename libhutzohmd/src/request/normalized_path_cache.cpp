@@ -0,0 +1,171 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "normalized_path_cache.hpp"
+
+#include <cstring>
+
+#include "request/parsed_head_cache.hpp"
+
+namespace hutzn
+{
+
+namespace
+{
+
+//! @brief Returns the index of the next slash or the length.
+//!
+//! @param[in] path   Points to the path.
+//! @param[in] begin  Index of the first character to check.
+//! @param[in] length Length of the path.
+//! @return           Index of the next slash or the length, when there is none.
+size_t find_slash(const char_t* const path, const size_t begin,
+                  const size_t length)
+{
+    size_t result = length;
+    if (begin < length) {
+        const void* const slash = ::memchr(path + begin, '/', length - begin);
+        if (NULL != slash) {
+            result = static_cast<size_t>(static_cast<const char_t*>(slash) -
+                                         path);
+        }
+    }
+    return result;
+}
+
+//! @brief Returns true, when a segment is "." or "..".
+//!
+//! @param[in] segment Points to the first character of the segment.
+//! @param[in] size    Size of the segment.
+//! @return            True for a dot segment.
+bool is_dot_segment(const char_t* const segment, const size_t size)
+{
+    return ((1 == size) && ('.' == segment[0])) ||
+           ((2 == size) && ('.' == segment[0]) && ('.' == segment[1]));
+}
+
+} // namespace
+
+bool is_normalized_path(const char_t* const path, const size_t length)
+{
+    bool result = true;
+    size_t slash = find_slash(path, 0, length);
+    while (result && (slash < length)) {
+        const size_t next = find_slash(path, slash + 1, length);
+        const size_t size = next - (slash + 1);
+        result = ((size > 0) || (next == length)) &&
+                 (false == is_dot_segment(path + slash + 1, size));
+        slash = next;
+    }
+    return result;
+}
+
+size_t normalize_path(char_t* const path, const size_t length)
+{
+    // the output is written behind the last kept segment, which is never
+    // beyond the segment, that is read
+    size_t tail = 0;
+    size_t head = find_slash(path, 0, length);
+    while (head < length) {
+        const size_t next = find_slash(path, head + 1, length);
+        const size_t size = next - (head + 1);
+        const bool is_last = (next == length);
+        if ((2 == size) && is_dot_segment(path + head + 1, size)) {
+            // removes the last kept segment
+            while ((tail > 0) && ('/' != path[tail - 1])) {
+                tail--;
+            }
+            if (tail > 0) {
+                tail--;
+            }
+        }
+
+        if ((size > 0) && (false == is_dot_segment(path + head + 1, size))) {
+            ::memmove(path + tail, path + head, next - head);
+            tail += next - head;
+        } else if (is_last) {
+            // a trailing dot segment or empty segment keeps the slash
+            path[tail] = '/';
+            tail++;
+        }
+        head = next;
+    }
+
+    // the root remains for a path, that got removed completely
+    if ((0 == tail) && (length > 0)) {
+        path[tail] = '/';
+        tail++;
+    }
+    return tail;
+}
+
+normalized_path_cache& normalized_path_cache::instance(void)
+{
+    static thread_local normalized_path_cache cache;
+    return cache;
+}
+
+normalized_path_cache::normalized_path_cache(void)
+    : entries_()
+{
+}
+
+size_t normalized_path_cache::normalize(char_t* const path,
+                                        const size_t length)
+{
+    size_t result = length;
+    if (false == is_normalized_path(path, length)) {
+        const uint64_t hash = parsed_head_cache::hash(path, length);
+        const entry* const cached = find(hash, path, length);
+        if (NULL != cached) {
+            ::memcpy(path, cached->normalized.data(),
+                     cached->normalized_length);
+            result = cached->normalized_length;
+        } else if (length <= max_path_length) {
+            entry& slot = entries_[hash % capacity];
+            slot.hash = hash;
+            ::memcpy(slot.path.data(), path, length);
+            slot.length = length;
+            result = normalize_path(path, length);
+            ::memcpy(slot.normalized.data(), path, result);
+            slot.normalized_length = result;
+        } else {
+            result = normalize_path(path, length);
+        }
+    }
+    return result;
+}
+
+bool normalized_path_cache::contains(const char_t* const path,
+                                     const size_t length) const
+{
+    return NULL != find(parsed_head_cache::hash(path, length), path, length);
+}
+
+const normalized_path_cache::entry* normalized_path_cache::find(
+    const uint64_t hash, const char_t* const path, const size_t length) const
+{
+    const entry* result = &(entries_[hash % capacity]);
+    if ((0 == length) || (result->hash != hash) || (result->length != length) ||
+        (0 != ::memcmp(result->path.data(), path, length))) {
+        result = NULL;
+    }
+    return result;
+}
+
+} // namespace hutzn
@@ -0,0 +1,119 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_NORMALIZED_PATH_CACHE_HPP
+#define LIBHUTZNOHMD_REQUEST_NORMALIZED_PATH_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "libhutznohmd/types.hpp"
+
+namespace hutzn
+{
+
+//! @brief Returns whether a path is in its normalized form.
+//!
+//! A normalized path contains neither "." nor ".." segments nor empty
+//! segments. Only the last segment may be empty, which is a trailing slash.
+//! @param[in] path   Path, which begins with a slash.
+//! @param[in] length Length of the path.
+//! @return           True when the path is normalized.
+bool is_normalized_path(const char_t* const path, const size_t length);
+
+//! @brief Normalizes a path in place.
+//!
+//! Removes the dot segments as specified in RFC 3986 chapter 5.2.4 and
+//! collapses consecutive slashes. The normalized path is never longer than
+//! the original one and is not null-terminated.
+//! @param[in,out] path   Path, which begins with a slash.
+//! @param[in]     length Length of the path.
+//! @return               Length of the normalized path.
+size_t normalize_path(char_t* const path, const size_t length);
+
+//! @brief Remembers the normalized form of recently seen paths.
+//!
+//! Clients tend to request the same paths over and over again. A path, which
+//! is not normalized, has to be normalized only once and is looked up by the
+//! hash of its original form afterwards. Normalized paths are not cached,
+//! because checking them is as cheap as looking them up. The cache has a
+//! fixed number of slots, which are selected by the hash, and a newer path
+//! replaces an older one in the same slot. Each thread has its own cache,
+//! which is why no synchronization is necessary.
+class normalized_path_cache
+{
+public:
+    //! Number of slots.
+    static const size_t capacity = 16;
+
+    //! Maximum length of a cached path.
+    static const size_t max_path_length = 128;
+
+    //! @brief Returns the cache of the calling thread.
+    //!
+    //! @return Cache, which must only be used by the calling thread.
+    static normalized_path_cache& instance(void);
+
+    //! @brief Constructs an empty cache.
+    normalized_path_cache(void);
+
+    //! @brief Normalizes a path in place like @ref normalize_path.
+    //!
+    //! @param[in,out] path   Path, which begins with a slash.
+    //! @param[in]     length Length of the path.
+    //! @return               Length of the normalized path.
+    size_t normalize(char_t* const path, const size_t length);
+
+    //! @brief Returns whether the normalized form of a path is cached.
+    //!
+    //! @param[in] path   Original path.
+    //! @param[in] length Length of the original path.
+    //! @return           True when the path is cached.
+    bool contains(const char_t* const path, const size_t length) const;
+
+private:
+    //! Slot of the cache.
+    struct entry {
+        //! Hash of the original path.
+        uint64_t hash;
+
+        //! Original path.
+        std::array<char_t, max_path_length> path;
+
+        //! Length of the original path or 0 for an unused slot.
+        size_t length;
+
+        //! Normalized path.
+        std::array<char_t, max_path_length> normalized;
+
+        //! Length of the normalized path.
+        size_t normalized_length;
+    };
+
+    //! @brief Returns the slot of a path, when it is cached, or NULL.
+    const entry* find(const uint64_t hash, const char_t* const path,
+                      const size_t length) const;
+
+    //! Slots of the cache.
+    std::array<entry, capacity> entries_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_NORMALIZED_PATH_CACHE_HPP
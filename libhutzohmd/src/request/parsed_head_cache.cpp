@@ -0,0 +1,91 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "parsed_head_cache.hpp"
+
+#include <cstring>
+
+namespace hutzn
+{
+
+parsed_head_cache& parsed_head_cache::instance(void)
+{
+    static thread_local parsed_head_cache cache;
+    return cache;
+}
+
+parsed_head_cache::parsed_head_cache(const size_t capacity,
+                                     const size_t max_head_length)
+    : max_head_length_(max_head_length)
+    , slots_((capacity > 0) ? capacity : 1)
+{
+}
+
+uint64_t parsed_head_cache::hash(const char_t* const head, const size_t length)
+{
+    // multiplicative hashing of whole words, finished like the murmur hash
+    static const uint64_t multiplier = 0x9E3779B97F4A7C15;
+    static const uint64_t final_multiplier = 0xFF51AFD7ED558CCD;
+    static const uint8_t shift = 33;
+
+    uint64_t result = length;
+    size_t offset = 0;
+    while ((offset + sizeof(uint64_t)) <= length) {
+        uint64_t word;
+        ::memcpy(&word, head + offset, sizeof(word));
+        result = (result ^ word) * multiplier;
+        offset += sizeof(uint64_t);
+    }
+
+    if (offset < length) {
+        uint64_t word = 0;
+        ::memcpy(&word, head + offset, length - offset);
+        result = (result ^ word) * multiplier;
+    }
+
+    result ^= result >> shift;
+    result *= final_multiplier;
+    result ^= result >> shift;
+    return result;
+}
+
+bool parsed_head_cache::accepts(const size_t length) const
+{
+    return length <= max_head_length_;
+}
+
+std::shared_ptr<const parsed_head> parsed_head_cache::find(
+    const uint64_t hash, const char_t* const head, const size_t length) const
+{
+    std::shared_ptr<const parsed_head> result = slots_[hash % slots_.size()];
+    if ((!result) || (result->hash != hash) ||
+        (result->head.size() != length) ||
+        (0 != ::memcmp(result->head.data(), head, length))) {
+        result.reset();
+    }
+    return result;
+}
+
+void parsed_head_cache::insert(std::shared_ptr<const parsed_head>&& parsed)
+{
+    if (parsed && accepts(parsed->head.size())) {
+        slots_[parsed->hash % slots_.size()] = std::move(parsed);
+    }
+}
+
+} // namespace hutzn
@@ -0,0 +1,194 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_PARSED_HEAD_CACHE_HPP
+#define LIBHUTZNOHMD_REQUEST_PARSED_HEAD_CACHE_HPP
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "libhutznohmd/request.hpp"
+#include "request/content_digest.hpp"
+#include "request/mime_handler.hpp"
+#include "request/uri.hpp"
+
+namespace hutzn
+{
+
+//! Describes a custom header field of a request head by offsets into the head.
+struct parsed_header_field {
+    //! Case-insensitive hash of the header field name.
+    uint32_t key_hash;
+
+    //! Offset of the null-terminated header field name.
+    size_t key_begin;
+
+    //! Offset of the value.
+    size_t value_begin;
+
+    //! Length of the value including leading whitespace.
+    size_t value_length;
+};
+
+//! @brief Parsed form of a request head.
+//!
+//! It holds the results of parsing the head. Its strings point into the parsed
+//! copy of the head, which is copied over a byte-identical head and the
+//! strings are relocated into it. Therefore it is valid for every
+//! byte-identical head regardless of the buffer, which contains it. The head
+//! itself is stored too, to verify a match.
+struct parsed_head {
+    //! Hash of the head.
+    uint64_t hash = 0;
+
+    //! Normalized head, before it got parsed.
+    std::vector<char_t> head{};
+
+    //! Head after parsing up to the empty line. The parts are null-terminated
+    //! and decoded in it.
+    std::vector<char_t> image{};
+
+    //! Method of the request line.
+    http_verb method = http_verb::GET;
+
+    //! Version of the request line.
+    http_version version = http_version::HTTP_UNKNOWN;
+
+    //! Request target.
+    uri target{};
+
+    //! Value of the Host header field.
+    uri host{};
+
+    //! Offset behind the empty line, which ends the head.
+    size_t end = 0;
+
+    //! Value of the Content-Length header field or 0.
+    size_t content_length = 0;
+    bool is_content_length_set = false;
+
+    //! Values of the header fields, which are parsed on first use or are
+    //! passed as they are.
+    std::string_view accept{};
+    std::string_view content_md5{};
+    std::string_view date{};
+    std::string_view from{};
+    std::string_view referer{};
+    std::string_view user_agent{};
+
+    //! Expected sums of the Content-Digest header field.
+    content_digest_verifier content_digest{};
+
+    //! Content type, which is only valid for the same mime handler in the same
+    //! generation. Otherwise its value is parsed again.
+    mime content_type{mime_type::INVALID, mime_subtype::INVALID};
+    std::string_view content_type_value{};
+    const mime_handler* content_type_handler = NULL;
+    uint64_t content_type_generation = 0;
+
+    bool is_keep_alive_set = false;
+    http_expectation expect = http_expectation::UNKNOWN;
+
+    //! Results of the Transfer-Encoding header fields.
+    bool is_chunked = false;
+    bool is_transfer_encoding_set = false;
+    http_status_code transfer_coding_status = http_status_code::OK;
+
+    //! Custom header fields in the order of the head.
+    std::vector<parsed_header_field> fields{};
+};
+
+//! @brief Remembers the parsed form of recently seen request heads.
+//!
+//! Many clients (health checks, monitoring probes) send byte-for-byte
+//! identical heads. Such a head has neither to be tokenized nor its header
+//! fields to be parsed again. The cache is
+//! bounded: it has a fixed number of slots, which are selected by the hash of
+//! the head, and a newer head replaces an older one in the same slot. Heads
+//! longer than a maximum length are not cached at all. A cache must only be
+//! used by one thread, therefore looking up a head needs no lock. Each thread
+//! has its own cache. The entries are immutable and shared, therefore an entry
+//! stays valid while it is used, even when it gets replaced meanwhile.
+class parsed_head_cache
+{
+public:
+    //! Default number of slots.
+    static const size_t default_capacity = 64;
+
+    //! Default maximum length of a cached head.
+    static const size_t default_max_head_length = 1024;
+
+    //! @brief Returns the cache of the calling thread.
+    //!
+    //! @return Cache, which must only be used by the calling thread.
+    static parsed_head_cache& instance(void);
+
+    //! @brief Constructs an empty cache.
+    //!
+    //! @param[in] capacity        Number of slots.
+    //! @param[in] max_head_length Maximum length of a cached head.
+    explicit parsed_head_cache(
+        const size_t capacity = default_capacity,
+        const size_t max_head_length = default_max_head_length);
+
+    parsed_head_cache(const parsed_head_cache&) = delete;
+    parsed_head_cache& operator=(const parsed_head_cache&) = delete;
+
+    //! @brief Calculates the hash of a head.
+    //!
+    //! The head is read in words of 64 bits.
+    //! @param[in] head   Normalized head.
+    //! @param[in] length Length of the head.
+    //! @return           Hash of the head.
+    static uint64_t hash(const char_t* const head, const size_t length);
+
+    //! @brief Returns whether a head could be cached.
+    //!
+    //! @param[in] length Length of the head.
+    //! @return           True when the head is not too long.
+    bool accepts(const size_t length) const;
+
+    //! @brief Looks up the parsed form of a head.
+    //!
+    //! @param[in] hash   Hash of the head.
+    //! @param[in] head   Normalized head, which was not parsed yet.
+    //! @param[in] length Length of the head.
+    //! @return           Parsed form of a byte-identical head or an empty
+    //!                   pointer.
+    std::shared_ptr<const parsed_head> find(const uint64_t hash,
+                                            const char_t* const head,
+                                            const size_t length) const;
+
+    //! @brief Stores the parsed form of a head.
+    //!
+    //! Replaces any other head in the same slot.
+    //! @param[in] parsed Parsed form of the head.
+    void insert(std::shared_ptr<const parsed_head>&& parsed);
+
+private:
+    //! Maximum length of a cached head.
+    const size_t max_head_length_;
+
+    //! Slots of the cache.
+    std::vector<std::shared_ptr<const parsed_head>> slots_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_PARSED_HEAD_CACHE_HPP
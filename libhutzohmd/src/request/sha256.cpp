@@ -0,0 +1,331 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "sha256.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "utility/common.hpp"
+
+namespace hutzn
+{
+
+namespace
+{
+
+static const size_t block_size = 64;
+static const size_t rounds = 64;
+
+//! Number of bytes, which store the size of the message at its end.
+static const size_t size_of_size = sizeof(uint64_t);
+
+//! Initial state, which are the fractional parts of the square roots of the
+//! first 8 primes.
+static const sha256_state initial_state = {
+    {0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU, 0x510E527FU,
+     0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U}};
+
+//! Round constants, which are the fractional parts of the cube roots of the
+//! first 64 primes.
+alignas(16) static const std::array<uint32_t, rounds> k = {
+    {0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U, 0x3956C25BU,
+     0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U, 0xD807AA98U, 0x12835B01U,
+     0x243185BEU, 0x550C7DC3U, 0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U,
+     0xC19BF174U, 0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU,
+     0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU, 0x983E5152U,
+     0xA831C66DU, 0xB00327C8U, 0xBF597FC7U, 0xC6E00BF3U, 0xD5A79147U,
+     0x06CA6351U, 0x14292967U, 0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU,
+     0x53380D13U, 0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+     0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U, 0xD192E819U,
+     0xD6990624U, 0xF40E3585U, 0x106AA070U, 0x19A4C116U, 0x1E376C08U,
+     0x2748774CU, 0x34B0BCB5U, 0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU,
+     0x682E6FF3U, 0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U,
+     0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U}};
+
+//! @brief Rotates a value some bits right.
+//!
+//! @param[in] x    Value to rotate.
+//! @param[in] bits Number of bits to rotate.
+//! @return         Rotated value.
+inline uint32_t rotate_right(const uint32_t x, const uint8_t bits)
+{
+    return (x >> bits) | (x << ((sizeof(uint32_t) * bits_per_byte) - bits));
+}
+
+//! @brief Reads a big endian word of the input data.
+//!
+//! @param[in] data Pointer to the first byte of the word.
+//! @return         Word in the byte order of the platform.
+inline uint32_t load_big_endian(const char_t* const data)
+{
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(data);
+    return (static_cast<uint32_t>(bytes[0]) << (3 * bits_per_byte)) |
+           (static_cast<uint32_t>(bytes[1]) << (2 * bits_per_byte)) |
+           (static_cast<uint32_t>(bytes[2]) << bits_per_byte) |
+           static_cast<uint32_t>(bytes[3]);
+}
+
+//! Signature of the functions, which process complete blocks.
+using process_function = void (*)(sha256_state&, const char_t*, size_t);
+
+#if defined(__x86_64__)
+
+//! @brief Processes complete blocks with the SHA extensions.
+//!
+//! The state is kept in the order ABEF and CDGH as expected by the
+//! instructions. Each sha256rnds2 instruction performs two rounds and the
+//! message schedule of four words is calculated by sha256msg1 and sha256msg2.
+//! @param[in,out] state  State before and after processing the blocks.
+//! @param[in]     data   Blocks to process.
+//! @param[in]     blocks Number of blocks.
+__attribute__((target("sha,ssse3,sse4.1"))) void process_with_instructions(
+    sha256_state& state, const char_t* data, size_t blocks)
+{
+    static const size_t words_per_vector = 4;
+    static const size_t vectors_per_block = block_size / sizeof(__m128i);
+
+    // converts the big endian words of the message
+    const __m128i byte_order =
+        _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i hgfe = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&state[words_per_vector]));
+    const __m128i cdab = _mm_shuffle_epi32(dcba, 0xB1);
+    const __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1B);
+    __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+    while (blocks > 0) {
+        const __m128i previous_abef = abef;
+        const __m128i previous_cdgh = cdgh;
+
+        // std::array would drop the alignment attribute of the vector type
+        __m128i w[vectors_per_block];
+        for (size_t i = 0; i < (rounds / words_per_vector); i++) {
+            __m128i& words = w[i % vectors_per_block];
+            if (i < vectors_per_block) {
+                words = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                        data + (i * sizeof(__m128i)))),
+                    byte_order);
+            } else {
+                const __m128i& w3 = w[(i + 3) % vectors_per_block];
+                const __m128i& w2 = w[(i + 2) % vectors_per_block];
+                const __m128i& w1 = w[(i + 1) % vectors_per_block];
+                words = _mm_sha256msg2_epu32(
+                    _mm_add_epi32(_mm_sha256msg1_epu32(words, w1),
+                                  _mm_alignr_epi8(w3, w2, 4)),
+                    w3);
+            }
+
+            __m128i message = _mm_add_epi32(
+                words, _mm_load_si128(reinterpret_cast<const __m128i*>(
+                           &k[i * words_per_vector])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+            message = _mm_shuffle_epi32(message, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+        }
+
+        abef = _mm_add_epi32(abef, previous_abef);
+        cdgh = _mm_add_epi32(cdgh, previous_cdgh);
+        data += block_size;
+        blocks--;
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    dcba = _mm_blend_epi16(feba, dchg, 0xF0);
+    hgfe = _mm_alignr_epi8(dchg, feba, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), dcba);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[words_per_vector]),
+                     hgfe);
+}
+
+//! @brief Selects the fastest implementation, that the processor supports.
+//!
+//! @return Function to process blocks.
+process_function select_process_function(void)
+{
+    const bool supported = (0 != __builtin_cpu_supports("sha")) &&
+                           (0 != __builtin_cpu_supports("sse4.1"));
+    return supported ? &process_with_instructions
+                     : &detail::process_sha256_portable;
+}
+
+#else
+
+//! @brief Selects the fastest implementation, that the processor supports.
+//!
+//! @return Function to process blocks.
+process_function select_process_function(void)
+{
+    return &detail::process_sha256_portable;
+}
+
+#endif
+
+} // namespace
+
+sha256_context::sha256_context(void)
+    : state_(initial_state)
+    , block_()
+    , block_length_(0)
+    , size_(0)
+{
+}
+
+void sha256_context::update(const char_t* const data, const size_t size)
+{
+    size_t offset = 0;
+
+    // completes the block of the previous parts first
+    if (block_length_ > 0) {
+        offset = std::min(size, block_.size() - block_length_);
+        std::copy(data, data + offset, block_.begin() + block_length_);
+        block_length_ += offset;
+        if (block_length_ == block_.size()) {
+            detail::process_sha256(state_, block_.data(), 1);
+            block_length_ = 0;
+        }
+    }
+
+    // complete blocks are processed at once without copying them
+    const size_t blocks = (size - offset) / block_.size();
+    detail::process_sha256(state_, data + offset, blocks);
+    offset += blocks * block_.size();
+
+    std::copy(data + offset, data + size, block_.begin() + block_length_);
+    block_length_ += size - offset;
+    size_ += size;
+}
+
+sha256_array sha256_context::finish(void)
+{
+    static const uint8_t first_padding_byte = 0x80U;
+
+    // if there is not enough space to append the size, it is filled into
+    // another block
+    std::array<char_t, 2 * block_size> tail;
+    const size_t tail_blocks =
+        (block_length_ < (block_size - size_of_size)) ? 1 : 2;
+    const size_t size_begin = (tail_blocks * block_size) - size_of_size;
+
+    std::copy(block_.begin(), block_.begin() + block_length_, tail.begin());
+    tail[block_length_] = static_cast<char_t>(first_padding_byte);
+    std::fill(tail.begin() + block_length_ + 1, tail.begin() + size_begin, 0);
+
+    // the number of bits is stored in big endian order
+    const uint64_t processed_bits = size_ * bits_per_byte;
+    for (size_t i = 0; i < size_of_size; ++i) {
+        const size_t shift = (size_of_size - 1 - i) * bits_per_byte;
+        tail[size_begin + i] = static_cast<char_t>(processed_bits >> shift);
+    }
+    detail::process_sha256(state_, tail.data(), tail_blocks);
+
+    sha256_array result;
+    for (size_t i = 0; i < result.size(); ++i) {
+        const size_t index = i / sizeof(uint32_t);
+        const size_t shift =
+            (sizeof(uint32_t) - 1 - (i % sizeof(uint32_t))) * bits_per_byte;
+        result[i] = static_cast<uint8_t>(state_[index] >> shift);
+    }
+
+    reset();
+    return result;
+}
+
+void sha256_context::reset(void)
+{
+    state_ = initial_state;
+    block_length_ = 0;
+    size_ = 0;
+}
+
+sha256_array calculate_sha256(const char_t* const data, const size_t size)
+{
+    sha256_context context;
+    context.update(data, size);
+    return context.finish();
+}
+
+namespace detail
+{
+
+void process_sha256_portable(sha256_state& state, const char_t* data,
+                             size_t blocks)
+{
+    while (blocks > 0) {
+        std::array<uint32_t, rounds> w;
+        for (size_t i = 0; i < (block_size / sizeof(uint32_t)); i++) {
+            w[i] = load_big_endian(data + (i * sizeof(uint32_t)));
+        }
+        for (size_t i = (block_size / sizeof(uint32_t)); i < rounds; i++) {
+            const uint32_t s0 = rotate_right(w[i - 15], 7) ^
+                                rotate_right(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotate_right(w[i - 2], 17) ^
+                                rotate_right(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        sha256_state v = state;
+        for (size_t i = 0; i < rounds; i++) {
+            const uint32_t s1 = rotate_right(v[4], 6) ^
+                                rotate_right(v[4], 11) ^ rotate_right(v[4], 25);
+            const uint32_t ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
+            const uint32_t t1 = v[7] + s1 + ch + k[i] + w[i];
+            const uint32_t s0 = rotate_right(v[0], 2) ^
+                                rotate_right(v[0], 13) ^ rotate_right(v[0], 22);
+            const uint32_t maj =
+                (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+            const uint32_t t2 = s0 + maj;
+
+            v[7] = v[6];
+            v[6] = v[5];
+            v[5] = v[4];
+            v[4] = v[3] + t1;
+            v[3] = v[2];
+            v[2] = v[1];
+            v[1] = v[0];
+            v[0] = t1 + t2;
+        }
+
+        for (size_t i = 0; i < state.size(); i++) {
+            state[i] += v[i];
+        }
+        data += block_size;
+        blocks--;
+    }
+}
+
+void process_sha256(sha256_state& state, const char_t* const data,
+                    const size_t blocks)
+{
+    static const process_function process = select_process_function();
+    if (blocks > 0) {
+        process(state, data, blocks);
+    }
+}
+
+} // namespace detail
+
+} // namespace hutzn
@@ -0,0 +1,114 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_REQUEST_SHA256_HPP
+#define LIBHUTZNOHMD_REQUEST_SHA256_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "libhutznohmd/types.hpp"
+
+namespace hutzn
+{
+
+//! Number of bytes in a sha-256 sum.
+static const std::size_t sha256_size = 32;
+
+//! Type that stores a sha-256 sum.
+using sha256_array = std::array<uint8_t, sha256_size>;
+
+//! Stores the intermediate state of the sha-256 algorithm.
+using sha256_state = std::array<uint32_t, 8>;
+
+//! @brief Calculates the SHA-256 sum of a message, which arrives in parts.
+//!
+//! Works like the @ref md5_context. The blocks are processed with the SHA
+//! extensions of the processor, when they are available, and portably
+//! otherwise.
+class sha256_context
+{
+public:
+    //! Starts a new message.
+    sha256_context(void);
+
+    //! @brief Appends a part of the message.
+    //!
+    //! @param[in] data Pointer to the part of the message.
+    //! @param[in] size Size of the part.
+    void update(const char_t* const data, const std::size_t size);
+
+    //! @brief Pads the message and returns its SHA-256 sum.
+    //!
+    //! The context starts a new message afterwards.
+    //! @return Array of 32 bytes, that contains the digest.
+    sha256_array finish(void);
+
+    //! Discards all parts of the message and starts a new one.
+    void reset(void);
+
+private:
+    //! Number of bytes in a block, which is the unit of the sha-256 algorithm.
+    static const std::size_t block_size = 64;
+
+    //! State after all complete blocks processed so far.
+    sha256_state state_;
+
+    //! Stores the bytes of the incomplete block.
+    std::array<char_t, block_size> block_;
+
+    //! Number of bytes in the incomplete block.
+    std::size_t block_length_;
+
+    //! Size of the message so far.
+    uint64_t size_;
+};
+
+//! @brief Calculates the SHA-256 sum of a given vector of bytes.
+//!
+//! @param[in] data Pointer to the data to calculate.
+//! @param[in] size Size of the data.
+//! @return         Array of 32 bytes, that contains the digest.
+sha256_array calculate_sha256(const char_t* const data,
+                              const std::size_t size);
+
+namespace detail
+{
+
+//! @brief Processes complete blocks without any processor extension.
+//!
+//! Is the fallback of the @ref sha256_context.
+//! @param[in,out] state  State before and after processing the blocks.
+//! @param[in]     data   Blocks to process.
+//! @param[in]     blocks Number of blocks.
+void process_sha256_portable(sha256_state& state, const char_t* data,
+                             std::size_t blocks);
+
+//! @brief Processes complete blocks with the fastest available instructions.
+//!
+//! @param[in,out] state  State before and after processing the blocks.
+//! @param[in]     data   Blocks to process.
+//! @param[in]     blocks Number of blocks.
+void process_sha256(sha256_state& state, const char_t* const data,
+                    const std::size_t blocks);
+
+} // namespace detail
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_REQUEST_SHA256_HPP
@@ -18,13 +18,15 @@
 
 #include "timestamp.hpp"
 
+#include <array>
 #include <cstring>
+#include <tuple>
 
 #include "utility/common.hpp"
 #include "utility/date_calculation.hpp"
+#include "utility/keyword_table.hpp"
 #include "utility/parsing.hpp"
 #include "utility/select_char_map.hpp"
-#include "utility/trie.hpp"
 
 namespace hutzn
 {
@@ -37,72 +39,42 @@ static const int32_t minutes_per_hour = 60;
 static const int32_t seconds_per_minute = 60;
 static const int32_t begin_of_19_hundrets = 1900;
 static const int32_t end_of_19_hundrets = 1999;
-static const size_t trie_string_max_length = 16;
 
 //! Consists of the zero-based weekday number, which starts at sunday and a
 //! boolean, that is true when it is a long dayname.
 using weekday_value_type = std::tuple<int8_t, bool>;
 
-//! @brief Makes a newly created weekday trie.
-//!
-//! @param[out] max_size Maximum size of inserted strings.
-//! @return              Trie of weekday and length tuple.
-trie<weekday_value_type> make_weekday_trie(size_t& max_size)
-{
-    trie<weekday_value_type> result{true};
-
-    // filling versions and automatically calculate the maximum length
-    max_size = 0;
-    static const std::vector<std::pair<const char_t* const, weekday_value_type>>
-        weekdays = {std::make_pair("sun", weekday_value_type{0, false}),
-                    std::make_pair("sunday", weekday_value_type{0, true}),
-                    std::make_pair("mon", weekday_value_type{1, false}),
-                    std::make_pair("monday", weekday_value_type{1, true}),
-                    std::make_pair("tue", weekday_value_type{2, false}),
-                    std::make_pair("tuesday", weekday_value_type{2, true}),
-                    std::make_pair("wed", weekday_value_type{3, false}),
-                    std::make_pair("wednesday", weekday_value_type{3, true}),
-                    std::make_pair("thu", weekday_value_type{4, false}),
-                    std::make_pair("thursday", weekday_value_type{4, true}),
-                    std::make_pair("fri", weekday_value_type{5, false}),
-                    std::make_pair("friday", weekday_value_type{5, true}),
-                    std::make_pair("sat", weekday_value_type{6, false}),
-                    std::make_pair("saturday", weekday_value_type{6, true})};
-    for (const std::pair<const char_t* const, weekday_value_type>& pair :
-         weekdays) {
-        result.insert(pair.first, pair.second);
-        max_size =
-            std::max(max_size, ::strnlen(pair.first, trie_string_max_length));
-    }
-
-    return result;
-}
-
-//! @brief Makes a newly created month trie.
-//!
-//! @param[out] max_size Maximum size of inserted strings.
-//! @return              Trie of one-based month tuple.
-trie<int32_t> make_month_trie(size_t& max_size)
-{
-    trie<int32_t> result{true};
-
-    // filling versions and automatically calculate the maximum length
-    max_size = 0;
-    static const std::vector<std::pair<const char_t* const, int32_t>> months = {
-        std::make_pair("jan", 1),  std::make_pair("feb", 2),
-        std::make_pair("mar", 3),  std::make_pair("apr", 4),
-        std::make_pair("may", 5),  std::make_pair("jun", 6),
-        std::make_pair("jul", 7),  std::make_pair("aug", 8),
-        std::make_pair("sep", 9),  std::make_pair("oct", 10),
-        std::make_pair("nov", 11), std::make_pair("dec", 12)};
-    for (const std::pair<const char_t* const, int32_t>& pair : months) {
-        result.insert(pair.first, pair.second);
-        max_size =
-            std::max(max_size, ::strnlen(pair.first, trie_string_max_length));
-    }
-
-    return result;
-}
+//! Short and long weekday names.
+static constexpr keyword_table<weekday_value_type, 14> weekdays{
+    {{{"sun", weekday_value_type{0, false}},
+      {"sunday", weekday_value_type{0, true}},
+      {"mon", weekday_value_type{1, false}},
+      {"monday", weekday_value_type{1, true}},
+      {"tue", weekday_value_type{2, false}},
+      {"tuesday", weekday_value_type{2, true}},
+      {"wed", weekday_value_type{3, false}},
+      {"wednesday", weekday_value_type{3, true}},
+      {"thu", weekday_value_type{4, false}},
+      {"thursday", weekday_value_type{4, true}},
+      {"fri", weekday_value_type{5, false}},
+      {"friday", weekday_value_type{5, true}},
+      {"sat", weekday_value_type{6, false}},
+      {"saturday", weekday_value_type{6, true}}}}};
+
+//! Short month names and their one-based numbers.
+static constexpr keyword_table<int32_t, 12> months{
+    {{{"jan", 1},
+      {"feb", 2},
+      {"mar", 3},
+      {"apr", 4},
+      {"may", 5},
+      {"jun", 6},
+      {"jul", 7},
+      {"aug", 8},
+      {"sep", 9},
+      {"oct", 10},
+      {"nov", 11},
+      {"dec", 12}}}};
 
 //! @brief Parses a time format and returns the second of the day.
 //!
@@ -164,13 +136,11 @@ int32_t parse_time(const char_t*& data, size_t& remaining)
 //! @return                  1-based month of the year.
 int32_t parse_month(const char_t*& data, size_t& remaining)
 {
-    static size_t maximum_month_length = 0;
-    static const trie<int32_t> months = make_month_trie(maximum_month_length);
-
-    trie_find_result<int32_t> result = months.find(data, remaining);
-    data += result.used_size();
-    remaining -= result.used_size();
-    return result.value();
+    int32_t result = 0;
+    const size_t used_size = months.find_prefix(data, remaining, result);
+    data += used_size;
+    remaining -= used_size;
+    return result;
 }
 
 //! @brief Checks if the rest of the data begins with 'gmt' in a case
@@ -305,6 +275,191 @@ time_t parse_asctime_date_time(const char_t*& data, size_t& remaining)
         static_cast<uint8_t>(month), static_cast<uint16_t>(year));
 }
 
+//! Layout of an IMF-fixdate. The underscores are variable characters.
+static const char_t imf_fixdate_layout[] = "___, __ ___ ____ __:__:__ GMT";
+
+//! Marks the fixed characters of an IMF-fixdate.
+static const char_t imf_fixdate_fixed[] =
+    "\x00\x00\x00\xFF\xFF\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\x00\xFF"
+    "\x00\x00\xFF\x00\x00\xFF\x00\x00\xFF\xFF\xFF\xFF";
+
+//! Marks the digits of an IMF-fixdate.
+static const char_t imf_fixdate_digits[] =
+    "\x00\x00\x00\x00\x00\xFF\xFF\x00\x00\x00\x00\x00\xFF\xFF\xFF\xFF\x00"
+    "\xFF\xFF\x00\xFF\xFF\x00\xFF\xFF\x00\x00\x00\x00";
+
+//! Offsets of the words, which cover an IMF-fixdate. The last word overlaps
+//! the previous one.
+static const std::array<size_t, 4> imf_fixdate_words = {
+    {0, sizeof(uint64_t), 2 * sizeof(uint64_t),
+     imf_fixdate_length - sizeof(uint64_t)}};
+
+static_assert(sizeof(imf_fixdate_layout) == (imf_fixdate_length + 1),
+              "layout must have the length of an IMF-fixdate");
+static_assert(sizeof(imf_fixdate_fixed) == (imf_fixdate_length + 1),
+              "mask must have the length of an IMF-fixdate");
+static_assert(sizeof(imf_fixdate_digits) == (imf_fixdate_length + 1),
+              "mask must have the length of an IMF-fixdate");
+
+//! Has the same value in each byte of a word.
+static const uint64_t all_bytes = ~static_cast<uint64_t>(0) / 0xFF;
+
+//! Has the highest bit of each byte of a word set.
+static const uint64_t high_bits = all_bytes * 0x80;
+
+//! Entry of a table, which maps a name of 3 characters to a number.
+struct packed_name
+{
+    //! Characters of the name packed into a word.
+    uint32_t key;
+
+    //! Number of the name or -1 for an unused entry.
+    int32_t value;
+};
+
+//! Maps the packed short month names to their one-based numbers. The index is
+//! a perfect hash of the packed name.
+static const std::array<packed_name, 16> packed_months = {
+    {{0x766F4EU, 11}, {0x6E614AU, 1},  {0x74634FU, 10}, {0x727041U, 4},
+     {0x79614DU, 5},  {0x706553U, 9},  {0x72614DU, 3},  {0, -1},
+     {0x636544U, 12}, {0x6E754AU, 6},  {0x677541U, 8},  {0, -1},
+     {0x6C754AU, 7},  {0, -1},         {0x626546U, 2},  {0, -1}}};
+
+//! Multiplier of the perfect hash of packed month names.
+static const uint32_t month_hash_multiplier = 3868420039U;
+
+//! Maps the packed short weekday names to their zero-based numbers. The index
+//! is a perfect hash of the packed name.
+static const std::array<packed_name, 8> packed_weekdays = {
+    {{0x697246U, 5}, {0x6E6F4DU, 1}, {0x6E7553U, 0}, {0x746153U, 6},
+     {0x756854U, 4}, {0, -1},        {0x646557U, 3}, {0x657554U, 2}}};
+
+//! Multiplier of the perfect hash of packed weekday names.
+static const uint32_t weekday_hash_multiplier = 2522U;
+
+//! @brief Reads a word from memory of any alignment.
+//!
+//! @param[in] data Pointer to the first byte of the word.
+//! @return         Word in the byte order of the platform.
+inline uint64_t load_word(const char_t* const data)
+{
+    uint64_t result;
+    ::memcpy(&result, data, sizeof(result));
+    return result;
+}
+
+//! @brief Packs a name of 3 characters into a word.
+//!
+//! @param[in] data Pointer to the name.
+//! @return         Packed name, which does not depend on the byte order.
+inline uint32_t pack_name(const char_t* const data)
+{
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(data);
+    return static_cast<uint32_t>(bytes[0]) |
+           (static_cast<uint32_t>(bytes[1]) << bits_per_byte) |
+           (static_cast<uint32_t>(bytes[2]) << (2 * bits_per_byte));
+}
+
+//! @brief Looks up a packed name in a table with a perfect hash.
+//!
+//! @param[in] table      Table of the names.
+//! @param[in] multiplier Multiplier of the perfect hash.
+//! @param[in] data       Pointer to the name.
+//! @return               Number of the name or -1 if the name is unknown.
+template <size_t size>
+inline int32_t find_packed_name(const std::array<packed_name, size>& table,
+                                const uint32_t multiplier,
+                                const char_t* const data)
+{
+    static_assert((size & (size - 1)) == 0, "size must be a power of two");
+    static const size_t shift = (sizeof(uint32_t) * bits_per_byte) -
+                                static_cast<size_t>(__builtin_ctzll(size));
+
+    const uint32_t key = pack_name(data);
+    const packed_name& entry = table[(key * multiplier) >> shift];
+    return (entry.key == key) ? entry.value : -1;
+}
+
+//! @brief Converts two validated digits into their value.
+//!
+//! @param[in] data Pointer to the first digit.
+//! @return         Value of both digits.
+inline int32_t two_digits(const char_t* const data)
+{
+    return (decimal_base * (data[0] - '0')) + (data[1] - '0');
+}
+
+//! @brief Parses an IMF-fixdate like "Sun, 06 Nov 1994 08:49:37 GMT".
+//!
+//! The date has a fixed layout, which is checked by comparing whole words
+//! against the layout. All digits of a word are validated at once by
+//! detecting bytes outside of the range of digits. Names in other cases or
+//! additional whitespace are not accepted, but are handled by the general
+//! parser.
+//! @param[in] data   Points to the begin of the string.
+//! @param[in] length Number of bytes of the string.
+//! @return           Number of seconds since epoch, -1 on an invalid date or
+//!                   -2 when the string is no IMF-fixdate.
+time_t parse_imf_fixdate(const char_t* const data, const size_t length)
+{
+    bool valid = (length >= imf_fixdate_length);
+    for (size_t i = 0; valid && (i < imf_fixdate_words.size()); i++) {
+        const size_t offset = imf_fixdate_words[i];
+        const uint64_t word = load_word(data + offset);
+        const uint64_t fixed = load_word(imf_fixdate_fixed + offset);
+        const uint64_t digits = load_word(imf_fixdate_digits + offset);
+        const uint64_t layout = load_word(imf_fixdate_layout + offset);
+
+        // non-digit bytes are replaced by '0' to validate all bytes at once
+        const uint64_t number = (word & digits) | (('0' * all_bytes) & ~digits);
+        const uint64_t value = number - ('0' * all_bytes);
+        const uint64_t beyond_nine = value + ((0x80 - 10) * all_bytes);
+        valid = ((word & fixed) == (layout & fixed)) &&
+                (0 == ((value | beyond_nine) & high_bits));
+    }
+
+    time_t result = -2;
+    if (valid) {
+        const int32_t weekday =
+            find_packed_name(packed_weekdays, weekday_hash_multiplier, data);
+        const int32_t month =
+            find_packed_name(packed_months, month_hash_multiplier, data + 8);
+        if ((weekday >= 0) && (month > 0)) {
+            const int32_t day = two_digits(data + 5);
+            const int32_t year =
+                (decimal_base * decimal_base * two_digits(data + 12)) +
+                two_digits(data + 14);
+            const int32_t hour = two_digits(data + 17);
+            const int32_t minute = two_digits(data + 20);
+            const int32_t second = two_digits(data + 23);
+
+            result = -1;
+            if ((hour < hours_per_day) && (minute < minutes_per_hour) &&
+                (second < seconds_per_minute)) {
+                const int32_t second_of_day =
+                    (seconds_per_minute *
+                     ((minutes_per_hour * hour) + minute)) +
+                    second;
+                result = seconds_since_epoch(
+                    static_cast<uint32_t>(second_of_day),
+                    static_cast<uint8_t>(day), static_cast<uint8_t>(month),
+                    static_cast<uint16_t>(year));
+            }
+        }
+    }
+    return result;
+}
+
+//! @brief Writes a number of two digits.
+//!
+//! @param[in]  value       Number in the range of [0..99].
+//! @param[out] destination Pointer to the first digit.
+inline void write_two_digits(const uint32_t value, char_t* const destination)
+{
+    destination[0] = static_cast<char_t>('0' + (value / decimal_base));
+    destination[1] = static_cast<char_t>('0' + (value % decimal_base));
+}
+
 //! @brief Parses a weekday from a string and return its number expression.
 //!
 //! @param[in,out] data      Points to the begin of the string.
@@ -312,22 +467,36 @@ time_t parse_asctime_date_time(const char_t*& data, size_t& remaining)
 //! @return                  Weekday and boolean, that indicates a long format.
 weekday_value_type parse_weekday(const char_t*& data, size_t& remaining)
 {
-    static size_t maximum_weekday_length = 0;
-    static const trie<weekday_value_type> weekdays =
-        make_weekday_trie(maximum_weekday_length);
-
     skip_whitespace(data, remaining);
-    trie_find_result<weekday_value_type> result =
-        weekdays.find(data, remaining);
-    data += result.used_size();
-    remaining -= result.used_size();
-    return result.value();
+    weekday_value_type result{0, false};
+    const size_t used_size = weekdays.find_prefix(data, remaining, result);
+    data += used_size;
+    remaining -= used_size;
+    return result;
 }
 
 } // namespace
 
 time_t parse_timestamp(const char_t* data, size_t length)
 {
+    // nearly all clients send the same date in consecutive requests
+    thread_local std::array<char_t, imf_fixdate_length> last_date{};
+    thread_local time_t last_timestamp = -1;
+
+    if ((length >= imf_fixdate_length) && (last_timestamp >= 0) &&
+        (0 == ::memcmp(data, last_date.data(), imf_fixdate_length))) {
+        return last_timestamp;
+    }
+
+    const time_t timestamp = parse_imf_fixdate(data, length);
+    if (timestamp >= 0) {
+        ::memcpy(last_date.data(), data, imf_fixdate_length);
+        last_timestamp = timestamp;
+    }
+    if (timestamp != -2) {
+        return timestamp;
+    }
+
     int32_t weekday = -1;
     int32_t is_long_format = false;
     std::tie(weekday, is_long_format) = parse_weekday(data, length);
@@ -344,4 +513,38 @@ time_t parse_timestamp(const char_t* data, size_t length)
     }
 }
 
+size_t format_timestamp(const time_t timestamp, char_t* const destination)
+{
+    static const std::array<char_t[4], 7> weekday_names = {
+        {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"}};
+    static const std::array<char_t[4], 12> month_names = {
+        {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct",
+         "Nov", "Dec"}};
+    static const uint32_t seconds_per_hour =
+        minutes_per_hour * seconds_per_minute;
+
+    size_t result = 0;
+    epoch_date date;
+    if (date_since_epoch(timestamp, date)) {
+        // all variable characters are written into the layout
+        ::memcpy(destination, imf_fixdate_layout, imf_fixdate_length);
+        ::memcpy(destination, weekday_names[date.weekday], 3);
+        write_two_digits(date.day, destination + 5);
+        ::memcpy(destination + 8, month_names[date.month - 1], 3);
+        write_two_digits(date.year / (decimal_base * decimal_base),
+                         destination + 12);
+        write_two_digits(date.year % (decimal_base * decimal_base),
+                         destination + 14);
+        write_two_digits(date.second_of_day / seconds_per_hour,
+                         destination + 17);
+        write_two_digits((date.second_of_day / seconds_per_minute) %
+                             minutes_per_hour,
+                         destination + 20);
+        write_two_digits(date.second_of_day % seconds_per_minute,
+                         destination + 23);
+        result = imf_fixdate_length;
+    }
+    return result;
+}
+
 } // namespace hutzn
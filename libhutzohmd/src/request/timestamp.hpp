@@ -26,6 +26,9 @@
 namespace hutzn
 {
 
+//! Number of characters of an IMF-fixdate (RFC 7231).
+static const size_t imf_fixdate_length = 29;
+
 //! @brief Parses a RFC 850, RFC 1123 or ASCII-time timestamp from a string.
 //!
 //! The data pointer and the length will be modified. On success the data
@@ -38,6 +41,17 @@ namespace hutzn
 //! @return               Timestamp in epoch time or -1 on error.
 time_t parse_timestamp(const char_t* data, size_t length);
 
+//! @brief Formats a timestamp as IMF-fixdate like
+//! "Sun, 06 Nov 1994 08:49:37 GMT".
+//!
+//! This is the preferred format of RFC 7231 and the only one, that should be
+//! sent. The destination is not null-terminated.
+//! @param[in]  timestamp   Timestamp in epoch time.
+//! @param[out] destination Buffer of at least imf_fixdate_length characters.
+//! @return                 Number of written characters, which is 0 when the
+//!                         timestamp is before 1970 or after 2099.
+size_t format_timestamp(const time_t timestamp, char_t* const destination);
+
 } // namespace hutzn
 
 #endif // LIBHUTZNOHMD_REQUEST_TIMESTAMP_HPP
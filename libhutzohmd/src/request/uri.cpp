@@ -18,12 +18,20 @@
 
 #include "uri.hpp"
 
+#include <array>
+#include <cstring>
+#include <limits>
 #include <tuple>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "request/normalized_path_cache.hpp"
 #include "utility/character_validation.hpp"
+#include "utility/common.hpp"
+#include "utility/keyword_table.hpp"
 #include "utility/parsing.hpp"
-#include "utility/select_char_map.hpp"
-#include "utility/trie.hpp"
 
 namespace hutzn
 {
@@ -31,250 +39,403 @@ namespace hutzn
 namespace
 {
 
-//! @brief Makes and returns a newly created scheme trie.
-//!
-//! @return Trie of uri scheme, port tuples.
-trie<std::tuple<uri_scheme, uint16_t>> make_scheme_trie()
-{
-    using value_type = std::tuple<uri_scheme, uint16_t>;
-    static const value_type http_value{uri_scheme::HTTP, 80};
-    static const value_type https_value{uri_scheme::HTTPS, 443};
-
-    trie<value_type> t{true};
-    t.insert("http", http_value);
-    t.insert("https", https_value);
-    return t;
-}
+//! Consists of the uri scheme and its default port.
+using scheme_value_type = std::tuple<uri_scheme, uint16_t>;
+
+//! Supported uri schemes.
+static constexpr keyword_table<scheme_value_type, 2> schemes{
+    {{{"http", scheme_value_type{uri_scheme::HTTP, 80}},
+      {"https", scheme_value_type{uri_scheme::HTTPS, 443}}}}};
+
+//! Marks an index, that was not found.
+static const size_t no_index = std::numeric_limits<size_t>::max();
+
+//! Number of characters of a percent-encoded character.
+static const size_t char_encoding_size = 3;
 
-//! @brief Consumes one character.
+//! Number of different characters.
+static constexpr size_t char_count =
+    static_cast<size_t>(std::numeric_limits<uint8_t>::max()) + 1;
+
+//! @brief Returns a table, which marks the selected characters.
 //!
-//! This will set the data pointer one character forth and decreases the
-//! remaining size.
-//! @warning There is no over- or underflow checking.
-//! @param[in,out] data      Points to a buffer.
-//! @param[in,out] remaining Remaining size of the buffer.
-void consume_one_character(const char_t*& data, size_t& remaining)
+//! @return Table of all characters, where only the selected ones are true.
+template <char_t... selected>
+constexpr std::array<bool, char_count> make_selection_table(void)
 {
-    data++;
-    remaining--;
+    std::array<bool, char_count> result{};
+    ((result[static_cast<uint8_t>(selected)] = true), ...);
+    return result;
 }
 
-//! @brief Reverts one character consumation.
+//! Marks the selected characters of find_first_of. It is built at compile
+//! time, therefore scanning needs no guard of a static initialization.
+template <char_t... selected>
+static constexpr std::array<bool, char_count> selection_table =
+    make_selection_table<selected...>();
+
+//! @brief Returns true, when a character behind a slash could start a
+//! segment, which has to be removed by normalizing the path.
 //!
-//! This will set the data pointer one character backwards and increases the
-//! remaining size.
-//! @warning There is no over- or underflow checking.
-//! @param[in,out] data      Points to a buffer.
-//! @param[in,out] remaining Remaining size of the buffer.
-void unconsume_one_character(char_t*& data, size_t& remaining)
+//! @param[in] ch Character behind a slash.
+//! @return       True for a dot or another slash.
+inline bool is_path_marker(const char_t ch)
 {
-    data--;
-    remaining++;
+    return ('.' == ch) || ('/' == ch);
 }
 
-//! @brief Converts a percent encoded character into a byte.
+//! @brief Returns the index of the first selected character.
 //!
-//! @warning Expects, that at least 2 more bytes after the current one will
-//! follow and that the current character is a "percent".
-//! @param[in] source                Source pointer where to read the characters
-//!                                  from.
-//! @param[in,out] destination       Points to the destination buffer of the
-//!                                  converted character.
-//! @param[in,out] source_index      Current index in the source buffer.
-//! @param[in,out] destination_index Current index in the destination buffer.
-//! @return True if the conversion was successful and false when not.
-inline bool convert_char(const char_t* const source, char_t*& destination,
-                         size_t& source_index, size_t& destination_index)
+//! Compares 16 characters at once on x86-64, where SSE2 is always available,
+//! and the remaining characters one by one. Optionally detects slashes, which
+//! are followed by a dot or another slash, on the way. Only a path containing
+//! one of them could contain a dot segment or an empty segment.
+//! @param[in]     data       Points to the characters.
+//! @param[in]     begin      Index of the first character to check.
+//! @param[in]     length     Number of characters.
+//! @param[in,out] has_marker Is set to true, when a slash is followed by a dot
+//!                           or another slash in front of the selected
+//!                           character. Nothing is detected, when it is NULL.
+//! @return                   Index of the first selected character or the
+//!                           length, when there is none.
+template <char_t... selected>
+size_t find_first_of(const char_t* const data, const size_t begin,
+                     const size_t length, bool* const has_marker = NULL)
 {
-    static const uint8_t hex_digit_count = 16;
+    size_t result = begin;
+    bool found = false;
+#if defined(__x86_64__)
+    // a slash in the last byte of a block is carried into the next block
+    uint32_t slash_carry = 0;
+    while ((false == found) && ((result + sizeof(__m128i)) <= length)) {
+        const __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + result));
+        __m128i matches = _mm_setzero_si128();
+        ((matches = _mm_or_si128(
+              matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(selected)))),
+         ...);
+        const uint32_t mask =
+            static_cast<uint32_t>(_mm_movemask_epi8(matches));
+
+        if (NULL != has_marker) {
+            const uint32_t slashes = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(block, _mm_set1_epi8('/'))));
+            const uint32_t dots = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(block, _mm_set1_epi8('.'))));
+            uint32_t markers =
+                ((slashes << 1) | slash_carry) & (slashes | dots);
+
+            // markers behind the selected character belong to the next part
+            if (0 != mask) {
+                markers &= (mask & (~mask + 1)) - 1;
+            }
+            *has_marker = *has_marker || (0 != markers);
+            slash_carry = slashes >> (sizeof(__m128i) - 1);
+        }
 
-    bool is_error;
-
-    // skip the percent character
-    source_index++;
-
-    // get the first hex-digit
-    uint8_t a = static_cast<uint8_t>(from_hex(source[source_index]));
-    source_index++;
-
-    // get the second hex-digit
-    uint8_t b = static_cast<uint8_t>(from_hex(source[source_index]));
-    source_index++;
-
-    // check the hex digits for validity
-    if ((a < hex_digit_count) && (b < hex_digit_count)) {
-        // write it to destination when valid and increase the index once
-        destination[destination_index] =
-            static_cast<char_t>(static_cast<uint8_t>((a << nibble_size) + b));
-        destination_index++;
-        is_error = false;
-    } else {
-        // digits are not valid
-        is_error = true;
+        if (0 != mask) {
+            result += static_cast<size_t>(__builtin_ctz(mask));
+            found = true;
+        } else {
+            result += sizeof(__m128i);
+        }
+    }
+#endif
+    while ((false == found) && (result < length)) {
+        const uint8_t ch = static_cast<uint8_t>(data[result]);
+        found = selection_table<selected...>[ch];
+        if (false == found) {
+            if ((NULL != has_marker) && (result > begin) &&
+                ('/' == data[result - 1]) && is_path_marker(data[result])) {
+                *has_marker = true;
+            }
+            result++;
+        }
     }
-    return is_error;
+    return result;
 }
 
-//! @brief Skips slashes after the sheme part if they are present.
+//! @brief Scans a part of an uri until one of the stop characters.
 //!
-//! @param[in,out] raw       Source buffer.
-//! @param[in,out] remaining Remaining bytes in the source buffer.
-inline void skip_optional_slashes(const char_t*& raw, size_t& remaining)
+//! Whitespaces and the null character stop every part. Percent-encoded
+//! characters are validated on the way.
+//! @param[in]     data        Points to the uri.
+//! @param[in]     length      Length of the uri.
+//! @param[in,out] index       Index of the first character of the part and
+//!                            index of the stop character afterwards.
+//! @param[in,out] has_percent Is set to true, when a percent-encoded
+//!                            character was found.
+//! @param[in,out] has_marker  Optionally detects slashes like @ref
+//!                            find_first_of.
+//! @return                    False, when a percent-encoding is invalid.
+template <char_t... stops>
+bool scan_part(const char_t* const data, const size_t length, size_t& index,
+               bool& has_percent, bool* const has_marker = NULL)
 {
-    // skips character when there are at least two characters to come and both
-    // actually are slashes
-    static const uint8_t optional_slash_size = 2;
-    if ((remaining >= optional_slash_size) && ('/' == raw[0]) &&
-        ('/' == raw[1])) {
-        remaining -= optional_slash_size;
-        raw += optional_slash_size;
+    static const uint8_t hex_digit_count = 16;
+
+    bool result = true;
+    index = find_first_of<'%', stops..., ' ', '\t', '\r', '\n', '\0'>(
+        data, index, length, has_marker);
+    while (result && (index < length) && ('%' == data[index])) {
+        result = ((length - index) >= char_encoding_size) &&
+                 (from_hex(data[index + 1]) < hex_digit_count) &&
+                 (from_hex(data[index + 2]) < hex_digit_count);
+        if (result) {
+            has_percent = true;
+            index = find_first_of<'%', stops..., ' ', '\t', '\r', '\n', '\0'>(
+                data, index + char_encoding_size, length, has_marker);
+        }
     }
+    return result;
 }
 
-//! @brief Parses an uri word.
+//! @brief Decodes the percent-encoded characters of a part in place and
+//! null-terminates it.
 //!
-//! This means all remaining characters get parsed until one of the selected
-//! characters or the end of the string is discovered. The word gets
-//! nullterminated in the destination buffer afterwards.
-//! @param[in,out] source                Points to the source buffer.
-//! @param[in,out] source_remaining      Number of bytes remaining to parse.
-//! @param[in,out] destination           Points to the destination buffer.
-//! @param[in,out] destination_remaining Number of bytes available to write.
-//! @param[in] select_chars              Several character, that will stop
-//!                                      parsing.
-//! @return                              The length of the written word.
-template <typename... tn>
-size_t parse_uri_word(const char_t*& source, size_t& source_remaining,
-                      char_t*& destination, size_t& destination_remaining,
-                      const tn... select_chars)
+//! The percent-encodings must have been validated before. The decoded part is
+//! never longer than the encoded one and the character behind the part is
+//! overwritten by the null-termination.
+//! @param[in,out] data   Points to the uri.
+//! @param[in]     begin  Index of the first character of the part.
+//! @param[in]     end    Index behind the last character of the part.
+//! @param[in]     decode Percent-encoded characters are decoded when true.
+//! @return               View of the decoded part.
+std::string_view finish_part(char_t* const data, const size_t begin,
+                             const size_t end, const bool decode)
 {
-    static const select_char_map map = make_select_char_map(select_chars...);
-
-    size_t head = 0;
-    size_t tail = 0;
-    bool stop = false;
-    while (!stop) {
-        const char_t ch = source[head];
-
-        // if the read character is a stop character it's a reason to stop
-        if ((map[static_cast<uint8_t>(ch)]) || (head >= source_remaining) ||
-            (tail >= destination_remaining)) {
-            stop = true;
-        } else if ('%' == ch) {
-            // in case of a percent-encoding
-            static const uint8_t char_encoding_size = 3;
-            if ((source_remaining - head) >= char_encoding_size) {
-                stop = convert_char(source, destination, head, tail);
+    size_t tail = end;
+    if (decode) {
+        const void* const percent = ::memchr(data + begin, '%', end - begin);
+        if (NULL != percent) {
+            tail = static_cast<size_t>(static_cast<const char_t*>(percent) -
+                                       data);
+        }
+
+        size_t head = tail;
+        while (head < end) {
+            if ('%' == data[head]) {
+                data[tail] = static_cast<char_t>(static_cast<uint8_t>(
+                    (from_hex(data[head + 1]) << nibble_size) +
+                    from_hex(data[head + 2])));
+                head += char_encoding_size;
             } else {
-                tail = 0;
-                stop = true;
+                data[tail] = data[head];
+                head++;
             }
-        } else {
-            // in any other case simply copy the character
-            destination[tail] = source[head];
-            head++;
             tail++;
         }
     }
 
-    // the string gets zero-terminated
-    destination[tail] = '\0';
-    tail++;
-
-    // update pointer and counters
-    source_remaining -= head;
-    destination_remaining -= tail;
-    source += head;
-    destination += tail;
-
-    // the zero-termination will not count for the length of the uri word
-    return tail - 1;
+    data[tail] = '\0';
+    return std::string_view(data + begin, tail - begin);
 }
 
-//! @brief Parses an optional positional token.
-//!
-//! This is either path, query string or fragment. These tokens get parsed, when
-//! a start character is present.
-//! @param[in,out] source                  Points to the source buffer.
-//! @param[in,out] source_remaining        Number of bytes remaining to parse.
-//! @param[in,out] destination             Points to the destination buffer.
-//! @param[in,out] destination_remaining   Number of bytes available to write.
-//! @param[in,out] result_size             Length of the result if not NULL.
-//! @param[in] conditional_start_character Source must start with this character
-//!                                        or the token is not present.
-//! @param[in] skip_one_character          The first character does not get part
-//!                                        of the resultant string in the
-//!                                        destination buffer.
-//! @param[in] select_chars                Several character, that will stop
-//!                                        parsing.
-//! @return                                A pointer to the resultant token.
-template <typename... tn>
-char_t* parse_optional_positional_token(
-    const char_t*& source, size_t& source_remaining, char_t*& destination,
-    size_t& destination_remaining, size_t& result_size,
-    const char_t conditional_start_character, const bool skip_one_character,
-    const tn... select_chars)
+//! @brief Returns true, when a character begins the path, the query string or
+//! the fragment.
+inline bool is_positional_start(const char_t ch)
 {
-    // the token is present when the conditional_start_character is found at the
-    // begin
-    char_t* result = NULL;
-    if ((source_remaining > 0) && (destination_remaining > 0) &&
-        ((*source) == conditional_start_character)) {
-        if (skip_one_character) {
-            consume_one_character(source, source_remaining);
-        }
+    return ('/' == ch) || ('?' == ch) || ('#' == ch);
+}
 
-        char_t* original_destination = destination;
-        size_t length = parse_uri_word(source, source_remaining, destination,
-                                       destination_remaining, select_chars...);
-        result = original_destination;
-        result_size = length;
-    }
-    return result;
+//! @brief Returns true, when a character ends the uri.
+inline bool is_uri_end(const char_t ch)
+{
+    return (' ' == ch) || ('\t' == ch) || ('\r' == ch) || ('\n' == ch) ||
+           ('\0' == ch);
 }
 
 } // namespace
 
 uri::uri(void)
     : scheme_(uri_scheme::UNKNOWN)
-    , userinfo_(NULL)
-    , host_(NULL)
+    , userinfo_()
+    , host_()
     , port_(0)
-    , path_(NULL)
-    , query_(NULL)
-    , fragment_(NULL)
+    , path_()
+    , query_()
+    , fragment_()
 {
 }
 
+std::string_view relocate(const std::string_view& part,
+                          const char_t* const source_data,
+                          const char_t* const data)
+{
+    std::string_view result;
+    if (NULL != part.data()) {
+        result =
+            std::string_view(data + (part.data() - source_data), part.size());
+    }
+    return result;
+}
+
+void uri::reset(void)
+{
+    scheme_ = uri_scheme::UNKNOWN;
+    userinfo_ = std::string_view();
+    host_ = std::string_view();
+    port_ = 0;
+    path_ = std::string_view();
+    query_ = std::string_view();
+    fragment_ = std::string_view();
+}
+
+void uri::relocate(const uri& source, const char_t* const source_data,
+                   const char_t* const data)
+{
+    scheme_ = source.scheme_;
+    userinfo_ = hutzn::relocate(source.userinfo_, source_data, data);
+    host_ = hutzn::relocate(source.host_, source_data, data);
+    port_ = source.port_;
+    path_ = hutzn::relocate(source.path_, source_data, data);
+    query_ = hutzn::relocate(source.query_, source_data, data);
+    fragment_ = hutzn::relocate(source.fragment_, source_data, data);
+}
+
 //! @todo implement RFC 3986 correctly.
-bool uri::parse(const char_t* source, size_t source_length, char_t* destination,
-                size_t destination_length, const bool skip_scheme)
+bool uri::parse(char_t* const data, const size_t length,
+                const bool skip_scheme)
 {
-    bool result = false;
-    static const size_t maximum_uri_enlargement = 3;
-    if (((source_length + maximum_uri_enlargement) <= destination_length) &&
-        (source_length > 0) && (destination_length > 0)) {
-        first_pass_data data;
-        const bool passed_first_pass =
-            parse_1st_pass(source, source_length, destination,
-                           destination_length, data, skip_scheme);
-        result = passed_first_pass;
-        if (passed_first_pass) {
-            // this implementation supports both: uris with and without scheme
-            // or authority
-            // though it is not strictly conforming with RFC 3986 HTTP also
-            // specifies request uris without scheme and authority
-            if ((data.scheme_size > 0) &&
-                (!parse_scheme(data.scheme, data.scheme_size))) {
-                result = false;
+    bool result = (NULL != data) && (length > 0);
+
+    // the scheme and the authority are only known after their delimiter
+    size_t index = 0;
+    size_t scheme_end = no_index;
+    bool scheme_has_percent = false;
+    size_t authority_begin = 0;
+    size_t at = no_index;
+    size_t colon = no_index;
+    bool authority_has_percent = false;
+    if (result && (false == is_positional_start(data[0]))) {
+        bool maybe_scheme = (false == skip_scheme);
+        bool is_authority = true;
+        while (result && is_authority) {
+            result = scan_part<':', '@', '/', '?', '#'>(data, length, index,
+                                                        authority_has_percent);
+            const char_t ch = (index < length) ? data[index] : '\0';
+            if ((':' == ch) && maybe_scheme) {
+                scheme_end = index;
+                scheme_has_percent = authority_has_percent;
+                authority_has_percent = false;
+                index++;
+
+                // skips the slashes in front of the authority
+                static const size_t optional_slash_size = 2;
+                if (((length - index) >= optional_slash_size) &&
+                    ('/' == data[index]) && ('/' == data[index + 1])) {
+                    index += optional_slash_size;
+                }
+                authority_begin = index;
+            } else if (('@' == ch) && (no_index == at)) {
+                // a colon in front of the at sign is part of the userinfo
+                at = index;
+                colon = no_index;
+                index++;
+            } else if ((':' == ch) && (no_index == colon)) {
+                colon = index;
+                index++;
+            } else if ((':' == ch) || ('@' == ch)) {
+                index++;
+            } else {
+                is_authority = false;
             }
-            if ((data.authority_size > 0) &&
-                (!parse_authority(data.authority, data.authority_size))) {
+            maybe_scheme = false;
+        }
+    }
+    const size_t authority_end = index;
+
+    size_t path_begin = no_index;
+    bool path_has_percent = false;
+    bool path_has_marker = false;
+    if (result && (index < length) && ('/' == data[index])) {
+        path_begin = index;
+        result = scan_part<'?', '#'>(data, length, index, path_has_percent,
+                                     &path_has_marker);
+    }
+    const size_t path_end = index;
+
+    // the query string is only validated
+    size_t query_begin = no_index;
+    bool query_has_percent = false;
+    if (result && (index < length) && ('?' == data[index])) {
+        index++;
+        query_begin = index;
+        result = scan_part<'#'>(data, length, index, query_has_percent);
+    }
+    const size_t query_end = index;
+
+    size_t fragment_begin = no_index;
+    bool fragment_has_percent = false;
+    if (result && (index < length) && ('#' == data[index])) {
+        index++;
+        fragment_begin = index;
+        result = scan_part<>(data, length, index, fragment_has_percent);
+    }
+
+    result = result && ((index == length) || is_uri_end(data[index]));
+    if (result) {
+        // this implementation supports both: uris with and without scheme or
+        // authority
+        // though it is not strictly conforming with RFC 3986 HTTP also
+        // specifies request uris without scheme and authority
+        if (no_index != scheme_end) {
+            const std::string_view scheme =
+                finish_part(data, 0, scheme_end, scheme_has_percent);
+            result = parse_scheme(scheme.data(), scheme.size());
+        }
+
+        // the null-termination of the last part overwrites the character
+        // behind the uri and all other delimiters are not needed anymore
+        if (no_index != fragment_begin) {
+            fragment_ =
+                finish_part(data, fragment_begin, index, fragment_has_percent);
+        }
+        if (no_index != query_begin) {
+            query_ = finish_part(data, query_begin, query_end, false);
+        }
+
+        if (authority_end > authority_begin) {
+            size_t host_end = (no_index != colon) ? colon : authority_end;
+            if (path_begin == host_end) {
+                // the path begins with the delimiter of the host, which is why
+                // the authority moves in front of it
+                ::memmove(data + (authority_begin - 1), data + authority_begin,
+                          host_end - authority_begin);
+                authority_begin--;
+                host_end--;
+                if (no_index != at) {
+                    at--;
+                }
+            }
+            const size_t host_begin =
+                (no_index != at) ? (at + 1) : authority_begin;
+            host_ = finish_part(data, host_begin, host_end,
+                                authority_has_percent);
+            if (no_index != at) {
+                userinfo_ = finish_part(data, authority_begin, at,
+                                        authority_has_percent);
+            }
+            if ((no_index != colon) &&
+                (false == parse_port(data + colon + 1,
+                                     authority_end - (colon + 1)))) {
                 result = false;
             }
-            path_ = data.path;
-            query_ = data.query;
-            fragment_ = data.fragment;
+        }
+
+        if (no_index != path_begin) {
+            path_ = finish_part(data, path_begin, path_end, path_has_percent);
+
+            // the path is normalized after decoding, thus encoded dot segments
+            // are removed as well, while most paths are already normalized and
+            // do not contain any marker
+            if (path_has_marker || path_has_percent) {
+                const size_t path_size =
+                    normalized_path_cache::instance().normalize(
+                        data + path_begin, path_.size());
+                data[path_begin + path_size] = '\0';
+                path_ = std::string_view(path_.data(), path_size);
+            }
         }
     }
     return result;
@@ -286,11 +447,21 @@ uri_scheme uri::scheme(void) const
 }
 
 const char_t* uri::userinfo(void) const
+{
+    return userinfo_.data();
+}
+
+std::string_view uri::userinfo_view(void) const
 {
     return userinfo_;
 }
 
 const char_t* uri::host(void) const
+{
+    return host_.data();
+}
+
+std::string_view uri::host_view(void) const
 {
     return host_;
 }
@@ -301,145 +472,51 @@ uint16_t uri::port(void) const
 }
 
 const char_t* uri::path(void) const
+{
+    return path_.data();
+}
+
+std::string_view uri::path_view(void) const
 {
     return path_;
 }
 
 const char_t* uri::query(void) const
+{
+    return query_.data();
+}
+
+std::string_view uri::query_view(void) const
 {
     return query_;
 }
 
 const char_t* uri::fragment(void) const
 {
-    return fragment_;
+    return fragment_.data();
 }
 
-bool uri::parse_1st_pass(const char_t* source, size_t source_length,
-                         char_t* destination, size_t destination_length,
-                         first_pass_data& data, const bool skip_scheme)
+std::string_view uri::fragment_view(void) const
 {
-    static const select_char_map path_query_fragment_map =
-        make_select_char_map('/', '?', '#');
-
-    // first check whether it begins already the path, query string or fragment
-    if (!path_query_fragment_map[static_cast<uint8_t>(*source)]) {
-        char_t* scheme_or_authority_data = destination;
-        size_t length = parse_uri_word(source, source_length, destination,
-                                       destination_length, ':', '/', '?', '#',
-                                       ' ', '\t', '\r', '\n', '\0');
-
-        // check if this is the scheme or the authority part
-        char_t* authority_data;
-        if ((!skip_scheme) && (':' == (*source))) {
-            data.scheme = scheme_or_authority_data;
-            data.scheme_size = length;
-            length = 0;
-            consume_one_character(source, source_length);
-
-            skip_optional_slashes(source, source_length);
-            authority_data = destination;
-        } else {
-            // unconsume one character when a user:password phrase was found
-            if (':' == (*source)) {
-                unconsume_one_character(destination, destination_length);
-            }
-            authority_data = scheme_or_authority_data;
-        }
-
-        // if the authority part was not already parsed
-        if (!path_query_fragment_map[static_cast<uint8_t>(*source)]) {
-            length += parse_uri_word(source, source_length, destination,
-                                     destination_length, '/', '?', '#', ' ',
-                                     '\t', '\r', '\n', '\0');
-        }
-
-        if (length > 0) {
-            data.authority = authority_data;
-            data.authority_size = length;
-        }
-    }
-
-    // parse path
-    data.path = parse_optional_positional_token(
-        source, source_length, destination, destination_length, data.path_size,
-        '/', false, '?', '#', ' ', '\t', '\r', '\n', '\0');
-
-    // parse query string
-    data.query = parse_optional_positional_token(
-        source, source_length, destination, destination_length, data.query_size,
-        '?', true, '#', ' ', '\t', '\r', '\n', '\0');
-
-    // parse fragment
-    data.fragment = parse_optional_positional_token(
-        source, source_length, destination, destination_length,
-        data.fragment_size, '#', true, ' ', '\t', '\r', '\n', '\0');
-
-    static const select_char_map empty_map =
-        make_select_char_map(' ', '\t', '\r', '\n', '\0');
-    return (source_length == 0) || empty_map[static_cast<uint8_t>(*source)];
+    return fragment_;
 }
 
 bool uri::parse_scheme(const char_t* const scheme_ptr, const size_t& size)
 {
-    using value_type = std::tuple<uri_scheme, uint16_t>;
-    static const trie<value_type> t = make_scheme_trie();
-
-    auto r = t.find(scheme_ptr, size);
-    if (r.used_size() == size) {
-        std::tie(scheme_, port_) = r.value();
+    scheme_value_type value;
+    if (schemes.find(scheme_ptr, size, value)) {
+        std::tie(scheme_, port_) = value;
     }
 
     return uri_scheme::UNKNOWN != scheme_;
 }
 
-bool uri::parse_authority(char_t* const authority_ptr, const size_t& size)
+bool uri::parse_port(const char_t* port_ptr, size_t size)
 {
-    // there is an ambiguity in the authority part of an uri specified by
-    // RFC 3986: you are not able to correctly split the authority into tokens
-    // without looking ahead n symbols where n is the length of the whole
-    // authority part
-    //
-    // this is because of the symbol ':' that could occur before and after
-    // the '@' symbol which is also optional
-    //
-    // so what's to do if you have found a ':' symbol without an '@' symbol
-    // before: the ':' could be part of the user info or it separates host and
-    // port
-    //
-    // therefore it is easier to perform a 2-pass parsing to determine whether
-    // an '@' symbol occurs or not.
-
     bool result = true;
-
-    char_t* temp_host = authority_ptr;
-    size_t host_size = size;
-    for (size_t i = 0; i < size; i++) {
-        if ('@' == authority_ptr[i]) {
-            authority_ptr[i] = '\0';
-            userinfo_ = authority_ptr;
-            temp_host = authority_ptr + (i + 1);
-            host_size = size - (i + 1);
-            break;
-        }
-    }
-    host_ = temp_host;
-
-    const char_t* temp_port = NULL;
-    size_t port_size = 0;
-    for (size_t i = 0; i < host_size; i++) {
-        if (':' == temp_host[i]) {
-            temp_host[i] = '\0';
-            temp_port = temp_host + (i + 1);
-            port_size = host_size - (i + 1);
-            break;
-        }
-    }
-
-    if (port_size > 0) {
-        int32_t port_number =
-            parse_unsigned_integer<int32_t>(temp_port, port_size);
-        if ((port_size == 0) &&
+    if (size > 0) {
+        int32_t port_number = parse_unsigned_integer<int32_t>(port_ptr, size);
+        if ((size == 0) &&
             (port_number > std::numeric_limits<uint16_t>::min()) &&
             (port_number <= std::numeric_limits<uint16_t>::max())) {
             port_ = static_cast<uint16_t>(port_number);
@@ -447,7 +524,6 @@ bool uri::parse_authority(char_t* const authority_ptr, const size_t& size)
             result = false;
         }
     }
-
     return result;
 }
 
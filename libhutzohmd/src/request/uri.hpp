@@ -20,6 +20,7 @@
 #define LIBHUTZNOHMD_REQUEST_URI_HPP
 
 #include <cstddef>
+#include <string_view>
 
 #include "libhutznohmd/types.hpp"
 
@@ -38,9 +39,22 @@ enum class uri_scheme : uint8_t {
     HTTPS = 2
 };
 
+//! @brief Moves a string from a buffer into a copy of that buffer.
+//!
+//! @param[in] part        String, which points into the source buffer.
+//! @param[in] source_data Begin of the source buffer.
+//! @param[in] data        Begin of the copy.
+//! @return                String at the same offset in the copy or an empty
+//!                        view with NULL data, when the string has NULL data
+//!                        too.
+std::string_view relocate(const std::string_view& part,
+                          const char_t* const source_data,
+                          const char_t* const data);
+
 //! @brief Implements parsing of URIs as specified in RFC 3986.
 //!
-//! It supports only the specified schemes.
+//! It supports only the specified schemes. The uri is parsed in a single pass
+//! directly in its own buffer and all parts point into it.
 class uri
 {
 public:
@@ -52,25 +66,39 @@ public:
     explicit uri(const uri& rhs) = delete;
     uri& operator=(const uri& rhs) = delete;
 
-    //! @brief Parses an uri string.
-    //!
-    //! Disassembles the uri string, by nullterminating its parts and parsing
-    //! the scheme into an enum value. The disassembled parts may need at most
-    //! 3 bytes more of space, than the original source data. Therefore a
-    //! destination string buffer has to be provided, that must be at least 3
-    //! bytes larger than the uri string. The buffer data can overlap as long as
-    //! the destination buffer begins before the source buffer.
-    //! @warning The callee has to ensure, that the destination buffer is not
-    //! freed before the uri!
-    //! @param[in] source             Points to the uri string.
-    //! @param[in] source_length      Length of the uri string in bytes.
-    //! @param[in] destination        Points to the destination buffer.
-    //! @param[in] destination_length Length of the destination buffer.
-    //! @param[in] skip_scheme        Assumes that there is no scheme when true.
-    //! @return                       True when the uri was successfully parsed
-    //!                               and false if not.
-    bool parse(const char_t* source, size_t source_length, char_t* destination,
-               size_t destination_length, const bool skip_scheme = false);
+    //! @brief Parses an uri string in place.
+    //!
+    //! Disassembles the uri string by null-terminating its parts and parses the
+    //! scheme into an enum value. Percent-encoded characters are decoded in
+    //! place, which does only happen for parts containing them. The path gets
+    //! normalized afterwards, see @ref normalize_path. A host, that
+    //! is directly followed by the path, is moved one character towards the
+    //! begin to null-terminate it. Therefore the character before the uri and
+    //! the character behind it have to be writable and are getting
+    //! overwritten. In a request these are the whitespaces around the uri.
+    //! @warning The callee has to ensure, that the buffer is not freed before
+    //! the uri!
+    //! @param[in,out] data        Points to the uri string.
+    //! @param[in]     length      Length of the uri string in bytes.
+    //! @param[in]     skip_scheme Assumes that there is no scheme when true.
+    //! @return                    True when the uri was successfully parsed
+    //!                            and false if not.
+    bool parse(char_t* const data, const size_t length,
+               const bool skip_scheme = false);
+
+    //! @brief Resets all members to their initial values.
+    void reset(void);
+
+    //! @brief Takes the parts of an uri, which was parsed in another copy of
+    //! the buffer.
+    //!
+    //! Parsing the same uri again would give the same parts, but it is more
+    //! expensive than copying the parsed buffer.
+    //! @param[in] source      Parsed uri.
+    //! @param[in] source_data Begin of the buffer of the parsed uri.
+    //! @param[in] data        Begin of the copy, that is used afterwards.
+    void relocate(const uri& source, const char_t* const source_data,
+                  const char_t* const data);
 
     //! @brief Returns the scheme of the uri.
     //!
@@ -84,12 +112,24 @@ public:
     //! @return Userinfo of the uri.
     const char_t* userinfo(void) const;
 
+    //! @brief Returns the userinfo of the uri with its length.
+    //!
+    //! Is valid after parse was called.
+    //! @return Userinfo of the uri or an empty view with NULL data.
+    std::string_view userinfo_view(void) const;
+
     //! @brief Returns the host of the uri.
     //!
     //! Is valid after parse was called.
     //! @return Host of the uri.
     const char_t* host(void) const;
 
+    //! @brief Returns the host of the uri with its length.
+    //!
+    //! Is valid after parse was called.
+    //! @return Host of the uri or an empty view with NULL data.
+    std::string_view host_view(void) const;
+
     //! @brief Returns the port of the uri.
     //!
     //! Is valid after parse was called.
@@ -102,124 +142,74 @@ public:
     //! @return Path of the uri.
     const char_t* path(void) const;
 
-    //! @brief Returns the query string of the uri.
+    //! @brief Returns the path of the uri with its length.
     //!
     //! Is valid after parse was called.
+    //! @return Path of the uri or an empty view with NULL data.
+    std::string_view path_view(void) const;
+
+    //! @brief Returns the query string of the uri.
+    //!
+    //! Is valid after parse was called. Percent-encoded characters are
+    //! validated, but not decoded, because an encoded '&' or '=' must not
+    //! separate the query entries.
     //! @return Query string of the uri.
     const char_t* query(void) const;
 
+    //! @brief Returns the query string of the uri with its length.
+    //!
+    //! Is valid after parse was called.
+    //! @return Query string of the uri or an empty view with NULL data.
+    std::string_view query_view(void) const;
+
     //! @brief Returns the fragment of the uri.
     //!
     //! Is valid after parse was called.
     //! @return Fragment of the uri.
     const char_t* fragment(void) const;
 
-private:
-    //! Contains data of the first pass.
-    struct first_pass_data {
-        //! Points to the begin of the scheme.
-        const char_t* scheme{NULL};
-
-        //! Contains the size of the scheme.
-        size_t scheme_size{0};
-
-        //! Points to the begin of the authority.
-        char_t* authority{NULL};
-
-        //! Contains the size of the authority.
-        size_t authority_size{0};
-
-        //! Points to the begin of the path.
-        const char_t* path{NULL};
-
-        //! Contains the size of the path.
-        size_t path_size{0};
-
-        //! Points to the begin of the query.
-        const char_t* query{NULL};
-
-        //! Contains the size of the query.
-        size_t query_size{0};
-
-        //! Points to the begin of the fragment.
-        const char_t* fragment{NULL};
-
-        //! Contains the size of the fragment.
-        size_t fragment_size{0};
-    };
-
-    //! @brief Parses the uri a first time.
+    //! @brief Returns the fragment of the uri with its length.
     //!
-    //! Rewrites the uri by splitting its parts and fill a first_pass_data
-    //! structure.
-    //! @param[in] source                 Points to the encoded uri.
-    //! @param[in] source_length          Length of the encoded uri in bytes.
-    //! @param[in,out] destination        Points to a buffer where to write to.
-    //! @param[in,out] destination_length Length of the destination buffer.
-    //! @param[in,out] data               Reference to the first_pass_data.
-    //! @param[in] skip_scheme            Skips the scheme when true.
-    //! @return                           True if success of false when failed.
-    bool parse_1st_pass(const char_t* source, size_t source_length,
-                        char_t* destination, size_t destination_length,
-                        first_pass_data& data, const bool skip_scheme);
+    //! Is valid after parse was called.
+    //! @return Fragment of the uri or an empty view with NULL data.
+    std::string_view fragment_view(void) const;
 
+private:
     //! @brief Parses the scheme of an uri.
     //!
-    //! Converts the scheme of the first pass into a value of the enum class
-    //! @ref uri_scheme.
+    //! Converts the scheme into a value of the enum class @ref uri_scheme.
     //! @param[in] scheme_ptr Points to the begin of the scheme.
     //! @param[in] size       Size of the scheme string in bytes.
     //! @return               True if a valid scheme was found.
     bool parse_scheme(const char_t* const scheme_ptr, const size_t& size);
 
-    //! @brief Parses the authority of an uri.
+    //! @brief Parses the port of an uri.
     //!
-    //! Splits the authority part into userinfo, host and port.
-    //! @param[in] authority_ptr Points to the begin of the authority.
-    //! @param[in] size          Size of the authority string in bytes.
-    //! @return                  True if the split and conversion succeeded.
-    bool parse_authority(char_t* const authority_ptr, const size_t& size);
+    //! @param[in] port_ptr Points to the begin of the port.
+    //! @param[in] size     Size of the port string in bytes.
+    //! @return             True if the port is a valid number or empty.
+    bool parse_port(const char_t* port_ptr, size_t size);
 
     //! Scheme of the uri.
     uri_scheme scheme_;
 
     //! Points to an external buffer containing the userinfo.
-    const char_t* userinfo_;
+    std::string_view userinfo_;
 
     //! Points to an external buffer containing the host.
-    const char_t* host_;
+    std::string_view host_;
 
     //! Contains the parsed port or 0.
     uint16_t port_;
 
     //! Points to an external buffer containing the path.
-    const char_t* path_;
+    std::string_view path_;
 
     //! Points to an external buffer containing the query string.
-    const char_t* query_;
+    std::string_view query_;
 
     //! Points to an external buffer containing the fragment.
-    const char_t* fragment_;
-
-    friend class uri_test;
-    friend class uri_test_first_pass_empty_Test;
-    friend class uri_test_first_pass_simple_path_Test;
-    friend class uri_test_first_pass_localhost_Test;
-    friend class uri_test_first_pass_complete_uri_Test;
-    friend class uri_test_first_pass_only_authority_Test;
-    friend class uri_test_first_pass_only_authority_with_userinfo_Test;
-    friend class uri_test_first_pass_only_scheme_Test;
-    friend class uri_test_first_pass_no_authority_Test;
-    friend class uri_test_first_pass_only_query_Test;
-    friend class uri_test_first_pass_only_fragment_Test;
-    friend class uri_test_first_pass_encoded_characters_in_scheme_Test;
-    friend class uri_test_first_pass_encoded_characters_in_authority_Test;
-    friend class uri_test_first_pass_encoded_characters_in_authority_2_Test;
-    friend class uri_test_first_pass_encoded_characters_in_path_Test;
-    friend class uri_test_first_pass_encoded_characters_in_query_Test;
-    friend class uri_test_first_pass_encoded_characters_in_fragment_Test;
-    friend class uri_test_first_pass_encoded_characters_at_the_end_Test;
-    friend class uri_test_valid_minimal_uri_Test;
+    std::string_view fragment_;
 };
 
 } // namespace hutzn
@@ -0,0 +1,148 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "buffer_pool.hpp"
+
+#include <algorithm>
+
+namespace hutzn
+{
+
+namespace
+{
+
+//! Capacities of the size classes in ascending order.
+static const std::array<size_t, 4> size_classes = {
+    {4096, 16384, 65536, 1048576}};
+
+//! Maximum number of buffers kept per size class.
+static const size_t max_buffers_per_size_class = 16;
+
+//! Assumed header length, before any header was recorded.
+static const size_t initial_header_length = 2048;
+
+//! Weight of the moving average. Each recorded header length contributes with
+//! 1/weight to the average.
+static const size_t header_length_weight = 8;
+
+//! Granularity of the header receive size.
+static const size_t header_receive_granularity = 1024;
+
+//! Bounds of the header receive size.
+static const size_t min_header_receive_size = 1024;
+static const size_t max_header_receive_size = 65536;
+
+} // namespace
+
+buffer_pool& buffer_pool::instance(void)
+{
+    static thread_local buffer_pool pool;
+    return pool;
+}
+
+buffer_pool::buffer_pool(void)
+    : buffers_()
+    , average_header_length_(initial_header_length)
+{
+    static_assert(size_classes.size() == size_class_count,
+                  "number of size classes does not match");
+}
+
+buffer buffer_pool::borrow(const size_t capacity)
+{
+    buffer result;
+    const size_t size_class = fitting_size_class(capacity);
+    if (size_class < size_class_count) {
+        std::vector<buffer>& buffers = buffers_[size_class];
+        if (buffers.empty()) {
+            result.reserve(size_classes[size_class]);
+        } else {
+            result.swap(buffers.back());
+            buffers.pop_back();
+        }
+    } else {
+        // buffers beyond the largest size class are never pooled
+        result.reserve(capacity);
+    }
+    return result;
+}
+
+void buffer_pool::give_back(buffer&& data)
+{
+    // a buffer belongs to the largest size class, that it could serve
+    const size_t capacity = data.capacity();
+    if ((capacity >= size_classes.front()) &&
+        (capacity <= size_classes.back())) {
+        size_t size_class = fitting_size_class(capacity);
+        if ((size_class == size_class_count) ||
+            (size_classes[size_class] > capacity)) {
+            size_class--;
+        }
+
+        std::vector<buffer>& buffers = buffers_[size_class];
+        if (buffers.size() < max_buffers_per_size_class) {
+            buffers.emplace_back();
+            buffers.back().swap(data);
+            buffers.back().clear();
+        }
+    }
+
+    // release the memory of the buffer in any case, because the caller must
+    // not use it anymore
+    buffer().swap(data);
+}
+
+size_t buffer_pool::available(const size_t capacity) const
+{
+    size_t result = 0;
+    const size_t size_class = fitting_size_class(capacity);
+    if (size_class < size_class_count) {
+        result = buffers_[size_class].size();
+    }
+    return result;
+}
+
+void buffer_pool::record_header_length(const size_t length)
+{
+    average_header_length_ =
+        ((average_header_length_ * (header_length_weight - 1)) + length) /
+        header_length_weight;
+}
+
+size_t buffer_pool::header_receive_size(void) const
+{
+    // receiving twice the usual header length fetches the start of small
+    // contents together with the header
+    const size_t size = 2 * average_header_length_;
+    const size_t rounded_size = ((size + header_receive_granularity - 1) /
+                                 header_receive_granularity) *
+                                header_receive_granularity;
+    return std::min(std::max(rounded_size, min_header_receive_size),
+                    max_header_receive_size);
+}
+
+size_t buffer_pool::fitting_size_class(const size_t capacity)
+{
+    size_t result = 0;
+    while ((result < size_class_count) && (size_classes[result] < capacity)) {
+        result++;
+    }
+    return result;
+}
+
+} // namespace hutzn
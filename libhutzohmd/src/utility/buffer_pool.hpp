@@ -0,0 +1,99 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_UTILITY_BUFFER_POOL_HPP
+#define LIBHUTZNOHMD_UTILITY_BUFFER_POOL_HPP
+
+#include <array>
+#include <vector>
+
+#include "libhutznohmd/communication.hpp"
+
+namespace hutzn
+{
+
+//! @brief Keeps released buffers to reuse their memory.
+//!
+//! Buffers are sorted into size classes (4K, 16K, 64K and 1M) by their
+//! capacity. Borrowing returns a buffer of the smallest size class, that fits
+//! the requested capacity. Only a few buffers are kept per size class, all
+//! other buffers are released. Each thread has its own pool, which is why no
+//! synchronization is necessary. The pool also observes the length of received
+//! headers to determine how many bytes to receive at once for a header.
+class buffer_pool
+{
+public:
+    //! @brief Returns the pool of the calling thread.
+    //!
+    //! @return Pool, which must only be used by the calling thread.
+    static buffer_pool& instance(void);
+
+    //! @brief Constructs an empty pool.
+    buffer_pool(void);
+
+    //! @brief Borrows an empty buffer.
+    //!
+    //! The buffer is taken from the pool if possible. It should be given back,
+    //! when it is not used anymore.
+    //! @param[in] capacity Minimum capacity of the buffer.
+    //! @return             Empty buffer with at least the requested capacity.
+    buffer borrow(const size_t capacity);
+
+    //! @brief Gives a buffer back to the pool.
+    //!
+    //! The buffer is released, when it is too small or too large for the size
+    //! classes or when its size class is already full.
+    //! @param[in] data Buffer to give back.
+    void give_back(buffer&& data);
+
+    //! @brief Returns the number of pooled buffers of a size class.
+    //!
+    //! @param[in] capacity Capacity of the size class.
+    //! @return             Number of buffers in the size class of the capacity.
+    size_t available(const size_t capacity) const;
+
+    //! @brief Records the length of a received header.
+    //!
+    //! @param[in] length Number of bytes of the header.
+    void record_header_length(const size_t length);
+
+    //! @brief Returns the number of bytes to receive at once for a header.
+    //!
+    //! It adapts to the recorded header lengths and is large enough to receive
+    //! an usual header and the start of its content at once.
+    //! @return Number of bytes to receive at once.
+    size_t header_receive_size(void) const;
+
+private:
+    //! Number of size classes.
+    static const size_t size_class_count = 4;
+
+    //! @brief Returns the smallest size class, that fits the capacity or
+    //! size_class_count if there is none.
+    static size_t fitting_size_class(const size_t capacity);
+
+    //! Pooled buffers sorted by their size class.
+    std::array<std::vector<buffer>, size_class_count> buffers_;
+
+    //! Moving average of the recorded header lengths.
+    size_t average_header_length_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_UTILITY_BUFFER_POOL_HPP
@@ -70,6 +70,13 @@ bool is_valid_url_path(const std::string& path)
         }
     }
 
+    // request paths are normalized and would never match any dot segment
+    if (result) {
+        const std::string segments = path + slash;
+        result = (std::string::npos == segments.find("/./")) &&
+                 (std::string::npos == segments.find("/../"));
+    }
+
     return result;
 }
 
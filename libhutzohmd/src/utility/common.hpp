@@ -54,6 +54,7 @@ bool check_range(const type& value)
 //! @brief Checks if a given url path is valid.
 //!
 //! Note that this method implements just a subset of RFC 3986 chapter 3.3.
+//! The path must not contain any "." or ".." segments.
 //! @see request_handler_id for more details. Returns true, if the the path is
 //! valid.
 //! @param[in] path The path that gets checked for validity.
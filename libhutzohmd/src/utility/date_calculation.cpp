@@ -18,6 +18,7 @@
 
 #include "date_calculation.hpp"
 
+#include <algorithm>
 #include <array>
 
 #include "utility/common.hpp"
@@ -29,8 +30,17 @@ namespace
 {
 
 static const uint8_t years_between_leapyears = 4;
+static const uint8_t february = 2;
 static const uint8_t last_month = 12;
 static const uint16_t epoch_start_year = 1970;
+static const uint16_t last_valid_year = 2099;
+static const uint16_t usual_days_per_year = 365;
+static const uint32_t seconds_per_day = 86400;
+static const uint8_t days_per_week = 7;
+
+//! Cumulated number of days before each month of a year, that is no leapyear.
+static const std::array<uint16_t, last_month> days_in_year_per_month = {
+    {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334}};
 
 //! @brief Returns true, if a year is a leapyear.
 //!
@@ -53,13 +63,10 @@ bool is_leapyear(const uint16_t year)
 uint16_t day_of_the_year(const uint8_t day, const uint8_t month,
                          const uint16_t year)
 {
-    static const std::array<uint16_t, last_month> days_in_year_per_month = {
-        {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334}};
-
-    // is in range of [0..365]
+    // is in range of [0..365], where the leap day counts only after february
     uint16_t result =
         static_cast<uint16_t>(days_in_year_per_month[month - 1] + (day - 1));
-    if (is_leapyear(year)) {
+    if ((month > february) && is_leapyear(year)) {
         result++;
     }
     return result;
@@ -78,9 +85,7 @@ bool is_valid_epoch_date(const uint8_t day, const uint8_t month,
 {
     // only century turns divisible by 400 are leapyears and therefore this
     // algorithm is only valid between 1970 and 2099
-    static const uint8_t february = 2;
     static const uint8_t first_month = 1;
-    static const uint16_t last_valid_year = 2099;
 
     // a date is valid, when all of the following conditions are met:
     // - the year is greater than or equal to the start year of epoch time
@@ -110,9 +115,6 @@ epoch_time_t seconds_since_epoch(const uint32_t second_of_day,
                                  const uint8_t day, const uint8_t month,
                                  const uint16_t year)
 {
-    static const uint16_t usual_days_per_year = 365;
-    static const uint32_t seconds_per_day = 86400;
-
     epoch_time_t result;
     if ((!is_valid_epoch_date(day, month, year)) ||
         (second_of_day >= seconds_per_day)) {
@@ -141,4 +143,59 @@ epoch_time_t seconds_since_epoch(const uint32_t second_of_day,
     return result;
 }
 
+bool date_since_epoch(const epoch_time_t timestamp, epoch_date& date)
+{
+    // 1969 begins a cycle of 4 years, where the last year is a leapyear
+    static const uint16_t cycle_start_year = 1969;
+    static const uint16_t days_per_cycle =
+        (years_between_leapyears * usual_days_per_year) + 1;
+    static const epoch_time_t end_of_valid_years =
+        seconds_since_epoch(seconds_per_day - 1, 31, last_month,
+                            last_valid_year);
+    // 1970-01-01 was a thursday
+    static const uint8_t first_weekday = 4;
+
+    const bool result = (timestamp >= 0) && (timestamp <= end_of_valid_years);
+    if (result) {
+        const uint32_t days =
+            static_cast<uint32_t>(timestamp / seconds_per_day);
+        date.second_of_day = static_cast<uint32_t>(timestamp % seconds_per_day);
+        date.weekday = static_cast<uint8_t>((days + first_weekday) %
+                                            days_per_week);
+
+        // the last day of a cycle would be counted as another year
+        const uint32_t cycle_days = days + usual_days_per_year;
+        const uint32_t day_of_cycle = cycle_days % days_per_cycle;
+        const uint32_t year_of_cycle = std::min<uint32_t>(
+            day_of_cycle / usual_days_per_year, years_between_leapyears - 1);
+        date.year = static_cast<uint16_t>(
+            cycle_start_year +
+            ((cycle_days / days_per_cycle) * years_between_leapyears) +
+            year_of_cycle);
+
+        // the leap day is the first day after the end of february in a usual
+        // year and shifts all following days by one
+        static const uint8_t leap_day_of_month = 29;
+        const uint32_t leap_day = days_in_year_per_month[february];
+        uint32_t day_of_year =
+            day_of_cycle - (year_of_cycle * usual_days_per_year);
+        if (is_leapyear(date.year) && (day_of_year == leap_day)) {
+            date.month = february;
+            date.day = leap_day_of_month;
+        } else {
+            if (is_leapyear(date.year) && (day_of_year > leap_day)) {
+                day_of_year--;
+            }
+            uint8_t month = last_month;
+            while (days_in_year_per_month[month - 1] > day_of_year) {
+                month--;
+            }
+            date.month = month;
+            date.day = static_cast<uint8_t>(
+                (day_of_year - days_in_year_per_month[month - 1]) + 1);
+        }
+    }
+    return result;
+}
+
 } // namespace hutzn
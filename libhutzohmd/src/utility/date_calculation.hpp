@@ -41,6 +41,34 @@ epoch_time_t seconds_since_epoch(const uint32_t second_of_day,
                                  const uint8_t day, const uint8_t month,
                                  const uint16_t year);
 
+//! Date and time of an epoch timestamp.
+struct epoch_date
+{
+    //! The second at a day in the range of [0..86399].
+    uint32_t second_of_day;
+
+    //! Day of the month in the range of [1..31].
+    uint8_t day;
+
+    //! Month of the year in the range of [1..12].
+    uint8_t month;
+
+    //! Year in the range of [1970..2099].
+    uint16_t year;
+
+    //! Zero-based day of the week, which starts at sunday.
+    uint8_t weekday;
+};
+
+//! @brief Calculates the date of an epoch timestamp.
+//!
+//! Is the inverse of @ref seconds_since_epoch.
+//! @param[in]  timestamp Number of seconds since epoch.
+//! @param[out] date      Date and time of the timestamp.
+//! @return               False, when the timestamp is before 1970 or after
+//!                       2099.
+bool date_since_epoch(const epoch_time_t timestamp, epoch_date& date);
+
 } // namespace hutzn
 
 #endif // LIBHUTZNOHMD_UTILITY_DATE_CALCULATION_HPP
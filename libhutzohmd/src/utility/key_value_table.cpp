@@ -0,0 +1,193 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "key_value_table.hpp"
+
+#include <cassert>
+#include <strings.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hutzn
+{
+
+namespace
+{
+
+//! Initial value of the 32 bit FNV-1a hash.
+static const uint32_t fnv_offset_basis = 2166136261U;
+
+//! Prime of the 32 bit FNV-1a hash.
+static const uint32_t fnv_prime = 16777619U;
+
+} // namespace
+
+key_value_table::key_value_table(const bool case_sensitive,
+                                 std::pmr::memory_resource* const resource)
+    : case_sensitive_(case_sensitive)
+    , size_(0)
+    , hashes_()
+    , keys_()
+    , values_()
+    , overflow_hashes_(resource)
+    , overflow_keys_(resource)
+    , overflow_values_(resource)
+{
+}
+
+uint32_t key_value_table::initial_hash(void)
+{
+    return fnv_offset_basis;
+}
+
+uint32_t key_value_table::hash_step(const uint32_t hash, const char_t ch,
+                                    const bool case_sensitive)
+{
+    uint8_t c = static_cast<uint8_t>(ch);
+    if ((false == case_sensitive) && (c >= 'A') && (c <= 'Z')) {
+        c = static_cast<uint8_t>(c + ('a' - 'A'));
+    }
+    return (hash ^ c) * fnv_prime;
+}
+
+uint32_t key_value_table::hash(const char_t* key, const bool case_sensitive)
+{
+    uint32_t result = initial_hash();
+    while ('\0' != *key) {
+        result = hash_step(result, *key, case_sensitive);
+        key++;
+    }
+    return result;
+}
+
+void key_value_table::insert(const uint32_t key_hash, const char_t* const key,
+                             const std::string_view& value)
+{
+    assert(NULL != key);
+    const size_t idx = index_of(key_hash, key);
+    if (idx < inline_capacity) {
+        if (idx == size_) {
+            hashes_[idx] = key_hash;
+            keys_[idx] = key;
+            size_++;
+        }
+        values_[idx] = value;
+    } else {
+        const size_t overflow_idx = idx - inline_capacity;
+        if (idx == size_) {
+            overflow_hashes_.push_back(key_hash);
+            overflow_keys_.push_back(key);
+            overflow_values_.push_back(value);
+            size_++;
+        } else {
+            overflow_values_[overflow_idx] = value;
+        }
+    }
+}
+
+const char_t* key_value_table::find(const char_t* const key) const
+{
+    return find_view(key).data();
+}
+
+const char_t* key_value_table::find(const uint32_t key_hash,
+                                    const char_t* const key) const
+{
+    return value_at(index_of(key_hash, key)).data();
+}
+
+std::string_view key_value_table::find_view(const char_t* const key) const
+{
+    std::string_view result;
+    if (NULL != key) {
+        result = value_at(index_of(hash(key, case_sensitive_), key));
+    }
+    return result;
+}
+
+size_t key_value_table::size(void) const
+{
+    return size_;
+}
+
+void key_value_table::clear(void)
+{
+    size_ = 0;
+    overflow_hashes_.clear();
+    overflow_keys_.clear();
+    overflow_values_.clear();
+}
+
+bool key_value_table::equal(const char_t* const lhs,
+                            const char_t* const rhs) const
+{
+    // Exceptional use of unbound functions strcmp and strcasecmp (breaks MISRA
+    // C++:2008 Rule 18-0-5), because neither lhs nor rhs is really unbound.
+    // Both are pointing to null-terminated strings. The null-termination is
+    // ensured by the users of the table.
+    bool result;
+    if (case_sensitive_) {
+        result = (0 == ::strcmp(lhs, rhs));
+    } else {
+        result = (0 == ::strcasecmp(lhs, rhs));
+    }
+    return result;
+}
+
+std::string_view key_value_table::value_at(const size_t idx) const
+{
+    std::string_view result;
+    if (idx < size_) {
+        if (idx < inline_capacity) {
+            result = values_[idx];
+        } else {
+            result = overflow_values_[idx - inline_capacity];
+        }
+    }
+    return result;
+}
+
+size_t key_value_table::index_of(const uint32_t key_hash,
+                                 const char_t* const key) const
+{
+    size_t result = size_;
+
+    // the hashes are compared first, because most keys differ in their hash
+    const size_t inline_size = std::min(size_, inline_capacity);
+    for (size_t i = 0; i < inline_size; i++) {
+        if ((hashes_[i] == key_hash) && equal(keys_[i], key)) {
+            result = i;
+            break;
+        }
+    }
+
+    if (result == size_) {
+        for (size_t i = 0; i < overflow_hashes_.size(); i++) {
+            if ((overflow_hashes_[i] == key_hash) &&
+                equal(overflow_keys_[i], key)) {
+                result = inline_capacity + i;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace hutzn
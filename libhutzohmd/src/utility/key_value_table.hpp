@@ -0,0 +1,154 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_UTILITY_KEY_VALUE_TABLE_HPP
+#define LIBHUTZNOHMD_UTILITY_KEY_VALUE_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "libhutznohmd/types.hpp"
+
+namespace hutzn
+{
+
+//! @brief Maps null-terminated keys to null-terminated values.
+//!
+//! The table stores only pointers to the strings and the lengths of the values.
+//! The strings must outlive the table. Up to 32 entries are stored inline
+//! without any allocation, all further entries are stored in an overflow area.
+//! Each key is stored with its hash, so that a lookup compares mostly integers
+//! and compares strings only when the hashes match. The hash could be
+//! calculated step by step, while the key is read. The overflow area allocates
+//! from a memory resource, which could be the arena of the request.
+class key_value_table
+{
+public:
+    //! Number of entries, that are stored without allocation.
+    static constexpr size_t inline_capacity = 32;
+
+    //! @brief Constructs an empty table.
+    //!
+    //! @param[in] case_sensitive Keys are compared case-insensitively, when
+    //!                           this is false.
+    //! @param[in] resource       Memory resource of the overflow area.
+    explicit key_value_table(const bool case_sensitive,
+                             std::pmr::memory_resource* const resource =
+                                 std::pmr::get_default_resource());
+
+    //! @brief Returns the hash of an empty key.
+    //!
+    //! @return Initial hash to pass to the first hash_step.
+    static uint32_t initial_hash(void);
+
+    //! @brief Adds one character of a key to its hash.
+    //!
+    //! @param[in] hash           Hash of the characters before.
+    //! @param[in] ch             Next character of the key.
+    //! @param[in] case_sensitive Must match the table, that uses the hash.
+    //! @return                   Hash including the character.
+    static uint32_t hash_step(const uint32_t hash, const char_t ch,
+                              const bool case_sensitive);
+
+    //! @brief Calculates the hash of a null-terminated key.
+    //!
+    //! @param[in] key            Key to hash.
+    //! @param[in] case_sensitive Must match the table, that uses the hash.
+    //! @return                   Hash of the key.
+    static uint32_t hash(const char_t* key, const bool case_sensitive);
+
+    //! @brief Inserts an entry or overwrites the value of an equal key.
+    //!
+    //! @param[in] key_hash Hash of the key.
+    //! @param[in] key      Null-terminated key.
+    //! @param[in] value    Value, that is null-terminated behind its end.
+    void insert(const uint32_t key_hash, const char_t* const key,
+                const std::string_view& value);
+
+    //! @brief Returns the value of a key.
+    //!
+    //! @param[in] key Null-terminated key to look up.
+    //! @return        Value of the key or NULL if there is none.
+    const char_t* find(const char_t* const key) const;
+
+    //! @brief Returns the value of a key, whose hash is already known.
+    //!
+    //! @param[in] key_hash Hash of the key.
+    //! @param[in] key      Null-terminated key to look up.
+    //! @return             Value of the key or NULL if there is none.
+    const char_t* find(const uint32_t key_hash, const char_t* const key) const;
+
+    //! @brief Returns the value of a key with its length.
+    //!
+    //! @param[in] key Null-terminated key to look up.
+    //! @return        Value of the key or an empty view with NULL data if there
+    //!                is none.
+    std::string_view find_view(const char_t* const key) const;
+
+    //! @brief Returns the number of entries.
+    //!
+    //! @return Number of entries.
+    size_t size(void) const;
+
+    //! @brief Removes all entries, but keeps the allocated memory.
+    void clear(void);
+
+private:
+    //! @brief Returns whether two keys are equal.
+    bool equal(const char_t* const lhs, const char_t* const rhs) const;
+
+    //! @brief Returns the value at the index or an empty view if the index is
+    //! out of range.
+    std::string_view value_at(const size_t idx) const;
+
+    //! @brief Returns the index of the entry with the key or size() if there
+    //! is none.
+    size_t index_of(const uint32_t key_hash, const char_t* const key) const;
+
+    //! Determines how to compare the keys.
+    const bool case_sensitive_;
+
+    //! Number of entries.
+    size_t size_;
+
+    //! Hashes of the inline entries. They are stored separately from the keys
+    //! to compare them in a tight loop.
+    std::array<uint32_t, inline_capacity> hashes_;
+
+    //! Keys of the inline entries.
+    std::array<const char_t*, inline_capacity> keys_;
+
+    //! Values of the inline entries.
+    std::array<std::string_view, inline_capacity> values_;
+
+    //! Hashes of the entries beyond the inline capacity.
+    std::pmr::vector<uint32_t> overflow_hashes_;
+
+    //! Keys of the entries beyond the inline capacity.
+    std::pmr::vector<const char_t*> overflow_keys_;
+
+    //! Values of the entries beyond the inline capacity.
+    std::pmr::vector<std::string_view> overflow_values_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_UTILITY_KEY_VALUE_TABLE_HPP
@@ -0,0 +1,156 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_UTILITY_KEYWORD_TABLE_HPP
+#define LIBHUTZNOHMD_UTILITY_KEYWORD_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "libhutznohmd/types.hpp"
+
+namespace hutzn
+{
+
+//! @brief Maps a keyword to a value.
+//!
+//! The keyword has to be lower case.
+template <typename value_type>
+struct keyword {
+    //! Lower case keyword.
+    std::string_view word;
+
+    //! Value of the keyword.
+    value_type value;
+};
+
+//! @brief Recognizes the words of a small and fixed vocabulary.
+//!
+//! The table is built at compile time and neither allocates nor needs a guard
+//! against concurrent initialization. Keywords are compared case-insensitively.
+//! A lookup compares the lengths first and the characters only of those
+//! keywords, which have the same length.
+template <typename value_type, size_t size>
+class keyword_table
+{
+public:
+    //! @brief Constructs the table.
+    //!
+    //! @param[in] keywords All keywords in lower case.
+    constexpr explicit keyword_table(
+        const std::array<keyword<value_type>, size>& keywords)
+        : keywords_(keywords)
+        , max_length_(calculate_max_length(keywords))
+    {
+    }
+
+    //! @brief Returns the length of the longest keyword.
+    //!
+    //! @return Length of the longest keyword.
+    constexpr size_t max_length(void) const
+    {
+        return max_length_;
+    }
+
+    //! @brief Finds the keyword, which matches a string exactly.
+    //!
+    //! @param[in] data   String to look up.
+    //! @param[in] length Length of the string.
+    //! @param[out] value Value of the keyword, when it was found.
+    //! @return           True when the keyword was found and false if not.
+    bool find(const char_t* const data, const size_t length,
+              value_type& value) const
+    {
+        bool result = false;
+        if (length <= max_length_) {
+            for (const keyword<value_type>& k : keywords_) {
+                if ((k.word.size() == length) && equals(data, k.word)) {
+                    value = k.value;
+                    result = true;
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+    //! @brief Finds the longest keyword, which is a prefix of a string.
+    //!
+    //! @param[in] data   String to look up.
+    //! @param[in] length Length of the string.
+    //! @param[out] value Value of the keyword, when it was found.
+    //! @return           Length of the found keyword or 0 if none was found.
+    size_t find_prefix(const char_t* const data, const size_t length,
+                       value_type& value) const
+    {
+        size_t result = 0;
+        for (const keyword<value_type>& k : keywords_) {
+            const size_t word_length = k.word.size();
+            if ((word_length > result) && (word_length <= length) &&
+                equals(data, k.word)) {
+                value = k.value;
+                result = word_length;
+            }
+        }
+        return result;
+    }
+
+private:
+    //! @brief Returns the length of the longest keyword.
+    static constexpr size_t calculate_max_length(
+        const std::array<keyword<value_type>, size>& keywords)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < size; i++) {
+            if (keywords[i].word.size() > result) {
+                result = keywords[i].word.size();
+            }
+        }
+        return result;
+    }
+
+    //! @brief Compares the beginning of the data with a lower case keyword.
+    static bool equals(const char_t* const data, const std::string_view& word)
+    {
+        static const uint8_t upper_to_lower_offset = 'a' - 'A';
+
+        bool result = true;
+        for (size_t i = 0; i < word.size(); i++) {
+            uint8_t c = static_cast<uint8_t>(data[i]);
+            if ((c >= 'A') && (c <= 'Z')) {
+                c = static_cast<uint8_t>(c + upper_to_lower_offset);
+            }
+            if (c != static_cast<uint8_t>(word[i])) {
+                result = false;
+                break;
+            }
+        }
+        return result;
+    }
+
+    //! All keywords.
+    const std::array<keyword<value_type>, size> keywords_;
+
+    //! Length of the longest keyword.
+    const size_t max_length_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_UTILITY_KEYWORD_TABLE_HPP
@@ -0,0 +1,40 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "request_arena.hpp"
+
+namespace hutzn
+{
+
+request_arena::request_arena(std::pmr::memory_resource* const upstream)
+    : buffer_()
+    , resource_(buffer_.data(), buffer_.size(), upstream)
+{
+}
+
+std::pmr::memory_resource* request_arena::resource(void)
+{
+    return &resource_;
+}
+
+void request_arena::release(void)
+{
+    resource_.release();
+}
+
+} // namespace hutzn
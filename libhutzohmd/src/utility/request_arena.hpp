@@ -0,0 +1,74 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHUTZNOHMD_UTILITY_REQUEST_ARENA_HPP
+#define LIBHUTZNOHMD_UTILITY_REQUEST_ARENA_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+#include "libhutznohmd/types.hpp"
+
+namespace hutzn
+{
+
+//! @brief Serves all allocations of a single request.
+//!
+//! The arena hands out memory monotonically and never frees a single
+//! allocation. All memory is released in one step, when the request is
+//! finished. The first allocations are served by an inline buffer, therefore a
+//! small request does not use the heap at all. The arena is not thread-safe,
+//! it is meant to be used by the thread processing the request.
+class request_arena
+{
+public:
+    //! Size of the inline buffer.
+    static const size_t inline_size = 4096;
+
+    //! @brief Constructs an empty arena.
+    //!
+    //! @param[in] upstream Resource to use, when the inline buffer is
+    //!                     exhausted.
+    explicit request_arena(std::pmr::memory_resource* const upstream =
+                               std::pmr::get_default_resource());
+
+    request_arena(const request_arena&) = delete;
+    request_arena& operator=(const request_arena&) = delete;
+
+    //! @brief Returns the memory resource to allocate from.
+    //!
+    //! @return Memory resource of the arena.
+    std::pmr::memory_resource* resource(void);
+
+    //! @brief Releases all allocations at once.
+    //!
+    //! All objects, which allocated from the arena, must be destroyed before.
+    void release(void);
+
+private:
+    //! Inline buffer, which serves the first allocations.
+    alignas(std::max_align_t) std::array<uint8_t, inline_size> buffer_;
+
+    //! Hands out the memory of the inline buffer and the upstream resource.
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+} // namespace hutzn
+
+#endif // LIBHUTZNOHMD_UTILITY_REQUEST_ARENA_HPP
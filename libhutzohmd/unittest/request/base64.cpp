@@ -16,6 +16,11 @@
  * <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -55,6 +60,86 @@ TEST(base64, encode_pangram)
                  base64.c_str());
 }
 
+TEST(base64, encode_into_buffer)
+{
+    const uint8_t data[] = {'H', 'e', 'l', 'l', 'o'};
+    char_t destination[base64_encoded_size(sizeof(data)) + 1];
+    ASSERT_EQ(8, sizeof(destination) - 1);
+
+    const size_t size = encode_base64(data, sizeof(data), destination);
+    destination[size] = '\0';
+    EXPECT_EQ(8, size);
+    EXPECT_STREQ("SGVsbG8=", destination);
+
+    EXPECT_EQ(0, encode_base64(data, 0, destination));
+}
+
+TEST(base64, encode_long_data)
+{
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < 300; i++) {
+        data.push_back(static_cast<uint8_t>(i * 37));
+    }
+
+    // encoding 3 bytes at a time must equal encoding all at once
+    for (size_t size = 0; size <= data.size(); size++) {
+        const std::vector<uint8_t> part(data.begin(), data.begin() + size);
+        std::string expected;
+        for (size_t i = 0; i < size; i += 3) {
+            const size_t end = std::min(size, i + 3);
+            expected += encode_base64(
+                std::vector<uint8_t>(data.begin() + i, data.begin() + end));
+        }
+        EXPECT_EQ(expected, encode_base64(part)) << size;
+    }
+}
+
+TEST(base64, decode_long_string)
+{
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < 300; i++) {
+        data.push_back(static_cast<uint8_t>(i * 41));
+    }
+
+    for (size_t size = 0; size <= data.size(); size++) {
+        const std::vector<uint8_t> part(data.begin(), data.begin() + size);
+        const std::string encoded = encode_base64(part);
+        EXPECT_EQ(part, decode_base64(encoded.data(), encoded.size())) << size;
+    }
+}
+
+TEST(base64, decode_long_string_with_both_alphabets_and_separators)
+{
+    const std::string encoded = "+/-_+/-_abcdefghijklmnopqrstuvwxyz0123456789"
+                                "ABCDEFGHIJKLMNOPQRSTUVWXYZ\r\n"
+                                "+/-_+/-_abcdefghijklmnopqrstuvwxyz01234567";
+    std::string expected = encoded;
+    expected.erase(expected.find("\r\n"), 2);
+    std::replace(expected.begin(), expected.end(), '-', '+');
+    std::replace(expected.begin(), expected.end(), '_', '/');
+
+    const std::vector<uint8_t> decoded =
+        decode_base64(encoded.data(), encoded.size());
+    EXPECT_EQ(expected, encode_base64(decoded));
+}
+
+TEST(base64, decode_into_buffer)
+{
+    const char_t encoded[] = "SGVsbG8=";
+    uint8_t destination[base64_decoded_max_size(sizeof(encoded) - 1)];
+    ASSERT_EQ(6, sizeof(destination));
+
+    size_t size = 1;
+    EXPECT_TRUE(decode_base64(encoded, sizeof(encoded) - 1, destination, size));
+    ASSERT_EQ(5, size);
+    EXPECT_EQ(0, ::memcmp("Hello", destination, size));
+
+    EXPECT_FALSE(decode_base64("SGVsb", 5, destination, size));
+    EXPECT_EQ(0, size);
+    EXPECT_TRUE(decode_base64("", 0, destination, size));
+    EXPECT_EQ(0, size);
+}
+
 TEST(base64, decode_empty)
 {
     const std::vector<uint8_t> decoded_data = decode_base64("", 0);
@@ -0,0 +1,234 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <limits>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/chunked_decoder.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+class chunked_decoder_test : public Test
+{
+public:
+    chunked_state decode(chunked_decoder& decoder, const std::string& data)
+    {
+        data_.insert(data_.end(), data.begin(), data.end());
+        return decoder.decode(data_.data(), data_.size(), head_, tail_);
+    }
+
+    std::string decoded(void) const
+    {
+        return std::string(data_.begin(),
+                           data_.begin() + static_cast<ssize_t>(tail_));
+    }
+
+    std::string remaining(void) const
+    {
+        return std::string(data_.begin() + static_cast<ssize_t>(head_),
+                           data_.end());
+    }
+
+protected:
+    std::vector<char_t> data_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+};
+
+TEST_F(chunked_decoder_test, empty_content)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::FINISHED, decode(decoder, "0\r\n\r\n"));
+    EXPECT_EQ("", decoded());
+    EXPECT_EQ("", remaining());
+    EXPECT_EQ(0, decoder.content_length());
+}
+
+TEST_F(chunked_decoder_test, multiple_chunks)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::FINISHED,
+              decode(decoder, "5\r\nHello\r\n1\r\n \r\n6\r\nWorld!\r\n"
+                              "0\r\n\r\n"));
+    EXPECT_EQ("Hello World!", decoded());
+    EXPECT_EQ(12, decoder.content_length());
+}
+
+TEST_F(chunked_decoder_test, bytewise)
+{
+    static const std::string content = "3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n";
+
+    chunked_decoder decoder{100, 64, 4};
+    for (size_t i = 0; i < (content.size() - 1); i++) {
+        EXPECT_EQ(chunked_state::NEED_MORE_DATA,
+                  decode(decoder, content.substr(i, 1)));
+    }
+    EXPECT_EQ(chunked_state::FINISHED,
+              decode(decoder, content.substr(content.size() - 1)));
+    EXPECT_EQ("abcde", decoded());
+}
+
+TEST_F(chunked_decoder_test, newlines_without_carriage_return)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::FINISHED, decode(decoder, "3\nabc\n0\n\n"));
+    EXPECT_EQ("abc", decoded());
+}
+
+TEST_F(chunked_decoder_test, extensions_and_trailer)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::FINISHED,
+              decode(decoder, "3;name=value\r\nabc\r\n0 ; x\r\nA: b\r\n"
+                              "C: d\r\n\r\n"));
+    EXPECT_EQ("abc", decoded());
+}
+
+TEST_F(chunked_decoder_test, hex_size)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::FINISHED,
+              decode(decoder, "0a\r\n0123456789\r\nB\r\nabcdefghijk\r\n"
+                              "0\r\n\r\n"));
+    EXPECT_EQ("0123456789abcdefghijk", decoded());
+}
+
+TEST_F(chunked_decoder_test, keeps_data_beyond_content)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::FINISHED,
+              decode(decoder, "1\r\na\r\n0\r\n\r\nGET / HTTP/1.1\r\n"));
+    EXPECT_EQ("a", decoded());
+    EXPECT_EQ("GET / HTTP/1.1\r\n", remaining());
+
+    // the decoder does not touch any more data after finishing
+    EXPECT_EQ(chunked_state::FINISHED, decode(decoder, "\r\n"));
+    EXPECT_EQ("GET / HTTP/1.1\r\n\r\n", remaining());
+}
+
+TEST_F(chunked_decoder_test, missing_size)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::MALFORMED, decode(decoder, "\r\nabc\r\n"));
+}
+
+TEST_F(chunked_decoder_test, invalid_size)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::MALFORMED, decode(decoder, "3g\r\nabc\r\n"));
+}
+
+TEST_F(chunked_decoder_test, missing_newline_after_data)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::MALFORMED, decode(decoder, "3\r\nabcd\r\n"));
+}
+
+TEST_F(chunked_decoder_test, chunk_too_large)
+{
+    chunked_decoder decoder{10, 64, 4};
+    EXPECT_EQ(chunked_state::TOO_LARGE, decode(decoder, "b\r\n"));
+}
+
+TEST_F(chunked_decoder_test, content_too_large)
+{
+    chunked_decoder decoder{10, 64, 4};
+    EXPECT_EQ(chunked_state::NEED_MORE_DATA,
+              decode(decoder, "6\r\nabcdef\r\n"));
+    EXPECT_EQ(chunked_state::TOO_LARGE, decode(decoder, "5\r\nghijk\r\n"));
+}
+
+TEST_F(chunked_decoder_test, size_overflow)
+{
+    chunked_decoder decoder{std::numeric_limits<size_t>::max(), 64, 4};
+    EXPECT_EQ(chunked_state::TOO_LARGE,
+              decode(decoder, "10000000000000000000000000000000\r\n"));
+}
+
+TEST_F(chunked_decoder_test, carriage_return_within_size)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::MALFORMED, decode(decoder, "1\r2\r\n"));
+}
+
+TEST_F(chunked_decoder_test, several_carriage_returns_after_data)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::MALFORMED,
+              decode(decoder, "3\r\nabc\r\r\n0\r\n\r\n"));
+}
+
+TEST_F(chunked_decoder_test, carriage_return_split_from_line_feed)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::NEED_MORE_DATA, decode(decoder, "3\r"));
+    EXPECT_EQ(chunked_state::NEED_MORE_DATA, decode(decoder, "\nabc\r"));
+    EXPECT_EQ(chunked_state::FINISHED, decode(decoder, "\n0\r\n\r\n"));
+    EXPECT_EQ("abc", decoded());
+}
+
+TEST_F(chunked_decoder_test, endless_leading_zeros)
+{
+    chunked_decoder decoder{100, 64, 4};
+    EXPECT_EQ(chunked_state::MALFORMED,
+              decode(decoder, "00000000000000000000000000000001\r\n"));
+}
+
+TEST_F(chunked_decoder_test, extensions_too_large)
+{
+    chunked_decoder decoder{100, 8, 4};
+    EXPECT_EQ(chunked_state::NEED_MORE_DATA,
+              decode(decoder, "1;abcd\r\na\r\n"));
+    EXPECT_EQ(chunked_state::FIELDS_TOO_LARGE, decode(decoder, "1;efgh"));
+}
+
+TEST_F(chunked_decoder_test, trailer_fields_too_large)
+{
+    chunked_decoder decoder{100, 8, 4};
+    EXPECT_EQ(chunked_state::FIELDS_TOO_LARGE,
+              decode(decoder, "0\r\nA: bcdefgh\r\n"));
+}
+
+TEST_F(chunked_decoder_test, too_many_trailer_fields)
+{
+    chunked_decoder decoder{100, 64, 2};
+    EXPECT_EQ(chunked_state::FIELDS_TOO_LARGE,
+              decode(decoder, "0\r\nA: b\r\nC: d\r\nE: f\r\n\r\n"));
+}
+
+TEST_F(chunked_decoder_test, reset_limits)
+{
+    chunked_decoder decoder{100, 0, 0};
+    EXPECT_EQ(chunked_state::FIELDS_TOO_LARGE, decode(decoder, "1;a"));
+
+    decoder.reset(100, 64, 4);
+    data_.clear();
+    head_ = 0;
+    tail_ = 0;
+    EXPECT_EQ(chunked_state::FINISHED,
+              decode(decoder, "1;a\r\nb\r\n0\r\nC: d\r\n\r\n"));
+    EXPECT_EQ("b", decoded());
+}
+
+} // namespace hutzn
@@ -0,0 +1,137 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/content_digest.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+namespace
+{
+
+std::string format(const digest_algorithm algorithm, const std::string& data)
+{
+    char_t digest[max_content_digest_length];
+    const size_t length =
+        format_content_digest(algorithm, data.data(), data.size(), digest);
+    return std::string(digest, length);
+}
+
+bool parse(content_digest_verifier& verifier, const std::string& value)
+{
+    return verifier.parse(value.data(), value.size());
+}
+
+} // namespace
+
+TEST(content_digest, format)
+{
+    EXPECT_EQ("crc32c=:4waSgw==:",
+              format(digest_algorithm::CRC32C, "123456789"));
+    EXPECT_EQ("sha-256=:ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=:",
+              format(digest_algorithm::SHA_256, "abc"));
+    EXPECT_EQ(max_content_digest_length,
+              format(digest_algorithm::SHA_256, "").size());
+}
+
+TEST(content_digest, verify_whole_content)
+{
+    content_digest_verifier verifier;
+    EXPECT_TRUE(verifier.empty());
+    ASSERT_TRUE(parse(
+        verifier, "sha-256=:ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=:"));
+    EXPECT_FALSE(verifier.empty());
+
+    verifier.update("abc", 3);
+    EXPECT_TRUE(verifier.verify());
+    verifier.update("abd", 3);
+    EXPECT_FALSE(verifier.verify());
+}
+
+TEST(content_digest, verify_parts_with_all_algorithms)
+{
+    content_digest_verifier verifier;
+    ASSERT_TRUE(
+        parse(verifier, " crc32c=:4waSgw==: ,unixsum=:AAA=:,\tsha-256="
+                        ":FeKw08M4keuw8e9gnsQZQgwg4yDOlMZfvIwzEkSOsiU=:"));
+
+    verifier.update("1234", 4);
+    verifier.update("56789", 5);
+    EXPECT_TRUE(verifier.verify());
+}
+
+TEST(content_digest, restart_keeps_expected_sums)
+{
+    content_digest_verifier verifier;
+    ASSERT_TRUE(
+        parse(verifier, "crc32c=:4waSgw==:, sha-256="
+                        ":FeKw08M4keuw8e9gnsQZQgwg4yDOlMZfvIwzEkSOsiU=:"));
+
+    verifier.update("1234", 4);
+    verifier.restart();
+    EXPECT_FALSE(verifier.empty());
+    verifier.update("123456789", 9);
+    EXPECT_TRUE(verifier.verify());
+}
+
+TEST(content_digest, unknown_algorithms_are_ignored)
+{
+    content_digest_verifier verifier;
+    EXPECT_TRUE(parse(verifier, "sha-512=:AAAA:, md5=:AAAA:"));
+    EXPECT_TRUE(verifier.empty());
+}
+
+TEST(content_digest, malformed_values)
+{
+    content_digest_verifier verifier;
+    EXPECT_FALSE(parse(verifier, "crc32c=:AAAA:"));
+    EXPECT_FALSE(verifier.empty());
+    EXPECT_FALSE(verifier.verify());
+    verifier.reset();
+    EXPECT_FALSE(parse(verifier, "crc32c=4waSgw=="));
+    verifier.reset();
+    EXPECT_FALSE(parse(verifier, "crc32c=:4waSgw=="));
+    verifier.reset();
+    EXPECT_FALSE(parse(verifier, "crc32c=:4waSgw==: x"));
+    verifier.reset();
+    EXPECT_FALSE(parse(verifier, "crc32c=:4waSgw==:,"));
+    verifier.reset();
+    EXPECT_FALSE(parse(verifier, "crc32c"));
+    verifier.reset();
+    EXPECT_TRUE(verifier.empty());
+}
+
+TEST(content_digest, malformed_member_after_matching_sum)
+{
+    for (const char_t* const value :
+         {"crc32c=:4waSgw==:, sha-256=:AAAA:", "crc32c=:4waSgw==:, garbage"}) {
+        content_digest_verifier verifier;
+        EXPECT_FALSE(parse(verifier, value));
+        verifier.update("123456789", 9);
+        EXPECT_FALSE(verifier.verify());
+    }
+}
+
+} // namespace hutzn
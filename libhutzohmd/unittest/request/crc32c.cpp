@@ -0,0 +1,81 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/crc32c.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+TEST(crc32c, rfc3720_test_suite)
+{
+    const std::string zeros(32, '\x00');
+    const std::string ones(32, '\xFF');
+    std::string incrementing;
+    for (size_t i = 0; i < 32; i++) {
+        incrementing.push_back(static_cast<char_t>(i));
+    }
+
+    EXPECT_EQ(0x8A9136AAU, calculate_crc32c(zeros.data(), zeros.size()));
+    EXPECT_EQ(0x62A8AB43U, calculate_crc32c(ones.data(), ones.size()));
+    EXPECT_EQ(0x46DD794EU,
+              calculate_crc32c(incrementing.data(), incrementing.size()));
+}
+
+TEST(crc32c, check_value)
+{
+    EXPECT_EQ(0xE3069283U, calculate_crc32c("123456789", 9));
+    EXPECT_EQ(0, calculate_crc32c("", 0));
+}
+
+TEST(crc32c, parts)
+{
+    const std::string message = "The quick brown fox jumps over the lazy dog";
+    const uint32_t expected = calculate_crc32c(message.data(), message.size());
+    for (size_t split = 0; split <= message.size(); split++) {
+        const uint32_t first = update_crc32c(0, message.data(), split);
+        EXPECT_EQ(expected, update_crc32c(first, message.data() + split,
+                                          message.size() - split))
+            << split;
+    }
+}
+
+TEST(crc32c, portable_equals_accelerated)
+{
+    std::string message;
+    for (size_t i = 0; i < 200; i++) {
+        message.push_back(static_cast<char_t>(i * 31));
+    }
+
+    // unaligned beginnings and all lengths of the tail
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t size = 0; size < 100; size++) {
+            const char_t* const data = message.data() + offset;
+            EXPECT_EQ(detail::update_crc32c_portable(0, data, size),
+                      calculate_crc32c(data, size));
+        }
+    }
+}
+
+} // namespace hutzn
@@ -0,0 +1,71 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/custom_header_registry.hpp"
+#include "utility/key_value_table.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+TEST(custom_header_registry, add_and_find)
+{
+    custom_header_registry registry;
+    const custom_header_id id = registry.add("X-Trace");
+    EXPECT_EQ(0, id);
+
+    EXPECT_EQ(id, registry.find(key_value_table::hash("x-trace", false),
+                                "x-trace"));
+    EXPECT_EQ(invalid_custom_header_id,
+              registry.find(key_value_table::hash("x-other", false),
+                            "x-other"));
+}
+
+TEST(custom_header_registry, add_twice)
+{
+    custom_header_registry registry;
+    const custom_header_id id = registry.add("X-Trace");
+    EXPECT_EQ(id, registry.add("x-trace"));
+    EXPECT_EQ(id + 1, registry.add("X-Other"));
+}
+
+TEST(custom_header_registry, invalid_names)
+{
+    custom_header_registry registry;
+    EXPECT_EQ(invalid_custom_header_id, registry.add(NULL));
+    EXPECT_EQ(invalid_custom_header_id, registry.add(""));
+}
+
+TEST(custom_header_registry, capacity)
+{
+    custom_header_registry registry;
+    for (size_t i = 0; i < custom_header_registry::capacity; i++) {
+        const std::string name = "X-" + std::to_string(i);
+        EXPECT_EQ(i, registry.add(name.c_str()));
+    }
+    EXPECT_EQ(invalid_custom_header_id, registry.add("X-Full"));
+    EXPECT_EQ(3, registry.add("x-3"));
+}
+
+} // namespace hutzn
@@ -0,0 +1,99 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/date_cache.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+namespace
+{
+
+time_t fake_time = 0;
+size_t fake_clock_calls = 0;
+
+time_t fake_clock(void)
+{
+    fake_clock_calls++;
+    return fake_time;
+}
+
+} // namespace
+
+class date_cache_test : public Test
+{
+public:
+    void SetUp(void) override
+    {
+        fake_time = 784111777;
+        fake_clock_calls = 0;
+    }
+};
+
+TEST_F(date_cache_test, renders_date)
+{
+    date_cache cache(&fake_clock);
+    EXPECT_EQ(784111777, cache.now());
+    EXPECT_STREQ("Sun, 06 Nov 1994 08:49:37 GMT", cache.date());
+    EXPECT_EQ(2, fake_clock_calls);
+}
+
+TEST_F(date_cache_test, keeps_date_within_a_second)
+{
+    date_cache cache(&fake_clock);
+    const char_t* const date = cache.date();
+    EXPECT_EQ(date, cache.date());
+    EXPECT_STREQ("Sun, 06 Nov 1994 08:49:37 GMT", date);
+}
+
+TEST_F(date_cache_test, renders_date_after_a_second)
+{
+    date_cache cache(&fake_clock);
+    EXPECT_STREQ("Sun, 06 Nov 1994 08:49:37 GMT", cache.date());
+    fake_time++;
+    EXPECT_STREQ("Sun, 06 Nov 1994 08:49:38 GMT", cache.date());
+    fake_time = 0;
+    EXPECT_EQ(0, cache.now());
+    EXPECT_STREQ("Thu, 01 Jan 1970 00:00:00 GMT", cache.date());
+}
+
+TEST_F(date_cache_test, out_of_range)
+{
+    date_cache cache(&fake_clock);
+    fake_time = -1;
+    EXPECT_STREQ("", cache.date());
+}
+
+TEST_F(date_cache_test, coarse_clock)
+{
+    const time_t before = ::time(NULL);
+    date_cache& cache = date_cache::instance();
+    const time_t now = cache.now();
+    EXPECT_LE(before - 1, now);
+    EXPECT_GE(::time(NULL) + 1, now);
+    EXPECT_EQ(imf_fixdate_length, ::strlen(cache.date()));
+}
+
+} // namespace hutzn
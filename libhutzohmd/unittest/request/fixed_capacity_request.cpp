@@ -0,0 +1,243 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "libhutznohmd/mock_communication.hpp"
+#include "request/fixed_capacity_request.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+class fixed_capacity_request_test : public Test
+{
+public:
+    using request_type = fixed_capacity_request<4096, 64, 1024>;
+
+    void SetUp(void) override
+    {
+        connection_ = std::make_shared<connection_mock>();
+    }
+
+    void TearDown(void) override
+    {
+        connection_.reset();
+    }
+
+    void setup_receive(const std::string& chunk)
+    {
+        EXPECT_CALL(*connection_, receive(_, _))
+            .Times(AtLeast(1))
+            .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+                EXPECT_LE(chunk.size(), m);
+                b.insert(b.end(), chunk.begin(), chunk.end());
+                return true;
+            }))
+            .WillRepeatedly(Return(false));
+    }
+
+    void setup_receive_in_parts(const std::string& data)
+    {
+        // the data is received in parts as large as the lexer asks for
+        std::shared_ptr<size_t> offset = std::make_shared<size_t>(0);
+        EXPECT_CALL(*connection_, receive(_, _))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Invoke([data, offset](buffer& b, const size_t& m) {
+                const size_t size = std::min(m, data.size() - *offset);
+                b.insert(b.end(), data.begin() + *offset,
+                         data.begin() + *offset + size);
+                *offset += size;
+                return size > 0;
+            }));
+    }
+
+    void expect_rejection(const std::string& status_line)
+    {
+        EXPECT_CALL(*connection_, send(Matcher<const std::string&>(
+                                      HasSubstr(status_line))))
+            .Times(1)
+            .WillOnce(Return(true));
+    }
+
+protected:
+    connection_mock_ptr connection_;
+    mime_handler handler_;
+};
+
+TEST_F(fixed_capacity_request_test, limits)
+{
+    const header_limits limits = request_type::limits();
+    EXPECT_EQ(2048, limits.max_request_line_length);
+    EXPECT_EQ(4096, limits.max_header_length);
+    EXPECT_EQ(64, limits.max_header_count);
+    EXPECT_EQ(1024, limits.max_content_length);
+
+    const header_limits small_limits =
+        fixed_capacity_request<512, 8, 0>::limits();
+    EXPECT_EQ(512, small_limits.max_request_line_length);
+    EXPECT_EQ(512, small_limits.max_header_length);
+    EXPECT_EQ(8, small_limits.max_header_count);
+    EXPECT_EQ(0, small_limits.max_content_length);
+}
+
+TEST_F(fixed_capacity_request_test, request_with_content)
+{
+    request_type r{connection_};
+    setup_receive("POST /a?b=c HTTP/1.1\r\nContent-Length: 5\r\nX-A: d\r\n\r\n"
+                  "hello");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_EQ(http_verb::POST, r.method());
+    EXPECT_STREQ("/a", r.path());
+    EXPECT_STREQ("c", r.query("b"));
+    EXPECT_STREQ("d", r.header_value("x-a"));
+    ASSERT_TRUE(r.fetch_content());
+    ASSERT_EQ(5, r.content_length());
+    EXPECT_EQ(0, memcmp("hello", r.content(), r.content_length()));
+}
+
+TEST_F(fixed_capacity_request_test, header_fields_up_to_the_capacity)
+{
+    std::string data = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i < 64; i++) {
+        data += "X-" + std::to_string(i) + ": " + std::to_string(i) + "\r\n";
+    }
+    data += "\r\n";
+
+    // the tables must not need more than the preallocated memory, which does
+    // not fall back to the heap
+    request_type r{connection_};
+    setup_receive(data);
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_STREQ("0", r.header_value("x-0"));
+    EXPECT_STREQ("63", r.header_value("x-63"));
+}
+
+TEST_F(fixed_capacity_request_test, query_entries_up_to_the_request_line_size)
+{
+    static const char_t digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    static const size_t digit_count = sizeof(digits) - 1;
+
+    std::string data = "GET /?";
+    for (size_t i = 0; (data.size() + 3) < 2030; i++) {
+        data += digits[(i / digit_count) % digit_count];
+        data += digits[i % digit_count];
+        data += '&';
+    }
+    data += "z HTTP/1.1\r\n\r\n";
+
+    request_type r{connection_};
+    setup_receive(data);
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_STREQ("", r.query("00"));
+    EXPECT_STREQ("", r.query("z"));
+}
+
+TEST_F(fixed_capacity_request_test, query_entries_of_the_host_are_limited)
+{
+    static const char_t digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    static const size_t digit_count = sizeof(digits) - 1;
+
+    // the Host header field could be longer than the request line
+    std::string data = "GET * HTTP/1.1\r\nHost: h/?";
+    size_t count = 0;
+    for (; (data.size() + 3) < 4080; count++) {
+        data += digits[(count / digit_count) % digit_count];
+        data += digits[count % digit_count];
+        data += '&';
+    }
+    data += "\r\n\r\n";
+    ASSERT_LT(request_type::limits().max_request_line_length / 2, count);
+
+    request_type r{connection_};
+    setup_receive_in_parts(data);
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_STREQ("", r.query("00"));
+    EXPECT_STREQ(NULL, r.query("zz"));
+}
+
+TEST_F(fixed_capacity_request_test, too_large_content_is_rejected)
+{
+    request_type r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 1025\r\n\r\n");
+    expect_rejection("HTTP/1.1 413 Request Entity Too Large\r\n");
+    EXPECT_FALSE(r.parse(handler_));
+    EXPECT_EQ(http_status_code::REQUEST_ENTITY_TOO_LARGE, r.rejection_status());
+}
+
+TEST_F(fixed_capacity_request_test, too_many_header_fields_are_rejected)
+{
+    std::string data = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i < 65; i++) {
+        data += "X-" + std::to_string(i) + ": " + std::to_string(i) + "\r\n";
+    }
+    data += "\r\n";
+
+    request_type r{connection_};
+    setup_receive(data);
+    expect_rejection("HTTP/1.1 431 Request Header Fields Too Large\r\n");
+    EXPECT_FALSE(r.parse(handler_));
+    EXPECT_EQ(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE,
+              r.rejection_status());
+}
+
+TEST_F(fixed_capacity_request_test, too_long_request_line_is_rejected)
+{
+    request_type r{connection_};
+    setup_receive("GET /" + std::string(2100, 'a') + " HTTP/1.1\r\n\r\n");
+    expect_rejection("HTTP/1.1 414 Request-URI Too Long\r\n");
+    EXPECT_FALSE(r.parse(handler_));
+    EXPECT_EQ(http_status_code::REQUEST_URI_TOO_LONG, r.rejection_status());
+}
+
+TEST_F(fixed_capacity_request_test, reuse_for_next_request)
+{
+    request_type r{connection_};
+    setup_receive("GET /a HTTP/1.1\r\nX-A: b\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_STREQ("/a", r.path());
+
+    r.reset();
+    setup_receive("GET /c HTTP/1.1\r\nX-C: d\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_STREQ("/c", r.path());
+    EXPECT_STREQ(NULL, r.header_value("x-a"));
+    EXPECT_STREQ("d", r.header_value("x-c"));
+}
+
+
+TEST_F(fixed_capacity_request_test, reuse_for_pipelined_request)
+{
+    request_type r{connection_};
+    setup_receive("POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                  "2\r\nbc\r\n0\r\n\r\nGET /d HTTP/1.1\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_TRUE(r.fetch_content());
+    EXPECT_EQ(0, memcmp("bc", r.content(), r.content_length()));
+
+    // the next request was received together with the first one
+    r.reset();
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_EQ(http_verb::GET, r.method());
+    EXPECT_STREQ("/d", r.path());
+}
+
+} // namespace hutzn
@@ -0,0 +1,171 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/fixed_capacity_response.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+using small_response = fixed_capacity_response<2, 32, 8>;
+
+TEST(fixed_capacity_response, construction)
+{
+    small_response r;
+    EXPECT_EQ(0, r.header_count());
+    EXPECT_EQ(0, r.content_length());
+    EXPECT_FALSE(r.overflowed());
+    EXPECT_STREQ(NULL, r.header_name(0));
+    EXPECT_STREQ(NULL, r.header_value(0));
+}
+
+TEST(fixed_capacity_response, set_header)
+{
+    small_response r;
+    EXPECT_TRUE(r.set_header("X-A", "b"));
+    EXPECT_TRUE(r.set_header("x-a", "c"));
+    ASSERT_EQ(1, r.header_count());
+    EXPECT_STREQ("X-A", r.header_name(0));
+    EXPECT_STREQ("c", r.header_value(0));
+    EXPECT_STREQ("c", r.find_header("X-a"));
+}
+
+TEST(fixed_capacity_response, clear_header)
+{
+    small_response r;
+    EXPECT_TRUE(r.set_header("X-A", "b"));
+    EXPECT_TRUE(r.set_header("X-B", "c"));
+    EXPECT_TRUE(r.set_header("X-A", ""));
+    ASSERT_EQ(1, r.header_count());
+    EXPECT_STREQ("X-B", r.header_name(0));
+    EXPECT_STREQ(NULL, r.find_header("X-A"));
+}
+
+TEST(fixed_capacity_response, predefined_headers_are_rejected)
+{
+    small_response r;
+    EXPECT_FALSE(r.set_header("Content-Length", "1"));
+    EXPECT_FALSE(r.set_header("server", "a"));
+    EXPECT_FALSE(r.set_header(NULL, "a"));
+    EXPECT_EQ(0, r.header_count());
+}
+
+TEST(fixed_capacity_response, header_slots_exceeded)
+{
+    small_response r;
+    EXPECT_TRUE(r.set_header("X-A", "a"));
+    EXPECT_TRUE(r.set_header("X-B", "b"));
+    EXPECT_FALSE(r.set_header("X-C", "c"));
+    EXPECT_EQ(2, r.header_count());
+
+    r.set_location("/");
+    EXPECT_TRUE(r.overflowed());
+}
+
+TEST(fixed_capacity_response, header_bytes_exceeded)
+{
+    small_response r;
+    EXPECT_FALSE(r.set_header("X-Very-Long-Header", "with a long value"));
+    EXPECT_EQ(0, r.header_count());
+    EXPECT_FALSE(r.overflowed());
+
+    r.reset();
+    r.set_server("a very long server fingerprint, which does not fit");
+    EXPECT_TRUE(r.overflowed());
+}
+
+TEST(fixed_capacity_response, set_content)
+{
+    fixed_capacity_response<2, 64, 16> r;
+    r.set_content({'H', 'e', 'l', 'l', 'o'}, true);
+    ASSERT_EQ(5, r.content_length());
+    EXPECT_EQ(0, ::memcmp("Hello", r.content(), r.content_length()));
+    EXPECT_STREQ("ixqZU8RhEpaoJ6v4xHgE1w==", r.find_header("Content-MD5"));
+
+    r.set_content({'a'}, false);
+    EXPECT_EQ(1, r.content_length());
+    EXPECT_STREQ(NULL, r.find_header("Content-MD5"));
+    EXPECT_FALSE(r.overflowed());
+}
+
+TEST(fixed_capacity_response, set_content_digest)
+{
+    fixed_capacity_response<2, 128, 16> r;
+    r.set_content({'H', 'e', 'l', 'l', 'o'}, false);
+    r.set_content_digest(digest_algorithm::CRC32C);
+    EXPECT_STREQ("crc32c=:gdkOGw==:", r.find_header("Content-Digest"));
+    r.set_content_digest(digest_algorithm::SHA_256);
+    EXPECT_STREQ("sha-256=:GF+NsyJx/iX1Yab8k4suJkMG7DBO2lGAB9F2SCY4GWk=:",
+                 r.find_header("Content-Digest"));
+    EXPECT_FALSE(r.set_header("Content-Digest", "crc32c=:AAAAAA==:"));
+
+    // another content clears the digest of the previous one
+    r.set_content({'a'}, false);
+    EXPECT_STREQ(NULL, r.find_header("Content-Digest"));
+    EXPECT_FALSE(r.overflowed());
+}
+
+TEST(fixed_capacity_response, content_exceeded)
+{
+    small_response r;
+    r.set_content({'1', '2', '3', '4', '5', '6', '7', '8', '9'}, false);
+    EXPECT_EQ(0, r.content_length());
+    EXPECT_TRUE(r.overflowed());
+}
+
+TEST(fixed_capacity_response, locations_and_server)
+{
+    fixed_capacity_response<4, 128, 0> r;
+    r.set_content_location("/a");
+    r.set_location("/b");
+    r.set_server("hutzn");
+    EXPECT_STREQ("/a", r.find_header("Content-Location"));
+    EXPECT_STREQ("/b", r.find_header("Location"));
+    EXPECT_STREQ("hutzn", r.find_header("Server"));
+    EXPECT_FALSE(r.overflowed());
+}
+
+TEST(fixed_capacity_response, retry_after)
+{
+    small_response r;
+    EXPECT_FALSE(r.set_retry_after(-1));
+    EXPECT_TRUE(r.set_retry_after(120));
+    EXPECT_STREQ("120", r.find_header("Retry-After"));
+    EXPECT_TRUE(r.set_retry_after(0));
+    EXPECT_STREQ(NULL, r.find_header("Retry-After"));
+}
+
+TEST(fixed_capacity_response, reset)
+{
+    small_response r;
+    EXPECT_TRUE(r.set_header("X-A", "a"));
+    r.set_content({'a'}, false);
+    r.set_content({'1', '2', '3', '4', '5', '6', '7', '8', '9'}, false);
+    r.reset();
+    EXPECT_EQ(0, r.header_count());
+    EXPECT_EQ(0, r.content_length());
+    EXPECT_FALSE(r.overflowed());
+}
+
+} // namespace hutzn
@@ -16,6 +16,8 @@
  * <http://www.gnu.org/licenses/>.
  */
 
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -263,4 +265,711 @@ TEST_F(lexer_test, content)
     EXPECT_EQ(NULL, lex.content());
 }
 
+TEST_F(lexer_test, pipelined_data)
+{
+    const std::string chunk = "a\n\nbcGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+            EXPECT_LE(chunk.size(), m);
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_TRUE(lex.take_pipelined_data().empty());
+
+    // the content must not contain the next request
+    EXPECT_TRUE(lex.fetch_content(2));
+    EXPECT_EQ(2, lex.content_length());
+    EXPECT_EQ('b', lex.content()[0]);
+    EXPECT_EQ('c', lex.content()[1]);
+
+    const std::string next = "GET / HTTP/1.1\n\n";
+    buffer pipelined = lex.take_pipelined_data();
+    EXPECT_EQ(buffer(next.begin(), next.end()), pipelined);
+    EXPECT_TRUE(lex.take_pipelined_data().empty());
+
+    // the next request gets lexed without receiving data
+    lexer next_lex(conn, std::move(pipelined));
+    EXPECT_TRUE(next_lex.fetch_header());
+    EXPECT_EQ(static_cast<int32_t>('G'), next_lex.get());
+    EXPECT_TRUE(next_lex.fetch_content(0));
+    EXPECT_TRUE(next_lex.take_pipelined_data().empty());
+}
+
+TEST_F(lexer_test, pipelined_data_is_incomplete)
+{
+    const std::string chunk = "\nb\n\nc";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+            EXPECT_LE(chunk.size(), m);
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    const std::string pipelined = "a";
+    lexer lex(conn, buffer(pipelined.begin(), pipelined.end()));
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_EQ(static_cast<int32_t>('a'), lex.get());
+    EXPECT_EQ(static_cast<int32_t>('\n'), lex.get());
+    EXPECT_EQ(static_cast<int32_t>('b'), lex.get());
+    EXPECT_TRUE(lex.fetch_content(0));
+    EXPECT_EQ(buffer({'c'}), lex.take_pipelined_data());
+}
+
+TEST_F(lexer_test, chunked_content)
+{
+    const std::string first = "a\n\n3\r\nbcd\r\n2\r";
+    const std::string second = "\nef\r\n0\r\n\r\nGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillOnce(Invoke([first](buffer& b, const size_t& m) {
+            EXPECT_LE(first.size(), m);
+            b.insert(b.end(), first.begin(), first.end());
+            return true;
+        }))
+        .WillOnce(Invoke([second](buffer& b, const size_t& m) {
+            EXPECT_LE(second.size(), m);
+            b.insert(b.end(), second.begin(), second.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_TRUE(lex.fetch_chunked_content(100));
+    EXPECT_EQ(5, lex.content_length());
+    EXPECT_EQ(0, memcmp("bcdef", lex.content(), 5));
+
+    // calling it again must not decode the content twice
+    EXPECT_TRUE(lex.fetch_chunked_content(100));
+    EXPECT_EQ(5, lex.content_length());
+
+    const std::string next = "GET / HTTP/1.1\n\n";
+    EXPECT_EQ(buffer(next.begin(), next.end()), lex.take_pipelined_data());
+}
+
+TEST_F(lexer_test, content_is_passed_to_sink)
+{
+    const std::string first = "a\n\nbc";
+    const std::string second = "de";
+    const std::string third = "fGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(3)
+        .WillOnce(Invoke([first](buffer& b, const size_t& m) {
+            EXPECT_LE(first.size(), m);
+            b.insert(b.end(), first.begin(), first.end());
+            return true;
+        }))
+        .WillOnce(Invoke([second](buffer& b, const size_t& m) {
+            EXPECT_LE(second.size(), m);
+            b.insert(b.end(), second.begin(), second.end());
+            return true;
+        }))
+        .WillOnce(Invoke([third](buffer& b, const size_t&) {
+            b.insert(b.end(), third.begin(), third.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+
+    // each receive passes its part of the content
+    std::vector<std::string> parts;
+    const content_sink sink = [&parts](const char_t* const data,
+                                       const size_t size) {
+        parts.emplace_back(data, size);
+        return true;
+    };
+    EXPECT_TRUE(lex.fetch_content(5, sink));
+    EXPECT_EQ(std::vector<std::string>({"bc", "de", "f"}), parts);
+
+    // the content is passed as a whole again
+    parts.clear();
+    EXPECT_TRUE(lex.fetch_content(5, sink));
+    EXPECT_EQ(std::vector<std::string>({"bcdef"}), parts);
+
+    const std::string next = "GET / HTTP/1.1\n\n";
+    EXPECT_EQ(buffer(next.begin(), next.end()), lex.take_pipelined_data());
+}
+
+TEST_F(lexer_test, chunked_content_is_passed_to_sink)
+{
+    const std::string first = "a\n\n3\r\nbcd\r\n2\r";
+    const std::string second = "\nef\r\n0\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillOnce(Invoke([first](buffer& b, const size_t& m) {
+            EXPECT_LE(first.size(), m);
+            b.insert(b.end(), first.begin(), first.end());
+            return true;
+        }))
+        .WillOnce(Invoke([second](buffer& b, const size_t& m) {
+            EXPECT_LE(second.size(), m);
+            b.insert(b.end(), second.begin(), second.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+
+    // each receive passes the decoded part of the content
+    std::vector<std::string> parts;
+    const content_sink sink = [&parts](const char_t* const data,
+                                       const size_t size) {
+        parts.emplace_back(data, size);
+        return true;
+    };
+    EXPECT_TRUE(lex.fetch_chunked_content(100, sink));
+    EXPECT_EQ(std::vector<std::string>({"bcd", "ef"}), parts);
+
+    // the decoded content is passed as a whole again
+    parts.clear();
+    EXPECT_TRUE(lex.fetch_chunked_content(100, sink));
+    EXPECT_EQ(std::vector<std::string>({"bcdef"}), parts);
+}
+
+TEST_F(lexer_test, sink_stops_fetching_content)
+{
+    const std::string first = "a\n\nb";
+    const std::string second = "c";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([first](buffer& b, const size_t& m) {
+            EXPECT_LE(first.size(), m);
+            b.insert(b.end(), first.begin(), first.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+
+    // no more data is received after the sink returned false
+    EXPECT_FALSE(
+        lex.fetch_content(2, [](const char_t* const, const size_t) {
+            return false;
+        }));
+    EXPECT_EQ(NULL, lex.content());
+}
+
+TEST_F(lexer_test, chunked_content_is_incomplete)
+{
+    const std::string chunk = "a\n\n3\r\nbc";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+            EXPECT_LE(chunk.size(), m);
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }))
+        .WillOnce(Return(false));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_FALSE(lex.fetch_chunked_content(100));
+    EXPECT_EQ(NULL, lex.content());
+    EXPECT_EQ(0, lex.content_length());
+
+    // the lexer is unusable after a failure
+    EXPECT_FALSE(lex.fetch_chunked_content(100));
+    EXPECT_FALSE(lex.fetch_content(0));
+}
+
+TEST_F(lexer_test, chunked_content_too_large)
+{
+    const std::string chunk = "a\n\n3\r\nbcd\r\n0\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+            EXPECT_LE(chunk.size(), m);
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    EXPECT_CALL(*conn,
+                send(Matcher<const std::string&>(HasSubstr(
+                    "HTTP/1.1 413 Request Entity Too Large\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_FALSE(lex.fetch_chunked_content(2));
+    EXPECT_EQ(NULL, lex.content());
+    EXPECT_EQ(http_status_code::REQUEST_ENTITY_TOO_LARGE,
+              lex.rejection_status());
+}
+
+TEST_F(lexer_test, chunked_trailer_exceeds_header_limits)
+{
+    const std::string chunk = "a\n\n1\r\nb\r\n0\r\nC: d\r\nE: f\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+            EXPECT_LE(chunk.size(), m);
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+    EXPECT_CALL(*conn,
+                send(Matcher<const std::string&>(HasSubstr(
+                    "HTTP/1.1 431 Request Header Fields Too Large\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    header_limits limits;
+    limits.max_header_count = 1;
+    lexer lex(conn, limits);
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_FALSE(lex.fetch_chunked_content(100));
+    EXPECT_EQ(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE,
+              lex.rejection_status());
+}
+
+TEST_F(lexer_test, chunked_extensions_exceed_header_limits)
+{
+    const std::string first = "a\n\n1;abcdefgh";
+    const std::string second = "\r\nb\r\n1;ijklmnop";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillOnce(Invoke([first](buffer& b, const size_t& m) {
+            EXPECT_LE(first.size(), m);
+            b.insert(b.end(), first.begin(), first.end());
+            return true;
+        }))
+        .WillOnce(Invoke([second](buffer& b, const size_t& m) {
+            EXPECT_LE(second.size(), m);
+            b.insert(b.end(), second.begin(), second.end());
+            return true;
+        }));
+    EXPECT_CALL(*conn,
+                send(Matcher<const std::string&>(HasSubstr(
+                    "HTTP/1.1 431 Request Header Fields Too Large\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    header_limits limits;
+    limits.max_header_length = 16;
+    lexer lex(conn, limits);
+    EXPECT_TRUE(lex.fetch_header());
+
+    buffer data;
+    EXPECT_FALSE(lex.read_chunked_content(data, 100, 100));
+    EXPECT_TRUE(data.empty());
+    EXPECT_EQ(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE,
+              lex.rejection_status());
+}
+
+TEST_F(lexer_test, read_content)
+{
+    const std::string first = "a\n\nbc";
+    const std::string second = "defGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillOnce(Invoke([first](buffer& b, const size_t& m) {
+            EXPECT_LE(first.size(), m);
+            b.insert(b.end(), first.begin(), first.end());
+            return true;
+        }))
+        .WillOnce(Invoke([second](buffer& b, const size_t& m) {
+            // only the remaining content is requested
+            EXPECT_EQ(3, m);
+            b.insert(b.end(), second.begin(), second.begin() + 3);
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+
+    buffer data;
+    EXPECT_TRUE(lex.read_content(data, 1, 5));
+    EXPECT_EQ(buffer({'b'}), data);
+    EXPECT_FALSE(lex.content_complete());
+    EXPECT_TRUE(lex.read_content(data, 10, 5));
+    EXPECT_EQ(buffer({'b', 'c'}), data);
+    EXPECT_TRUE(lex.read_content(data, 10, 5));
+    EXPECT_EQ(buffer({'b', 'c', 'd', 'e', 'f'}), data);
+    EXPECT_TRUE(lex.content_complete());
+    EXPECT_FALSE(lex.read_content(data, 10, 5));
+
+    // the content could not be fetched after it was read
+    EXPECT_FALSE(lex.fetch_content(5));
+    EXPECT_EQ(NULL, lex.content());
+}
+
+TEST_F(lexer_test, read_content_keeps_pipelined_data)
+{
+    const std::string chunk = "a\n\nbcGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+            EXPECT_LE(chunk.size(), m);
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+
+    buffer data;
+    EXPECT_TRUE(lex.read_content(data, 10, 2));
+    EXPECT_EQ(buffer({'b', 'c'}), data);
+    EXPECT_FALSE(lex.read_content(data, 10, 2));
+
+    const std::string next = "GET / HTTP/1.1\n\n";
+    EXPECT_EQ(buffer(next.begin(), next.end()), lex.take_pipelined_data());
+}
+
+TEST_F(lexer_test, read_chunked_content)
+{
+    const std::string first = "a\n\n3\r\nbcd\r\n";
+    const std::string second = "2\r\nef\r\n0\r\n\r\nGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillOnce(Invoke([first](buffer& b, const size_t& m) {
+            EXPECT_LE(first.size(), m);
+            b.insert(b.end(), first.begin(), first.end());
+            return true;
+        }))
+        .WillOnce(Invoke([second](buffer& b, const size_t& m) {
+            EXPECT_LE(second.size(), m);
+            b.insert(b.end(), second.begin(), second.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+
+    buffer data;
+    EXPECT_TRUE(lex.read_chunked_content(data, 100, 100));
+    EXPECT_EQ(buffer({'b', 'c', 'd'}), data);
+    EXPECT_FALSE(lex.content_complete());
+
+    data.clear();
+    EXPECT_TRUE(lex.read_chunked_content(data, 100, 100));
+    EXPECT_EQ(buffer({'e', 'f'}), data);
+    EXPECT_TRUE(lex.content_complete());
+    EXPECT_FALSE(lex.read_chunked_content(data, 100, 100));
+
+    const std::string next = "GET / HTTP/1.1\n\n";
+    EXPECT_EQ(buffer(next.begin(), next.end()), lex.take_pipelined_data());
+}
+
+TEST_F(lexer_test, read_malformed_chunked_content)
+{
+    const std::string chunk = "a\n\n3\r\nbcde\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t& m) {
+            EXPECT_LE(chunk.size(), m);
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+    EXPECT_CALL(*conn, send(Matcher<const std::string&>(HasSubstr(
+                           "HTTP/1.1 400 Bad Request\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+
+    buffer data;
+    EXPECT_FALSE(lex.read_chunked_content(data, 100, 100));
+    EXPECT_TRUE(data.empty());
+    EXPECT_FALSE(lex.content_complete());
+    EXPECT_FALSE(lex.read_chunked_content(data, 100, 100));
+}
+
+TEST_F(lexer_test, request_line_at_limit)
+{
+    const std::string chunk = "GET /abc HTTP/1.1\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    header_limits limits;
+    limits.max_request_line_length = 17;
+    lexer lex(conn, limits);
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_EQ(http_status_code::OK, lex.rejection_status());
+}
+
+TEST_F(lexer_test, request_line_too_long)
+{
+    const std::string chunk = "GET /abcd HTTP/1.1\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+    EXPECT_CALL(*conn, send(Matcher<const std::string&>(
+                           HasSubstr("HTTP/1.1 414 Request-URI Too Long\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    header_limits limits;
+    limits.max_request_line_length = 17;
+    lexer lex(conn, limits);
+    EXPECT_FALSE(lex.fetch_header());
+    EXPECT_EQ(http_status_code::REQUEST_URI_TOO_LONG, lex.rejection_status());
+}
+
+TEST_F(lexer_test, request_line_too_long_is_rejected_early)
+{
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([](buffer& b, const size_t&) {
+            b.insert(b.end(), 100, 'a');
+            return true;
+        }));
+    EXPECT_CALL(*conn, send(Matcher<const std::string&>(_)))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    header_limits limits;
+    limits.max_request_line_length = 50;
+    lexer lex(conn, limits);
+    EXPECT_FALSE(lex.fetch_header());
+    EXPECT_EQ(http_status_code::REQUEST_URI_TOO_LONG, lex.rejection_status());
+}
+
+TEST_F(lexer_test, header_too_large)
+{
+    const std::string chunk = "GET / HTTP/1.1\r\nA: bcdefghijk\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+    EXPECT_CALL(*conn,
+                send(Matcher<const std::string&>(HasSubstr(
+                    "HTTP/1.1 431 Request Header Fields Too Large\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    header_limits limits;
+    limits.max_header_length = 20;
+    lexer lex(conn, limits);
+    EXPECT_FALSE(lex.fetch_header());
+    EXPECT_EQ(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE,
+              lex.rejection_status());
+}
+
+TEST_F(lexer_test, too_many_header_fields)
+{
+    const std::string chunk = "GET / HTTP/1.1\r\nA: b\r\n c\r\nD: e\r\n"
+                              "F: g\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+    EXPECT_CALL(*conn, send(Matcher<const std::string&>(_)))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    // folded lines are counted as one header field
+    header_limits limits;
+    limits.max_header_count = 3;
+    lexer lex(conn, limits);
+    EXPECT_TRUE(lex.fetch_header());
+
+    limits.max_header_count = 2;
+    lexer lex2(conn, limits);
+    EXPECT_FALSE(lex2.fetch_header());
+    EXPECT_EQ(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE,
+              lex2.rejection_status());
+}
+
+TEST_F(lexer_test, small_content_is_kept_behind_header)
+{
+    const std::string chunk = "a\r\n\r\nbc";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(2)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }))
+        .WillOnce(Invoke([](buffer& b, const size_t& m) {
+            EXPECT_EQ(1, m);
+            b.push_back('d');
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    const char_t* const header = lex.header_data(0);
+    EXPECT_TRUE(lex.fetch_content(3));
+    EXPECT_EQ(0, memcmp("bcd", lex.content(), 3));
+
+    // the content follows the raw header in the same buffer
+    EXPECT_EQ(header, lex.header_data(0));
+    EXPECT_EQ(header + 5, lex.content());
+}
+
+TEST_F(lexer_test, large_content_keeps_header_valid)
+{
+    const std::string chunk = "a\n\nbc";
+    const size_t length = 1000000;
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(AtLeast(2))
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }))
+        .WillRepeatedly(Invoke([](buffer& b, const size_t& m) {
+            b.insert(b.end(), std::min<size_t>(m, 10000), 'x');
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    const char_t* const header = lex.header_data(0);
+    EXPECT_TRUE(lex.fetch_content(length));
+    EXPECT_EQ(length, lex.content_length());
+    EXPECT_EQ(0, memcmp("bcxx", lex.content(), 4));
+    EXPECT_EQ(header, lex.header_data(0));
+    EXPECT_EQ(static_cast<int32_t>('a'), lex.get());
+}
+
+TEST_F(lexer_test, reset_keeps_data_buffer)
+{
+    const std::string chunk = "a\r\n\r\nbcd\r\n\r\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    const char_t* const header = lex.header_data(0);
+    EXPECT_TRUE(lex.fetch_content(1));
+    EXPECT_EQ(0, memcmp("b", lex.content(), 1));
+
+    // the next request is lexed from the pipelined data in the same buffer
+    lex.reset();
+    EXPECT_EQ(0, lex.content_length());
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_EQ(header, lex.header_data(0));
+    EXPECT_EQ(static_cast<int32_t>('c'), lex.get());
+    EXPECT_EQ(static_cast<int32_t>('d'), lex.get());
+    EXPECT_EQ(static_cast<int32_t>('\n'), lex.get());
+}
+
+
+TEST_F(lexer_test, reset_after_reading_content_in_parts)
+{
+    const std::string chunk = "a\n\nbcGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    const char_t* const header = lex.header_data(0);
+
+    buffer data;
+    EXPECT_TRUE(lex.read_content(data, 1, 2));
+    EXPECT_TRUE(lex.read_content(data, 1, 2));
+    EXPECT_FALSE(lex.read_content(data, 1, 2));
+    EXPECT_EQ(buffer({'b', 'c'}), data);
+
+    // the pipelined data is moved to the front of the data buffer
+    lex.reset();
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_EQ(header, lex.header_data(0));
+    EXPECT_EQ(std::string("GET / HTTP/1.1\n\n"),
+              std::string(lex.header_data(0), lex.header_length()));
+}
+
+TEST_F(lexer_test, reset_after_reading_chunked_content_in_parts)
+{
+    const std::string chunk = "a\n\n1\r\nb\r\n0\r\n\r\nGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    const char_t* const header = lex.header_data(0);
+
+    // the end of the content is found in the middle of a part
+    buffer data;
+    EXPECT_TRUE(lex.read_chunked_content(data, 4, 100));
+    EXPECT_FALSE(lex.read_chunked_content(data, 4, 100));
+    EXPECT_EQ(buffer({'b'}), data);
+    EXPECT_TRUE(lex.content_complete());
+
+    lex.reset();
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_EQ(header, lex.header_data(0));
+    EXPECT_EQ(std::string("GET / HTTP/1.1\n\n"),
+              std::string(lex.header_data(0), lex.header_length()));
+}
+
+TEST_F(lexer_test, reset_after_fetching_chunked_content)
+{
+    const std::string chunk = "a\n\n1\r\nb\r\n0\r\n\r\nGET / HTTP/1.1\n\n";
+    const connection_mock_ptr conn = std::make_shared<connection_mock>();
+    EXPECT_CALL(*conn, receive(_, _))
+        .Times(1)
+        .WillOnce(Invoke([chunk](buffer& b, const size_t&) {
+            b.insert(b.end(), chunk.begin(), chunk.end());
+            return true;
+        }));
+
+    lexer lex(conn);
+    EXPECT_TRUE(lex.fetch_header());
+    const char_t* const header = lex.header_data(0);
+    EXPECT_TRUE(lex.fetch_chunked_content(100));
+    ASSERT_EQ(1, lex.content_length());
+    EXPECT_EQ('b', *lex.content());
+
+    // the pipelined data is kept in the data buffer behind the header
+    lex.reset();
+    EXPECT_TRUE(lex.fetch_header());
+    EXPECT_EQ(header, lex.header_data(0));
+    EXPECT_EQ(std::string("GET / HTTP/1.1\n\n"),
+              std::string(lex.header_data(0), lex.header_length()));
+}
+
 } // namespace hutzn
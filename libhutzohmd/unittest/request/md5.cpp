@@ -16,6 +16,10 @@
  * <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -71,4 +75,97 @@ TEST(md5, nearly_full_block)
     EXPECT_EQ(sum, digest);
 }
 
+TEST(md5, rfc1321_test_suite)
+{
+    const md5_array digest = calculate_md5(
+        "123456789012345678901234567890123456789012345678901234567890123456"
+        "78901234567890",
+        80);
+    const md5_array sum{{0x57, 0xED, 0xF4, 0xA2, 0x2B, 0xE3, 0xC9, 0x55, 0xAC,
+                         0x49, 0xDA, 0x2E, 0x21, 0x07, 0xB6, 0x7A}};
+    EXPECT_EQ(sum, digest);
+
+    const md5_array alphabet_digest =
+        calculate_md5("abcdefghijklmnopqrstuvwxyz", 26);
+    const md5_array alphabet_sum{{0xC3, 0xFC, 0xD3, 0xD7, 0x61, 0x92, 0xE4,
+                                  0x00, 0x7D, 0xFB, 0x49, 0x6C, 0xCA, 0x67,
+                                  0xE1, 0x3B}};
+    EXPECT_EQ(alphabet_sum, alphabet_digest);
+}
+
+TEST(md5, unaligned_data)
+{
+    const std::string data(1 + 200, 'x');
+    const std::string aligned(200, 'x');
+    EXPECT_EQ(calculate_md5(aligned.data(), aligned.size()),
+              calculate_md5(data.data() + 1, data.size() - 1));
+}
+
+TEST(md5, context_with_parts)
+{
+    std::string message;
+    for (size_t i = 0; i < 300; i++) {
+        message.push_back(static_cast<char_t>(i));
+    }
+    const md5_array expected = calculate_md5(message.data(), message.size());
+
+    // parts of all sizes, which complete, fill and skip blocks
+    for (size_t part_size = 1; part_size < 150; part_size++) {
+        md5_context context;
+        for (size_t offset = 0; offset < message.size(); offset += part_size) {
+            const size_t size = std::min(part_size, message.size() - offset);
+            context.update(message.data() + offset, size);
+        }
+        EXPECT_EQ(expected, context.finish()) << part_size;
+    }
+}
+
+TEST(md5, context_restarts_after_finish)
+{
+    const std::string message = "Hello World!";
+    md5_context context;
+    context.update(message.data(), 5);
+    context.reset();
+    context.update(message.data(), message.size());
+    const md5_array first = context.finish();
+    context.update(message.data(), message.size());
+    EXPECT_EQ(first, context.finish());
+    EXPECT_EQ(calculate_md5(message.data(), message.size()), first);
+}
+
+TEST(md5, many_messages)
+{
+    const std::vector<size_t> sizes = {0,  1,   55,  56,  63,  64, 65,
+                                       119, 120, 128, 1000, 3, 200};
+    std::vector<std::string> messages;
+    std::vector<const char_t*> data;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        messages.push_back(std::string(sizes[i], static_cast<char_t>('a' + i)));
+    }
+    for (const std::string& message : messages) {
+        data.push_back(message.data());
+    }
+
+    std::vector<md5_array> digests(sizes.size());
+    calculate_md5(data.data(), sizes.data(), sizes.size(), digests.data());
+    for (size_t i = 0; i < sizes.size(); i++) {
+        EXPECT_EQ(calculate_md5(data[i], sizes[i]), digests[i]) << i;
+    }
+}
+
+TEST(md5, many_messages_known_sums)
+{
+    const std::array<const char_t*, 2> data = {{"", "Hello World!"}};
+    const std::array<size_t, 2> sizes = {{0, 12}};
+    std::array<md5_array, 2> digests;
+    calculate_md5(data.data(), sizes.data(), data.size(), digests.data());
+
+    const md5_array empty_sum{{0xD4, 0x1D, 0x8C, 0xD9, 0x8F, 0x00, 0xB2, 0x04,
+                               0xE9, 0x80, 0x09, 0x98, 0xEC, 0xF8, 0x42, 0x7E}};
+    const md5_array hello_sum{{0xED, 0x07, 0x62, 0x87, 0x53, 0x2E, 0x86, 0x36,
+                               0x5E, 0x84, 0x1E, 0x92, 0xBF, 0xC5, 0x0D, 0x8C}};
+    EXPECT_EQ(empty_sum, digests[0]);
+    EXPECT_EQ(hello_sum, digests[1]);
+}
+
 } // namespace hutzn
@@ -16,11 +16,14 @@
  * <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "libhutznohmd/mock_communication.hpp"
 #include "request/memory_allocating_request.hpp"
+#include "utility/request_arena.hpp"
 
 using namespace testing;
 
@@ -125,6 +128,20 @@ TEST_F(memory_allocating_request_test, default_request)
     EXPECT_STREQ(NULL, r.user_agent());
 }
 
+TEST_F(memory_allocating_request_test, normalized_path)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("GET /a/./b//c/../d?e=f HTTP/1.1\r\n"
+                  "Host: localhost:8080\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_STREQ("/a/b/d", r.path());
+    EXPECT_EQ(std::string_view("/a/b/d"), r.path_view());
+    EXPECT_STREQ("localhost", r.host());
+    EXPECT_STREQ("f", r.query("e"));
+    EXPECT_EQ(http_version::HTTP_1_1, r.version());
+}
+
 TEST_F(memory_allocating_request_test, request_with_content)
 {
     memory_allocating_request r{connection_};
@@ -395,6 +412,32 @@ TEST_F(memory_allocating_request_test, request_with_date)
     EXPECT_STREQ(NULL, r.user_agent());
 }
 
+TEST_F(memory_allocating_request_test, request_with_invalid_date)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("GET / HTTP/1.1\r\nDate: yesterday\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    // the date is converted on first use and is kept afterwards
+    EXPECT_EQ(0, r.date());
+    EXPECT_EQ(0, r.date());
+}
+
+TEST_F(memory_allocating_request_test, date_is_converted_again_after_reset)
+{
+    setup_receive(
+        "GET / HTTP/1.1\r\nDate: Sun, 06 Nov 1994 08:49:37 GMT\r\n\r\n"
+        "GET / HTTP/1.1\r\nDate: Sun, 06 Nov 1994 08:49:38 GMT\r\n\r\n");
+
+    memory_allocating_request r{connection_};
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_EQ(784111777, r.date());
+
+    r.reset();
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_EQ(784111778, r.date());
+}
+
 TEST_F(memory_allocating_request_test, request_with_from)
 {
     memory_allocating_request r{connection_};
@@ -695,6 +738,94 @@ TEST_F(memory_allocating_request_test, custom_header)
     EXPECT_STREQ(NULL, r.user_agent());
 }
 
+TEST_F(memory_allocating_request_test, custom_header_case_insensitive)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("GET / HTTP/1.1\r\nX-Custom: b\r\nx-custom: c\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_STREQ("c", r.header_value("X-CUSTOM"));
+    EXPECT_STREQ("c", r.header_value("x-custom"));
+    EXPECT_STREQ(NULL, r.header_value("x-custo"));
+}
+
+TEST_F(memory_allocating_request_test, header_key_requires_exact_match)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("GET / HTTP/1.1\r\nHostname: a\r\nUser-Agents: b\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_STREQ(NULL, r.host());
+    EXPECT_STREQ(NULL, r.user_agent());
+    EXPECT_STREQ("a", r.header_value("hostname"));
+    EXPECT_STREQ("b", r.header_value("user-agents"));
+}
+
+TEST_F(memory_allocating_request_test, request_with_expect)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("GET / HTTP/1.1\r\nExpect: 100-Continue\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_EQ(http_expectation::CONTINUE, r.expect());
+}
+
+TEST_F(memory_allocating_request_test, many_custom_headers)
+{
+    std::string data = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i < 40; i++) {
+        data += "X-" + std::to_string(i) + ": " + std::to_string(i) + "\r\n";
+    }
+    data += "\r\n";
+
+    memory_allocating_request r{connection_};
+    setup_receive(data);
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_STREQ("0", r.header_value("x-0"));
+    EXPECT_STREQ("31", r.header_value("x-31"));
+    EXPECT_STREQ("32", r.header_value("x-32"));
+    EXPECT_STREQ("39", r.header_value("x-39"));
+    EXPECT_STREQ(NULL, r.header_value("x-40"));
+}
+
+TEST_F(memory_allocating_request_test, custom_headers_allocate_from_arena)
+{
+    std::string data = "GET /?a=b HTTP/1.1\r\n";
+    for (size_t i = 0; i < 40; i++) {
+        data += "X-" + std::to_string(i) + ": " + std::to_string(i) + "\r\n";
+    }
+    data += "\r\n";
+
+    // the arena fails on any allocation beyond its inline buffer
+    request_arena arena{std::pmr::null_memory_resource()};
+    {
+        memory_allocating_request r{connection_, header_limits(),
+                                    arena.resource()};
+        setup_receive(data);
+        ASSERT_TRUE(r.parse(handler_));
+        EXPECT_STREQ("39", r.header_value("x-39"));
+    }
+    arena.release();
+}
+
+TEST_F(memory_allocating_request_test, registered_custom_header)
+{
+    const custom_header_id id = register_custom_header("X-Request-Id");
+    const custom_header_id other = register_custom_header("X-Unused-Id");
+    ASSERT_NE(invalid_custom_header_id, id);
+    ASSERT_NE(invalid_custom_header_id, other);
+
+    memory_allocating_request r{connection_};
+    setup_receive("GET / HTTP/1.1\r\nx-request-id: 1234\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_STREQ("1234", r.registered_header_value(id));
+    EXPECT_STREQ(NULL, r.registered_header_value(other));
+    EXPECT_STREQ(NULL, r.registered_header_value(invalid_custom_header_id));
+    EXPECT_STREQ("1234", r.header_value("X-Request-Id"));
+}
+
 TEST_F(memory_allocating_request_test, parsing_method_failed_because_no_data)
 {
     memory_allocating_request r{connection_};
@@ -817,4 +948,635 @@ TEST_F(memory_allocating_request_test,
     check_request_data(r);
 }
 
+TEST_F(memory_allocating_request_test, common_request_lines)
+{
+    const std::vector<std::tuple<std::string, http_verb, http_version>>
+        request_lines = {
+            {"GET /a HTTP/1.1", http_verb::GET, http_version::HTTP_1_1},
+            {"PUT /a HTTP/1.0", http_verb::PUT, http_version::HTTP_1_0},
+            {"POST /a HTTP/1.1", http_verb::POST, http_version::HTTP_1_1},
+            {"DELETE /a HTTP/1.1", http_verb::DELETE, http_version::HTTP_1_1}};
+
+    for (const auto& line : request_lines) {
+        connection_ = std::make_shared<connection_mock>();
+        memory_allocating_request r{connection_};
+        setup_receive(std::get<0>(line) + "\r\nX-A: b\r\n\r\n");
+        ASSERT_TRUE(r.parse(handler_));
+
+        EXPECT_EQ(std::get<1>(line), r.method());
+        EXPECT_STREQ("/a", r.path());
+        EXPECT_EQ(std::get<2>(line), r.version());
+        EXPECT_STREQ("b", r.header_value("x-a"));
+    }
+}
+
+TEST_F(memory_allocating_request_test, unusual_request_lines)
+{
+    const std::vector<std::tuple<std::string, http_verb, http_version>>
+        request_lines = {
+            {"get /a HTTP/1.1", http_verb::GET, http_version::HTTP_1_1},
+            {"  POST  /a  HTTP/1.1", http_verb::POST, http_version::HTTP_1_1},
+            {"PUT\t/a\tHTTP/1.0", http_verb::PUT, http_version::HTTP_1_0},
+            {"DELETE /a http/1.1", http_verb::DELETE, http_version::HTTP_1_1},
+            {"GET /a HTTP/2", http_verb::GET, http_version::HTTP_2}};
+
+    for (const auto& line : request_lines) {
+        connection_ = std::make_shared<connection_mock>();
+        memory_allocating_request r{connection_};
+        setup_receive(std::get<0>(line) + "\r\nX-A: b\r\n\r\n");
+        ASSERT_TRUE(r.parse(handler_));
+
+        EXPECT_EQ(std::get<1>(line), r.method());
+        EXPECT_STREQ("/a", r.path());
+        EXPECT_EQ(std::get<2>(line), r.version());
+        EXPECT_STREQ("b", r.header_value("x-a"));
+    }
+}
+
+TEST_F(memory_allocating_request_test, identical_heads_are_parsed_once)
+{
+    const std::string head =
+        "POST /a?x=y HTTP/1.1\r\nContent-Length: 2\r\nExpect: 100-continue"
+        "\r\nUser-Agent: probe\r\nX-A:  b\r\n\r\n";
+    parsed_head_cache cache;
+
+    for (size_t i = 0; i < 3; i++) {
+        connection_ = std::make_shared<connection_mock>();
+        memory_allocating_request r{connection_, header_limits(),
+                                    std::pmr::get_default_resource(), &cache};
+        setup_receive(head + "ab");
+        ASSERT_TRUE(r.parse(handler_));
+
+        EXPECT_EQ(http_verb::POST, r.method());
+        EXPECT_STREQ("/a", r.path());
+        EXPECT_STREQ("y", r.query("x"));
+        EXPECT_EQ(http_version::HTTP_1_1, r.version());
+        EXPECT_EQ(http_expectation::CONTINUE, r.expect());
+        EXPECT_STREQ("probe", r.user_agent());
+        EXPECT_STREQ("b", r.header_value("x-a"));
+        EXPECT_TRUE(r.fetch_content());
+        ASSERT_EQ(2, r.content_length());
+        EXPECT_EQ(0, memcmp("ab", r.content(), r.content_length()));
+    }
+
+    std::string normalized = head;
+    normalized.erase(std::remove(normalized.begin(), normalized.end(), '\r'),
+                     normalized.end());
+    EXPECT_TRUE(cache.find(
+        parsed_head_cache::hash(normalized.data(), normalized.size()),
+        normalized.data(), normalized.size()));
+}
+
+TEST_F(memory_allocating_request_test, unusual_heads_are_not_cached)
+{
+    const std::string head = "get /a HTTP/1.1\r\nX-A: b\r\n\r\n";
+    parsed_head_cache cache;
+
+    for (size_t i = 0; i < 2; i++) {
+        connection_ = std::make_shared<connection_mock>();
+        memory_allocating_request r{connection_, header_limits(),
+                                    std::pmr::get_default_resource(), &cache};
+        setup_receive(head);
+        ASSERT_TRUE(r.parse(handler_));
+        EXPECT_STREQ("/a", r.path());
+        EXPECT_STREQ("b", r.header_value("x-a"));
+    }
+
+    const std::string normalized = "get /a HTTP/1.1\nX-A: b\n\n";
+    EXPECT_FALSE(cache.find(
+        parsed_head_cache::hash(normalized.data(), normalized.size()),
+        normalized.data(), normalized.size()));
+}
+
+TEST_F(memory_allocating_request_test, replayed_heads_keep_all_results)
+{
+    const std::string head =
+        "POST /a/../b%20c?x=y#f HTTP/1.0\r\nHost: example.com:8080/?h=i\r\n"
+        "Connection: keep-alive\r\n"
+        "Content-Type: text/plain\r\nContent-Length: 12\r\n"
+        "Content-MD5: 7Qdih1MuhjZehB6Sv8UNjA==\r\n"
+        "Content-Digest: crc32c=:/mzx3A==:\r\n"
+        "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\nFrom: a@b.c\r\n"
+        "Referer: /r\r\nUser-Agent: probe\r\nX-A:  b\r\n\r\n";
+    parsed_head_cache cache;
+
+    for (size_t i = 0; i < 3; i++) {
+        connection_ = std::make_shared<connection_mock>();
+        memory_allocating_request r{connection_, header_limits(),
+                                    std::pmr::get_default_resource(), &cache};
+        setup_receive(head + "Hello World!");
+        ASSERT_TRUE(r.parse(handler_));
+
+        EXPECT_EQ(http_verb::POST, r.method());
+        EXPECT_STREQ("/b c", r.path());
+        EXPECT_STREQ("example.com", r.host());
+        EXPECT_STREQ("y", r.query("x"));
+        EXPECT_STREQ("f", r.fragment());
+        EXPECT_EQ(http_version::HTTP_1_0, r.version());
+        EXPECT_TRUE(r.keeps_connection());
+        EXPECT_EQ(784111777, r.date());
+        EXPECT_EQ(mime(text_type_, plain_subtype_), r.content_type());
+        EXPECT_EQ(http_expectation::UNKNOWN, r.expect());
+        EXPECT_STREQ("a@b.c", r.from());
+        EXPECT_STREQ("/r", r.referer());
+        EXPECT_STREQ("probe", r.user_agent());
+        EXPECT_STREQ("b", r.header_value("x-a"));
+
+        // the content is verified against both sums
+        EXPECT_TRUE(r.fetch_content());
+        ASSERT_EQ(12, r.content_length());
+        EXPECT_EQ(0, memcmp("Hello World!", r.content(), r.content_length()));
+    }
+}
+
+TEST_F(memory_allocating_request_test, replayed_content_type_follows_mime_types)
+{
+    const std::string head =
+        "POST / HTTP/1.1\r\nContent-Type: text/html\r\n\r\n";
+    parsed_head_cache cache;
+    mime_handler other_handler;
+    const mime_subtype html_subtype = handler_.register_mime_subtype("html");
+
+    const auto parse_content_type = [this, &head,
+                                     &cache](const mime_handler& handler) {
+        connection_ = std::make_shared<connection_mock>();
+        memory_allocating_request r{connection_, header_limits(),
+                                    std::pmr::get_default_resource(), &cache};
+        setup_receive(head);
+        EXPECT_TRUE(r.parse(handler));
+        return r.content_type();
+    };
+
+    EXPECT_EQ(mime(text_type_, html_subtype), parse_content_type(handler_));
+    EXPECT_EQ(mime(text_type_, html_subtype), parse_content_type(handler_));
+
+    // another handler or changed mime types parse the value again
+    EXPECT_EQ(mime(mime_type::INVALID, mime_subtype::INVALID),
+              parse_content_type(other_handler));
+    ASSERT_TRUE(handler_.unregister_mime_subtype(html_subtype));
+    EXPECT_EQ(mime(text_type_, mime_subtype::INVALID),
+              parse_content_type(handler_));
+}
+
+TEST_F(memory_allocating_request_test, pipelined_requests)
+{
+    setup_receive(
+        "POST / HTTP/1.1\r\nContent-Length: 2\r\n\r\nabGET /a HTTP/1.1\r\n\r\n"
+        "GET /b HTTP/1.1\r\n\r\n");
+
+    memory_allocating_request r1{connection_};
+    ASSERT_TRUE(r1.parse(handler_));
+    EXPECT_EQ(http_verb::POST, r1.method());
+    EXPECT_TRUE(r1.fetch_content());
+    EXPECT_EQ(0, memcmp("ab", r1.content(), r1.content_length()));
+
+    memory_allocating_request r2{connection_, r1.take_pipelined_data()};
+    ASSERT_TRUE(r2.parse(handler_));
+    EXPECT_EQ(http_verb::GET, r2.method());
+    EXPECT_STREQ("/a", r2.path());
+
+    // the content of the second request was not fetched explicitly
+    memory_allocating_request r3{connection_, r2.take_pipelined_data()};
+    ASSERT_TRUE(r3.parse(handler_));
+    EXPECT_EQ(http_verb::GET, r3.method());
+    EXPECT_STREQ("/b", r3.path());
+    EXPECT_TRUE(r3.take_pipelined_data().empty());
+}
+
+TEST_F(memory_allocating_request_test, query_entries)
+{
+    memory_allocating_request r{connection_};
+    setup_receive(
+        "GET /p?a=1&b=x%3Dy%26z&c&&d=&%65+f=g+h&a=2#frag HTTP/1.1\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_STREQ("/p", r.path());
+    EXPECT_STREQ("frag", r.fragment());
+    EXPECT_STREQ("2", r.query("a"));
+    EXPECT_STREQ("x=y&z", r.query("b"));
+    EXPECT_STREQ("", r.query("c"));
+    EXPECT_STREQ("", r.query("d"));
+    EXPECT_STREQ("g h", r.query("e f"));
+    EXPECT_STREQ(NULL, r.query("A"));
+    EXPECT_STREQ(NULL, r.query("z"));
+    EXPECT_STREQ(NULL, r.query(NULL));
+}
+
+TEST_F(memory_allocating_request_test, string_views)
+{
+    memory_allocating_request r{connection_};
+    setup_receive(
+        "GET /p%20q?a=b%00c#frag HTTP/1.1\r\nHost: example.com:8080\r\n"
+        "From: a@b.c\r\nReferer: /r\r\nUser-Agent:  ua \r\nX-A: x\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_EQ(std::string_view("/p q"), r.path_view());
+    EXPECT_EQ(std::string_view("example.com"), r.host_view());
+    EXPECT_EQ(std::string_view("frag"), r.fragment_view());
+    EXPECT_EQ(std::string_view("b\0c", 3), r.query_view("a"));
+    EXPECT_EQ(std::string_view("a@b.c"), r.from_view());
+    EXPECT_EQ(std::string_view("/r"), r.referer_view());
+    EXPECT_EQ(r.user_agent(), r.user_agent_view().data());
+    EXPECT_EQ(strlen(r.user_agent()), r.user_agent_view().size());
+    EXPECT_EQ(std::string_view("x"), r.header_value_view("x-a"));
+
+    EXPECT_EQ(NULL, r.query_view("b").data());
+    EXPECT_EQ(NULL, r.header_value_view("X-B").data());
+    EXPECT_EQ(NULL, r.header_value_view(NULL).data());
+}
+
+TEST_F(memory_allocating_request_test, invalid_query_encoding)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("GET /p?a=%4 HTTP/1.1\r\n\r\n");
+    EXPECT_CALL(*connection_, send(Matcher<const std::string&>(HasSubstr(
+                                  "HTTP/1.1 400 Bad Request\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_FALSE(r.parse(handler_));
+}
+
+TEST_F(memory_allocating_request_test, reset_for_next_request)
+{
+    setup_receive(
+        "POST /a?x=y HTTP/1.1\r\nContent-Length: 2\r\nFrom: a@b.c\r\n"
+        "X-A: 1\r\n\r\nabGET /b HTTP/1.0\r\nX-B: 2\r\n\r\n");
+
+    memory_allocating_request r{connection_};
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_EQ(http_verb::POST, r.method());
+    EXPECT_STREQ("1", r.header_value("X-A"));
+    EXPECT_STREQ("y", r.query("x"));
+
+    // the content of the first request was not fetched explicitly
+    r.reset();
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_EQ(http_verb::GET, r.method());
+    EXPECT_STREQ("/b", r.path());
+    EXPECT_EQ(http_version::HTTP_1_0, r.version());
+    EXPECT_EQ(0, r.content_length());
+    EXPECT_STREQ(NULL, r.from());
+    EXPECT_STREQ(NULL, r.header_value("X-A"));
+    EXPECT_STREQ("2", r.header_value("X-B"));
+    EXPECT_STREQ(NULL, r.query("x"));
+    EXPECT_TRUE(r.take_pipelined_data().empty());
+}
+
+TEST_F(memory_allocating_request_test, chunked_content)
+{
+    memory_allocating_request r{connection_};
+    setup_receive(
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+        "Content-Length: 100\r\n\r\n3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n"
+        "GET /a HTTP/1.1\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_EQ(http_verb::POST, r.method());
+
+    EXPECT_TRUE(r.fetch_content());
+    EXPECT_EQ(5, r.content_length());
+    EXPECT_EQ(0, memcmp("abcde", r.content(), r.content_length()));
+
+    memory_allocating_request r2{connection_, r.take_pipelined_data()};
+    ASSERT_TRUE(r2.parse(handler_));
+    EXPECT_STREQ("/a", r2.path());
+}
+
+TEST_F(memory_allocating_request_test, chunked_content_with_md5)
+{
+    memory_allocating_request r{connection_};
+    setup_receive(
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+        "Content-MD5: 7Qdih1MuhjZehB6Sv8UNjA==\r\n\r\n"
+        "6\r\nHello \r\n6\r\nWorld!\r\n0\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_TRUE(r.fetch_content());
+    EXPECT_EQ(12, r.content_length());
+}
+
+TEST_F(memory_allocating_request_test, malformed_chunked_content)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                  "3\r\nabcd\r\n0\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_CALL(*connection_, send(Matcher<const std::string&>(HasSubstr(
+                                  "HTTP/1.1 400 Bad Request\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+    EXPECT_EQ(0, r.content_length());
+    EXPECT_EQ(http_status_code::BAD_REQUEST, r.rejection_status());
+}
+
+TEST_F(memory_allocating_request_test, chunked_content_with_bare_cr)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                  "1\r2\r\n012345678901234567\r\n0\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_CALL(*connection_, send(Matcher<const std::string&>(HasSubstr(
+                                  "HTTP/1.1 400 Bad Request\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(http_status_code::BAD_REQUEST, r.rejection_status());
+}
+
+TEST_F(memory_allocating_request_test, unsupported_transfer_encoding)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n"
+                  "Content-Length: 2\r\n\r\nab");
+    EXPECT_CALL(*connection_, send(Matcher<const std::string&>(HasSubstr(
+                                  "HTTP/1.1 501 Not Implemented\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_FALSE(r.parse(handler_));
+    EXPECT_EQ(http_status_code::NOT_IMPLEMENTED, r.rejection_status());
+}
+
+TEST_F(memory_allocating_request_test, chunked_not_last_transfer_coding)
+{
+    for (const char_t* const coding :
+         {"gzip", "chunked, identity", "chunked, chunked"}) {
+        memory_allocating_request r{connection_};
+        setup_receive(std::string("POST / HTTP/1.1\r\nTransfer-Encoding: ") +
+                      coding + "\r\nContent-Length: 2\r\n\r\nab");
+        EXPECT_CALL(*connection_, send(Matcher<const std::string&>(HasSubstr(
+                                      "HTTP/1.1 400 Bad Request\r\n"))))
+            .Times(1)
+            .WillOnce(Return(true));
+        EXPECT_FALSE(r.parse(handler_));
+        EXPECT_EQ(http_status_code::BAD_REQUEST, r.rejection_status());
+    }
+}
+
+TEST_F(memory_allocating_request_test, chunked_in_separate_header_fields)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+                  "Transfer-Encoding: gzip\r\n\r\n0\r\n\r\n");
+    EXPECT_CALL(*connection_, send(Matcher<const std::string&>(HasSubstr(
+                                  "HTTP/1.1 400 Bad Request\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_FALSE(r.parse(handler_));
+}
+
+TEST_F(memory_allocating_request_test, chunked_content_with_content_length)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 3\r\n"
+                  "Transfer-Encoding: Chunked ; q=1\r\n\r\n"
+                  "2\r\nab\r\n0\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+    EXPECT_EQ(0, r.content_length());
+    EXPECT_FALSE(r.keeps_connection());
+
+    EXPECT_TRUE(r.fetch_content());
+    EXPECT_EQ(2, r.content_length());
+    EXPECT_EQ(0, memcmp("ab", r.content(), r.content_length()));
+}
+
+TEST_F(memory_allocating_request_test, read_some)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nabcde"
+                  "GET /a HTTP/1.1\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    buffer data;
+    EXPECT_TRUE(r.read_some(data, 3));
+    EXPECT_TRUE(r.read_some(data, 3));
+    EXPECT_FALSE(r.read_some(data, 3));
+    EXPECT_EQ(buffer({'a', 'b', 'c', 'd', 'e'}), data);
+
+    // the buffered content is not available after reading it in parts
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+
+    memory_allocating_request r2{connection_, r.take_pipelined_data()};
+    ASSERT_TRUE(r2.parse(handler_));
+    EXPECT_STREQ("/a", r2.path());
+}
+
+TEST_F(memory_allocating_request_test, stream_chunked_content)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                  "3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    std::string content;
+    EXPECT_TRUE(r.stream_content([&content](const char_t* const data,
+                                            const size_t size) {
+        content.append(data, size);
+        return true;
+    }));
+    EXPECT_EQ("abcde", content);
+}
+
+TEST_F(memory_allocating_request_test, stream_incomplete_content)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nabc");
+    ASSERT_TRUE(r.parse(handler_));
+
+    std::string content;
+    EXPECT_FALSE(r.stream_content([&content](const char_t* const data,
+                                             const size_t size) {
+        content.append(data, size);
+        return true;
+    }));
+    EXPECT_EQ("abc", content);
+}
+
+TEST_F(memory_allocating_request_test, stream_content_with_md5)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+                  "Content-MD5: 7Qdih1MuhjZehB6Sv8UNjA==\r\n\r\n"
+                  "6\r\nHello \r\n6\r\nWorld!\r\n0\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    std::string content;
+    EXPECT_TRUE(r.stream_content([&content](const char_t* const data,
+                                            const size_t size) {
+        content.append(data, size);
+        return true;
+    }));
+    EXPECT_EQ("Hello World!", content);
+}
+
+TEST_F(memory_allocating_request_test, stream_content_with_wrong_md5)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 12\r\n"
+                  "Content-MD5: 7Qdih1MuhjZehB6Sv8UNjA==\r\n\r\n"
+                  "Hello world!");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_FALSE(r.stream_content(
+        [](const char_t* const, const size_t) { return true; }));
+}
+
+TEST_F(memory_allocating_request_test, truncated_content_with_checksum)
+{
+    memory_allocating_request r{connection_};
+    setup_receive(
+        "GET / HTTP/1.1\r\nContent-Length: 12\r\nContent-MD5: "
+        "7Qdih1MuhjZehB6Sv8UNjA==\r\n\r\nHello");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+}
+
+TEST_F(memory_allocating_request_test, truncated_content_with_content_digest)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 12\r\n"
+                  "Content-Digest: crc32c=:/mzx3A==:\r\n\r\nHello");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+}
+
+TEST_F(memory_allocating_request_test, retried_fetch_hashes_content_once)
+{
+    const std::string head = "POST / HTTP/1.1\r\nContent-Length: 12\r\n"
+                             "Content-MD5: 7Qdih1MuhjZehB6Sv8UNjA==\r\n"
+                             "Content-Digest: crc32c=:/mzx3A==:\r\n\r\n"
+                             "Hello";
+    const std::string tail = " World!";
+    EXPECT_CALL(*connection_, receive(_, _))
+        .Times(3)
+        .WillOnce(Invoke([head](buffer& b, const size_t&) {
+            b.insert(b.end(), head.begin(), head.end());
+            return true;
+        }))
+        .WillOnce(Return(false))
+        .WillOnce(Invoke([tail](buffer& b, const size_t&) {
+            b.insert(b.end(), tail.begin(), tail.end());
+            return true;
+        }));
+
+    memory_allocating_request r{connection_};
+    ASSERT_TRUE(r.parse(handler_));
+
+    // the sums of the incomplete content are dropped
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+    EXPECT_TRUE(r.fetch_content());
+    EXPECT_EQ(0, memcmp("Hello World!", r.content(), r.content_length()));
+
+    // the content is verified again as a whole
+    EXPECT_TRUE(r.fetch_content());
+}
+
+TEST_F(memory_allocating_request_test, request_with_content_digest)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 12\r\n"
+                  "Content-Digest: crc32c=:/mzx3A==:, sha-256="
+                  ":f4OxZX/x/FO5LcGBSKHWXfwtSx+j1ncoSt3SABJtkGk=:\r\n\r\n"
+                  "Hello World!");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_TRUE(r.fetch_content());
+    EXPECT_EQ(0, memcmp("Hello World!", r.content(), r.content_length()));
+}
+
+TEST_F(memory_allocating_request_test, request_with_wrong_content_digest)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 12\r\n"
+                  "Content-Digest: crc32c=:/mzx3A==:\r\n\r\n"
+                  "Hello world!");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+}
+
+TEST_F(memory_allocating_request_test, request_with_malformed_content_digest)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 12\r\n"
+                  "Content-Digest: crc32c=:AAAA:\r\n\r\n"
+                  "Hello World!");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+}
+
+TEST_F(memory_allocating_request_test,
+       request_with_malformed_second_content_digest)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 12\r\n"
+                  "Content-Digest: crc32c=:/mzx3A==:, sha-256=:AAAA:\r\n\r\n"
+                  "Hello World!");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_FALSE(r.fetch_content());
+    EXPECT_EQ(NULL, r.content());
+}
+
+TEST_F(memory_allocating_request_test, stream_content_with_content_digest)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+                  "Content-Digest: sha-256="
+                  ":f4OxZX/x/FO5LcGBSKHWXfwtSx+j1ncoSt3SABJtkGk=:\r\n\r\n"
+                  "6\r\nHello \r\n6\r\nWorld!\r\n0\r\n\r\n");
+    ASSERT_TRUE(r.parse(handler_));
+
+    EXPECT_TRUE(r.stream_content(
+        [](const char_t* const, const size_t) { return true; }));
+}
+
+TEST_F(memory_allocating_request_test, stream_content_stopped_by_sink)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("POST / HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc");
+    ASSERT_TRUE(r.parse(handler_));
+
+    size_t calls = 0;
+    EXPECT_FALSE(r.stream_content([&calls](const char_t* const, const size_t) {
+        calls++;
+        return false;
+    }));
+    EXPECT_EQ(1, calls);
+}
+
+TEST_F(memory_allocating_request_test, malformed_request_is_rejected)
+{
+    memory_allocating_request r{connection_};
+    setup_receive("FOO / HTTP/1.1\r\n\r\n");
+    EXPECT_CALL(*connection_, send(Matcher<const std::string&>(HasSubstr(
+                                  "HTTP/1.1 400 Bad Request\r\n"))))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_FALSE(r.parse(handler_));
+    EXPECT_EQ(http_status_code::BAD_REQUEST, r.rejection_status());
+}
+
+TEST_F(memory_allocating_request_test, request_exceeding_limits)
+{
+    header_limits limits;
+    limits.max_header_count = 0;
+    memory_allocating_request r{connection_, limits};
+    setup_receive("GET / HTTP/1.1\r\na: b\r\n\r\n");
+    EXPECT_CALL(*connection_, send(Matcher<const std::string&>(_)))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_FALSE(r.parse(handler_));
+    EXPECT_EQ(http_status_code::REQUEST_HEADER_FIELDS_TOO_LARGE,
+              r.rejection_status());
+}
+
 } // namespace hutzn
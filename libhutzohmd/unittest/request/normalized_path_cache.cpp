@@ -0,0 +1,136 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/normalized_path_cache.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+using normalize_path_test_param = std::tuple<const char_t*, const char_t*>;
+
+class normalize_path_test : public TestWithParam<normalize_path_test_param>
+{
+};
+
+std::vector<normalize_path_test_param> get_all_normalize_path_test_params()
+{
+    std::vector<normalize_path_test_param> result;
+    result.push_back(std::make_tuple("/", "/"));
+    result.push_back(std::make_tuple("/a/b", "/a/b"));
+    result.push_back(std::make_tuple("/a/b/", "/a/b/"));
+    result.push_back(std::make_tuple("/a/./b", "/a/b"));
+    result.push_back(std::make_tuple("/a//b", "/a/b"));
+    result.push_back(std::make_tuple("//a///b//", "/a/b/"));
+    result.push_back(std::make_tuple("/a/b/../c", "/a/c"));
+    result.push_back(std::make_tuple("/a/b/..", "/a/"));
+    result.push_back(std::make_tuple("/a/b/.", "/a/b/"));
+    result.push_back(std::make_tuple("/..", "/"));
+    result.push_back(std::make_tuple("/../../a", "/a"));
+    result.push_back(std::make_tuple("/.", "/"));
+    result.push_back(std::make_tuple("/a/b/c/./../../g", "/a/g"));
+    result.push_back(std::make_tuple("/mid/content=5/../6", "/mid/6"));
+    result.push_back(std::make_tuple("/.a/..b/...", "/.a/..b/..."));
+    return result;
+}
+
+INSTANTIATE_TEST_SUITE_P(normalized_path_cache, normalize_path_test,
+                         ValuesIn(get_all_normalize_path_test_params()));
+
+TEST_P(normalize_path_test, normalize)
+{
+    const char_t* input;
+    const char_t* output;
+    std::tie(input, output) = GetParam();
+
+    std::string path = input;
+    const size_t length = normalize_path(&(path[0]), path.size());
+    EXPECT_EQ(output, path.substr(0, length));
+    EXPECT_EQ(path.substr(0, length) == input,
+              is_normalized_path(input, path.size()));
+
+    // normalizing again does not change anything
+    EXPECT_TRUE(is_normalized_path(path.data(), length));
+    EXPECT_EQ(length, normalize_path(&(path[0]), length));
+}
+
+TEST(normalized_path_cache, normalizes_empty_path)
+{
+    EXPECT_EQ(0, normalize_path(NULL, 0));
+    EXPECT_TRUE(is_normalized_path(NULL, 0));
+}
+
+TEST(normalized_path_cache, caches_only_paths_to_normalize)
+{
+    normalized_path_cache cache;
+    std::string path = "/a/b";
+    EXPECT_EQ(4, cache.normalize(&(path[0]), path.size()));
+    EXPECT_FALSE(cache.contains("/a/b", 4));
+
+    path = "/a/./b";
+    EXPECT_FALSE(cache.contains("/a/./b", 6));
+    EXPECT_EQ(4, cache.normalize(&(path[0]), path.size()));
+    EXPECT_EQ("/a/b", path.substr(0, 4));
+    EXPECT_TRUE(cache.contains("/a/./b", 6));
+
+    path = "/a/./b";
+    EXPECT_EQ(4, cache.normalize(&(path[0]), path.size()));
+    EXPECT_EQ("/a/b", path.substr(0, 4));
+}
+
+TEST(normalized_path_cache, does_not_cache_long_paths)
+{
+    normalized_path_cache cache;
+    const std::string original =
+        "/" + std::string(normalized_path_cache::max_path_length, 'a') + "/..";
+    std::string path = original;
+    EXPECT_EQ(1, cache.normalize(&(path[0]), path.size()));
+    EXPECT_EQ('/', path[0]);
+    EXPECT_FALSE(cache.contains(original.data(), original.size()));
+}
+
+TEST(normalized_path_cache, replaces_paths_in_the_same_slot)
+{
+    normalized_path_cache cache;
+    std::vector<std::string> originals;
+    for (size_t i = 0; i <= normalized_path_cache::capacity; i++) {
+        originals.push_back("/" + std::to_string(i) + "//x");
+        std::string path = originals.back();
+        EXPECT_EQ(path.size() - 1, cache.normalize(&(path[0]), path.size()));
+    }
+
+    // there are more paths than slots
+    size_t cached = 0;
+    for (const std::string& original : originals) {
+        if (cache.contains(original.data(), original.size())) {
+            cached++;
+        }
+    }
+    EXPECT_LT(0, cached);
+    EXPECT_GT(originals.size(), cached);
+}
+
+} // namespace hutzn
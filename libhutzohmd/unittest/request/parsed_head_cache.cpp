@@ -0,0 +1,132 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/memory_allocating_request.hpp"
+#include "request/parsed_head_cache.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+namespace
+{
+
+std::shared_ptr<const parsed_head> make_parsed_head(const std::string& head)
+{
+    std::shared_ptr<parsed_head> result = std::make_shared<parsed_head>();
+    result->hash = parsed_head_cache::hash(head.data(), head.size());
+    result->head.assign(head.begin(), head.end());
+    result->method = http_verb::GET;
+    result->version = http_version::HTTP_1_1;
+    result->end = head.size();
+    return result;
+}
+
+} // namespace
+
+TEST(parsed_head_cache, hash)
+{
+    const std::string a = "GET / HTTP/1.1\n\n";
+    const std::string b = "GET / HTTP/1.0\n\n";
+    EXPECT_EQ(parsed_head_cache::hash(a.data(), a.size()),
+              parsed_head_cache::hash(a.data(), a.size()));
+    EXPECT_NE(parsed_head_cache::hash(a.data(), a.size()),
+              parsed_head_cache::hash(b.data(), b.size()));
+    EXPECT_NE(parsed_head_cache::hash(a.data(), a.size()),
+              parsed_head_cache::hash(a.data(), a.size() - 1));
+}
+
+TEST(parsed_head_cache, find)
+{
+    parsed_head_cache cache;
+    const std::string head = "GET / HTTP/1.1\n\n";
+    const uint64_t hash = parsed_head_cache::hash(head.data(), head.size());
+    EXPECT_FALSE(cache.find(hash, head.data(), head.size()));
+
+    cache.insert(make_parsed_head(head));
+    const std::shared_ptr<const parsed_head> found =
+        cache.find(hash, head.data(), head.size());
+    ASSERT_TRUE(found);
+    EXPECT_EQ(http_verb::GET, found->method);
+    EXPECT_EQ(head.size(), found->end);
+}
+
+TEST(parsed_head_cache, find_verifies_the_head)
+{
+    parsed_head_cache cache;
+    const std::string head = "GET / HTTP/1.1\n\n";
+    const std::string other = "GET / HTTP/1.0\n\n";
+    const uint64_t hash = parsed_head_cache::hash(head.data(), head.size());
+    cache.insert(make_parsed_head(head));
+
+    // a colliding hash must not return the parsed form of another head
+    EXPECT_FALSE(cache.find(hash, other.data(), other.size()));
+    EXPECT_FALSE(cache.find(hash, head.data(), head.size() - 1));
+}
+
+TEST(parsed_head_cache, newer_head_replaces_older_one)
+{
+    // a single slot is shared by all heads
+    parsed_head_cache cache{1};
+    const std::string head = "GET / HTTP/1.1\n\n";
+    const std::string other = "GET / HTTP/1.0\n\n";
+    cache.insert(make_parsed_head(head));
+    const std::shared_ptr<const parsed_head> found = cache.find(
+        parsed_head_cache::hash(head.data(), head.size()), head.data(),
+        head.size());
+    cache.insert(make_parsed_head(other));
+
+    EXPECT_FALSE(cache.find(parsed_head_cache::hash(head.data(), head.size()),
+                            head.data(), head.size()));
+    EXPECT_TRUE(cache.find(parsed_head_cache::hash(other.data(), other.size()),
+                           other.data(), other.size()));
+
+    // an entry in use stays valid
+    ASSERT_TRUE(found);
+    EXPECT_EQ(0, ::memcmp(head.data(), found->head.data(), head.size()));
+}
+
+TEST(parsed_head_cache, long_heads_are_not_cached)
+{
+    parsed_head_cache cache{parsed_head_cache::default_capacity, 8};
+    const std::string head = "GET / HTTP/1.1\n\n";
+    EXPECT_FALSE(cache.accepts(head.size()));
+    EXPECT_TRUE(cache.accepts(8));
+
+    cache.insert(make_parsed_head(head));
+    EXPECT_FALSE(cache.find(parsed_head_cache::hash(head.data(), head.size()),
+                            head.data(), head.size()));
+}
+
+TEST(parsed_head_cache, instance_is_per_thread)
+{
+    parsed_head_cache* other = NULL;
+    std::thread t([&other]() { other = &parsed_head_cache::instance(); });
+    t.join();
+    EXPECT_NE(other, &parsed_head_cache::instance());
+    EXPECT_EQ(&parsed_head_cache::instance(), &parsed_head_cache::instance());
+}
+
+} // namespace hutzn
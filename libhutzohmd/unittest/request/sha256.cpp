@@ -0,0 +1,104 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "request/sha256.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+namespace
+{
+
+std::string to_hex(const sha256_array& sum)
+{
+    static const char_t digits[] = "0123456789abcdef";
+    std::string result;
+    for (const uint8_t byte : sum) {
+        result.push_back(digits[byte >> 4]);
+        result.push_back(digits[byte & 0x0F]);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(sha256, fips180_test_suite)
+{
+    const std::string two_blocks =
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const std::string million(1000000, 'a');
+
+    EXPECT_EQ(
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+        to_hex(calculate_sha256("", 0)));
+    EXPECT_EQ(
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+        to_hex(calculate_sha256("abc", 3)));
+    EXPECT_EQ(
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+        to_hex(calculate_sha256(two_blocks.data(), two_blocks.size())));
+    EXPECT_EQ(
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+        to_hex(calculate_sha256(million.data(), million.size())));
+}
+
+TEST(sha256, context_with_parts)
+{
+    std::string message;
+    for (size_t i = 0; i < 300; i++) {
+        message.push_back(static_cast<char_t>(i));
+    }
+    const sha256_array expected =
+        calculate_sha256(message.data(), message.size());
+
+    for (size_t part_size = 1; part_size < 150; part_size++) {
+        sha256_context context;
+        for (size_t offset = 0; offset < message.size(); offset += part_size) {
+            const size_t size = std::min(part_size, message.size() - offset);
+            context.update(message.data() + offset, size);
+        }
+        EXPECT_EQ(expected, context.finish()) << part_size;
+    }
+}
+
+TEST(sha256, portable_equals_accelerated)
+{
+    std::string message;
+    for (size_t i = 0; i < 8 * 64 + 1; i++) {
+        message.push_back(static_cast<char_t>(i * 13));
+    }
+
+    // the data is deliberately unaligned
+    for (size_t blocks = 0; blocks <= 8; blocks++) {
+        sha256_state portable = {{1, 2, 3, 4, 5, 6, 7, 8}};
+        sha256_state accelerated = portable;
+        detail::process_sha256_portable(portable, message.data() + 1, blocks);
+        detail::process_sha256(accelerated, message.data() + 1, blocks);
+        EXPECT_EQ(portable, accelerated) << blocks;
+    }
+}
+
+} // namespace hutzn
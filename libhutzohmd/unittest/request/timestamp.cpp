@@ -16,6 +16,10 @@
  * <http://www.gnu.org/licenses/>.
  */
 
+#include <array>
+#include <cctype>
+#include <string>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -75,6 +79,63 @@ TEST(timestamp, rfc1123_erroneous_gmt)
     EXPECT_EQ(-1, timestamp);
 }
 
+TEST(timestamp, imf_fixdate_equals_general_parser)
+{
+    // lower case names are not accepted by the fast path
+    const std::array<std::string, 7> dates = {
+        {"Mon, 01 Jan 1970 00:00:00 GMT", "Tue, 29 Feb 2000 23:59:59 GMT",
+         "Wed, 31 Mar 2021 12:30:45 GMT", "Thu, 15 Jul 1999 07:08:09 GMT",
+         "Fri, 31 Dec 2099 23:59:59 GMT", "Sat, 30 Apr 2011 01:02:03 GMT",
+         "Sun, 06 Nov 1994 08:49:37 GMT"}};
+    for (const std::string& date : dates) {
+        std::string lower_case = date;
+        for (char_t& c : lower_case) {
+            c = static_cast<char_t>(::tolower(c));
+        }
+        const time_t timestamp = parse_timestamp(date.data(), date.size());
+        EXPECT_LE(0, timestamp) << date;
+        EXPECT_EQ(parse_timestamp(lower_case.data(), lower_case.size()),
+                  timestamp)
+            << date;
+    }
+}
+
+TEST(timestamp, imf_fixdate_with_all_months)
+{
+    const std::array<const char_t*, 12> months = {{"Jan", "Feb", "Mar", "Apr",
+                                                   "May", "Jun", "Jul", "Aug",
+                                                   "Sep", "Oct", "Nov", "Dec"}};
+    time_t previous = -1;
+    for (const char_t* const month : months) {
+        const std::string date =
+            std::string("Sun, 01 ") + month + " 2017 00:00:00 GMT";
+        const time_t timestamp = parse_timestamp(date.data(), date.size());
+        EXPECT_LT(previous, timestamp) << date;
+        previous = timestamp;
+    }
+}
+
+TEST(timestamp, imf_fixdate_erroneous_digits)
+{
+    const std::array<std::string, 5> dates = {
+        {"Sun, 0x Nov 1994 08:49:37 GMT", "Sun, 06 Nov 19/4 08:49:37 GMT",
+         "Sun, 06 Nov 1994 08:49:3\xB7 GMT", "Sun, 06 Nov 1994 08:49:37 GMX",
+         "Sun, 32 Nov 1994 08:49:37 GMT"}};
+    for (const std::string& date : dates) {
+        EXPECT_EQ(-1, parse_timestamp(date.data(), date.size())) << date;
+    }
+}
+
+TEST(timestamp, repeated_imf_fixdate)
+{
+    const std::string first = "Sun, 06 Nov 1994 08:49:37 GMT";
+    const std::string second = "Sun, 06 Nov 1994 08:49:38 GMT";
+    EXPECT_EQ(784111777, parse_timestamp(first.data(), first.size()));
+    EXPECT_EQ(784111777, parse_timestamp(first.data(), first.size()));
+    EXPECT_EQ(784111778, parse_timestamp(second.data(), second.size()));
+    EXPECT_EQ(784111777, parse_timestamp(first.data(), first.size()));
+}
+
 TEST(timestamp, rfc850_sunday)
 {
     const std::string str = "Sunday, 14-Apr-85 00:00:00 GMT";
@@ -334,4 +395,59 @@ TEST(timestamp, tab_before_date)
     EXPECT_EQ(784111777, timestamp);
 }
 
+TEST(timestamp, leap_day_date)
+{
+    const std::string str = "Tue, 29 Feb 2000 23:59:59 GMT";
+    const time_t timestamp = parse_timestamp(str.data(), str.size());
+    EXPECT_EQ(951868799, timestamp);
+}
+
+TEST(timestamp, format_date)
+{
+    std::array<char_t, imf_fixdate_length> date;
+    ASSERT_EQ(imf_fixdate_length, format_timestamp(784111777, date.data()));
+    EXPECT_EQ("Sun, 06 Nov 1994 08:49:37 GMT",
+              std::string(date.data(), date.size()));
+
+    ASSERT_EQ(imf_fixdate_length, format_timestamp(0, date.data()));
+    EXPECT_EQ("Thu, 01 Jan 1970 00:00:00 GMT",
+              std::string(date.data(), date.size()));
+}
+
+TEST(timestamp, format_leap_year_dates)
+{
+    std::array<char_t, imf_fixdate_length> date;
+    ASSERT_EQ(imf_fixdate_length, format_timestamp(951782400, date.data()));
+    EXPECT_EQ("Tue, 29 Feb 2000 00:00:00 GMT",
+              std::string(date.data(), date.size()));
+
+    ASSERT_EQ(imf_fixdate_length, format_timestamp(951868800, date.data()));
+    EXPECT_EQ("Wed, 01 Mar 2000 00:00:00 GMT",
+              std::string(date.data(), date.size()));
+
+    ASSERT_EQ(imf_fixdate_length, format_timestamp(978220800, date.data()));
+    EXPECT_EQ("Sun, 31 Dec 2000 00:00:00 GMT",
+              std::string(date.data(), date.size()));
+}
+
+TEST(timestamp, format_out_of_range)
+{
+    std::array<char_t, imf_fixdate_length> date;
+    EXPECT_EQ(0, format_timestamp(-1, date.data()));
+    EXPECT_EQ(0, format_timestamp(4102444800, date.data()));
+    EXPECT_EQ(imf_fixdate_length, format_timestamp(4102444799, date.data()));
+    EXPECT_EQ("Thu, 31 Dec 2099 23:59:59 GMT",
+              std::string(date.data(), date.size()));
+}
+
+TEST(timestamp, format_and_parse)
+{
+    std::array<char_t, imf_fixdate_length> date;
+    for (time_t timestamp = 0; timestamp < 4102444800;
+         timestamp += 86400 * 17 + 3607) {
+        ASSERT_EQ(imf_fixdate_length, format_timestamp(timestamp, date.data()));
+        EXPECT_EQ(timestamp, parse_timestamp(date.data(), date.size()));
+    }
+}
+
 } // namespace hutzn
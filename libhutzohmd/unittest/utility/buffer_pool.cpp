@@ -0,0 +1,131 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "utility/buffer_pool.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+TEST(buffer_pool, borrow_from_empty_pool)
+{
+    buffer_pool pool;
+    const buffer b = pool.borrow(100);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(4096, b.capacity());
+}
+
+TEST(buffer_pool, borrow_beyond_size_classes)
+{
+    buffer_pool pool;
+    const buffer b = pool.borrow(2000000);
+    EXPECT_TRUE(b.empty());
+    EXPECT_LE(2000000, b.capacity());
+}
+
+TEST(buffer_pool, reuse_buffer)
+{
+    buffer_pool pool;
+    buffer b = pool.borrow(5000);
+    EXPECT_EQ(16384, b.capacity());
+    b.push_back('a');
+    const char_t* const data = b.data();
+
+    pool.give_back(std::move(b));
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(1, pool.available(16384));
+
+    const buffer c = pool.borrow(10000);
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(data, c.data());
+    EXPECT_EQ(0, pool.available(16384));
+}
+
+TEST(buffer_pool, give_back_sorts_into_smaller_size_class)
+{
+    buffer_pool pool;
+    buffer b;
+    b.reserve(10000);
+    pool.give_back(std::move(b));
+    EXPECT_EQ(1, pool.available(4096));
+    EXPECT_EQ(0, pool.available(16384));
+}
+
+TEST(buffer_pool, give_back_releases_unfitting_buffers)
+{
+    buffer_pool pool;
+    buffer small;
+    small.reserve(100);
+    pool.give_back(std::move(small));
+
+    buffer large;
+    large.reserve(2000000);
+    pool.give_back(std::move(large));
+
+    EXPECT_EQ(0, pool.available(4096));
+    EXPECT_EQ(0, pool.available(1048576));
+}
+
+TEST(buffer_pool, size_class_is_limited)
+{
+    buffer_pool pool;
+    for (size_t i = 0; i < 100; i++) {
+        buffer b;
+        b.reserve(4096);
+        pool.give_back(std::move(b));
+    }
+    EXPECT_EQ(16, pool.available(4096));
+}
+
+TEST(buffer_pool, header_receive_size_adapts)
+{
+    buffer_pool pool;
+    EXPECT_EQ(4096, pool.header_receive_size());
+
+    for (size_t i = 0; i < 100; i++) {
+        pool.record_header_length(100);
+    }
+    EXPECT_EQ(1024, pool.header_receive_size());
+
+    for (size_t i = 0; i < 100; i++) {
+        pool.record_header_length(10000);
+    }
+    EXPECT_EQ(20480, pool.header_receive_size());
+
+    for (size_t i = 0; i < 100; i++) {
+        pool.record_header_length(1000000);
+    }
+    EXPECT_EQ(65536, pool.header_receive_size());
+}
+
+TEST(buffer_pool, instance_is_per_thread)
+{
+    buffer_pool* other = NULL;
+    std::thread t([&other]() { other = &buffer_pool::instance(); });
+    t.join();
+    EXPECT_NE(other, &buffer_pool::instance());
+    EXPECT_EQ(&buffer_pool::instance(), &buffer_pool::instance());
+}
+
+} // namespace hutzn
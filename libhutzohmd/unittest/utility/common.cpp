@@ -75,6 +75,10 @@ std::vector<check_url_test_param> get_all_check_url_test_params()
     result.push_back(std::make_tuple("foo/bar", false));
     result.push_back(std::make_tuple("/#", false));
     result.push_back(std::make_tuple("/?", false));
+    result.push_back(std::make_tuple("/foo/./bar", false));
+    result.push_back(std::make_tuple("/foo/../bar", false));
+    result.push_back(std::make_tuple("/foo/..", false));
+    result.push_back(std::make_tuple("/.foo/..bar/", true));
     return result;
 }
 
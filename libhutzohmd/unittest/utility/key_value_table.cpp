@@ -0,0 +1,125 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "utility/key_value_table.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+TEST(key_value_table, empty)
+{
+    const key_value_table table{true};
+    EXPECT_EQ(0, table.size());
+    EXPECT_STREQ(NULL, table.find("a"));
+    EXPECT_STREQ(NULL, table.find(NULL));
+}
+
+TEST(key_value_table, hash_step_matches_hash)
+{
+    uint32_t hash = key_value_table::initial_hash();
+    for (const char_t ch : std::string("Content-Type")) {
+        hash = key_value_table::hash_step(hash, ch, false);
+    }
+    EXPECT_EQ(key_value_table::hash("content-type", false), hash);
+    EXPECT_NE(key_value_table::hash("content-type", true),
+              key_value_table::hash("Content-Type", true));
+}
+
+TEST(key_value_table, case_sensitive)
+{
+    key_value_table table{true};
+    table.insert(key_value_table::hash("a", true), "a", "1");
+    table.insert(key_value_table::hash("A", true), "A", "2");
+
+    EXPECT_EQ(2, table.size());
+    EXPECT_STREQ("1", table.find("a"));
+    EXPECT_STREQ("2", table.find("A"));
+}
+
+TEST(key_value_table, case_insensitive)
+{
+    key_value_table table{false};
+    table.insert(key_value_table::hash("Key", false), "Key", "1");
+    table.insert(key_value_table::hash("KEY", false), "KEY", "2");
+
+    EXPECT_EQ(1, table.size());
+    EXPECT_STREQ("2", table.find("key"));
+    EXPECT_STREQ(NULL, table.find("keys"));
+}
+
+TEST(key_value_table, overflow)
+{
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < (key_value_table::inline_capacity * 2); i++) {
+        keys.push_back(std::to_string(i));
+    }
+
+    key_value_table table{true};
+    for (const std::string& key : keys) {
+        table.insert(key_value_table::hash(key.c_str(), true), key.c_str(),
+                     key.c_str());
+    }
+    EXPECT_EQ(keys.size(), table.size());
+
+    // overwriting a value in the overflow area does not add an entry
+    table.insert(key_value_table::hash("40", true), "40", "x");
+    EXPECT_EQ(keys.size(), table.size());
+
+    EXPECT_STREQ("0", table.find("0"));
+    EXPECT_STREQ("31", table.find("31"));
+    EXPECT_STREQ("32", table.find("32"));
+    EXPECT_STREQ("x", table.find("40"));
+    EXPECT_STREQ("63", table.find("63"));
+    EXPECT_STREQ(NULL, table.find("64"));
+}
+
+TEST(key_value_table, clear)
+{
+    key_value_table table{true};
+    for (size_t i = 0; i <= key_value_table::inline_capacity; i++) {
+        table.insert(key_value_table::hash("a", true), "a", "1");
+        table.insert(static_cast<uint32_t>(i), "b", "2");
+    }
+    table.clear();
+
+    EXPECT_EQ(0, table.size());
+    EXPECT_STREQ(NULL, table.find("a"));
+}
+
+TEST(key_value_table, find_view)
+{
+    key_value_table table{true};
+    const char_t value[] = "value";
+    table.insert(key_value_table::hash("a", true), "a",
+                 std::string_view(value, 3));
+
+    EXPECT_EQ(std::string_view("val"), table.find_view("a"));
+    EXPECT_EQ(value, table.find_view("a").data());
+    EXPECT_EQ(NULL, table.find_view("b").data());
+    EXPECT_EQ(NULL, table.find_view(NULL).data());
+}
+
+} // namespace hutzn
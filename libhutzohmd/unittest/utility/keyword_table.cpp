@@ -0,0 +1,83 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "utility/keyword_table.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+namespace
+{
+
+static constexpr keyword_table<int32_t, 3> table{
+    {{{"ab", 1}, {"abcd", 2}, {"xyz", 3}}}};
+
+} // namespace
+
+TEST(keyword_table, max_length)
+{
+    static_assert(table.max_length() == 4, "max length is calculated");
+    EXPECT_EQ(4, table.max_length());
+}
+
+TEST(keyword_table, find)
+{
+    int32_t value = 0;
+    EXPECT_TRUE(table.find("ab", 2, value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(table.find("ABCD", 4, value));
+    EXPECT_EQ(2, value);
+    EXPECT_TRUE(table.find("xYz", 3, value));
+    EXPECT_EQ(3, value);
+}
+
+TEST(keyword_table, find_requires_exact_match)
+{
+    int32_t value = 0;
+    EXPECT_FALSE(table.find("abc", 3, value));
+    EXPECT_FALSE(table.find("a", 1, value));
+    EXPECT_FALSE(table.find("abcde", 5, value));
+    EXPECT_FALSE(table.find("", 0, value));
+    EXPECT_EQ(0, value);
+}
+
+TEST(keyword_table, find_prefix)
+{
+    int32_t value = 0;
+    EXPECT_EQ(4, table.find_prefix("abcdef", 6, value));
+    EXPECT_EQ(2, value);
+    EXPECT_EQ(2, table.find_prefix("abc", 3, value));
+    EXPECT_EQ(1, value);
+    EXPECT_EQ(3, table.find_prefix("XYZ", 3, value));
+    EXPECT_EQ(3, value);
+}
+
+TEST(keyword_table, find_prefix_without_match)
+{
+    int32_t value = 0;
+    EXPECT_EQ(0, table.find_prefix("xy", 2, value));
+    EXPECT_EQ(0, table.find_prefix("ba", 2, value));
+    EXPECT_EQ(0, value);
+}
+
+} // namespace hutzn
@@ -0,0 +1,90 @@
+/* This file is part of libhutznohmd.
+ * Copyright (C) 2013-2025 Stefan Weiser
+
+ * The libhutznohmd project is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 3.0 of the
+ * License, or (at your option) any later version.
+
+ * The libhutznohmd project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the libhutznohmd project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "utility/request_arena.hpp"
+
+using namespace testing;
+
+namespace hutzn
+{
+
+namespace
+{
+
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations_ = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations_++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+TEST(request_arena, small_allocations_use_inline_buffer)
+{
+    request_arena arena{std::pmr::null_memory_resource()};
+    void* const first = arena.resource()->allocate(100);
+    void* const second = arena.resource()->allocate(100);
+    EXPECT_NE(first, second);
+}
+
+TEST(request_arena, large_allocations_use_upstream)
+{
+    counting_resource upstream;
+    request_arena arena{&upstream};
+    const size_t size = request_arena::inline_size * 2;
+    void* const data = arena.resource()->allocate(size);
+    EXPECT_TRUE(NULL != data);
+    EXPECT_EQ(1, upstream.allocations_);
+}
+
+TEST(request_arena, release_reuses_inline_buffer)
+{
+    counting_resource upstream;
+    request_arena arena{&upstream};
+    void* const first = arena.resource()->allocate(100);
+    void* const data = arena.resource()->allocate(request_arena::inline_size);
+    EXPECT_TRUE(NULL != data);
+    EXPECT_EQ(1, upstream.allocations_);
+
+    arena.release();
+    EXPECT_EQ(first, arena.resource()->allocate(100));
+    EXPECT_EQ(1, upstream.allocations_);
+}
+
+} // namespace hutzn